@@ -32,8 +32,12 @@
 #include "ns3/ipv4-flow-classifier.h"
 #include "ns3/hwmp-protocol.h"
 #include "ns3/arp-l3-protocol.h"
+#include "ns3/arp-cache.h"
 #include "ns3/tcp-l4-protocol.h"
 #include "ns3/hwmp-tcp-interface.h"
+#include "ns3/mesh-link-model.h"
+#include "ns3/simulator-sweep.h"
+#include "ns3/propagation-loss-model.h"
 #include "ns3/tcp-socket-base.h"
 #include "ns3/packet.h"
 
@@ -43,6 +47,7 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <unistd.h>
 
 #include "n_eq_coord.h"
 #include "n_eq_25.h"
@@ -105,6 +110,25 @@ class HbyHAgg_PP_SMPC_Protocol{
         uint32_t m_consumerId;
         int m_connectionType;
         int m_portId;
+        bool m_gridChannel;
+        bool m_cachedLoss;
+        bool m_multiplex;
+        double m_coalesceWindow;
+        double m_rxPowerFloor;
+        bool m_mstPaths;
+        double m_overheadBucket;
+        bool m_adaptiveBeacon;
+        double m_maxBeaconInterval;
+        std::string m_linkModelFile;
+        bool m_abstractMac;
+        Ptr<MeshLinkModel> m_linkModel;
+        std::string m_sweep;
+        uint32_t m_sweepJobs;
+        // Forks the variants of the sweep and gathers their summaries
+        SimulatorSweep m_sweepRuns;
+        std::string m_sweepVariant;
+        SystemWallClockMs m_sweepClock;
+        Ptr<SmpcPacketSink> m_gatewaySink;
         int m_sensor, m_aggregator;
         uint32_t child_count;
 
@@ -126,6 +150,8 @@ class HbyHAgg_PP_SMPC_Protocol{
         Ipv4InterfaceContainer interfaces;
         // MeshHelper. Report is not static methods
         MeshHelper mesh;
+        // MAC address of the mesh point of each IP address
+        std::map<Ipv4Address, Address> m_meshAddresses;
   
     private:
         // Create nodes and setup their mobility
@@ -141,9 +167,26 @@ class HbyHAgg_PP_SMPC_Protocol{
   
         // interface between Hwmp and ArpL3Protocol
         void InstallSecureArp ();
+        // MAC address of the mesh point with this IP address, for the ARP resolve callback
+        Address ResolveMeshAddress (Ipv4Address address);
+        // Install permanent ARP entries between two meters, in both directions
+        void InstallPermanentArp (int a, int b);
 
         void InstallHwmpTcpInterface ();
         void CreateCustId();
+
+        // Run the warm-up once, then each variant of the sweep in a copy of the process
+        // restored from its end. Returns true in the copies, false in the original once
+        // the variants are done
+        bool RunSweep ();
+        // Apply a variant of the sweep, in its copy
+        void ApplyVariant (uint32_t index, const std::string &variant);
+        // Add a suffix to the output files of all the sinks, after the base name if they
+        // start with it, so that a run does not write over the files of another
+        void SetSinkOutputSuffix (const std::string &suffix);
+
+        // Install the HWMP paths along the aggregation tree, in both directions
+        void InstallMstPaths ();
 };
 
 HbyHAgg_PP_SMPC_Protocol::HbyHAgg_PP_SMPC_Protocol () :
@@ -179,8 +222,22 @@ HbyHAgg_PP_SMPC_Protocol::HbyHAgg_PP_SMPC_Protocol () :
     m_peartoActivated (false),
     m_consumerId (15),
     m_connectionType (0),
-    m_portId (8100)
+    m_portId (8100),
+    m_gridChannel (false),
+    m_cachedLoss (false),
+    m_multiplex (false),
+    m_coalesceWindow (0.0),
+    m_rxPowerFloor (-99.0),
+    m_mstPaths (false),
+    m_overheadBucket (0.0),
+    m_adaptiveBeacon (false),
+    m_maxBeaconInterval (4.0),
+    m_abstractMac (false),
+    m_sweepJobs (1)
 {
+    // sysconf returns -1 when the number of processors is unknown
+    long processors = sysconf (_SC_NPROCESSORS_ONLN);
+    m_sweepJobs = processors > 0 ? processors : 1;
 }
 
 void HbyHAgg_PP_SMPC_Protocol::Configure (int argc, char *argv[]){
@@ -221,8 +278,23 @@ void HbyHAgg_PP_SMPC_Protocol::Configure (int argc, char *argv[]){
     cmd.AddValue ("pearto", "PEA RTO Activated ? [false]", m_peartoActivated);
     cmd.AddValue ("connection-type", "Type of connection for connection establishment [0] = created first, 1 = created when data is sent", m_connectionType);
     cmd.AddValue ("port-num", "The port number of the remote host, it can determine the QoS support, 8100 = tcp_default, 9100 = gbr_gamming", m_portId);
+    cmd.AddValue ("grid-channel", "Only deliver frames to the meters in range, using cached losses [false]", m_gridChannel);
+    cmd.AddValue ("cached-loss", "Compute the log-distance loss once per pair of meters [false]", m_cachedLoss);
+    cmd.AddValue ("mux", "One TCP connection per tree edge, the k requests are relayed down the tree [false]", m_multiplex);
+    cmd.AddValue ("coalesce", "Window in which the ready messages of a connection are sent together, seconds, with mux [0]", m_coalesceWindow);
+    cmd.AddValue ("rx-floor", "Receive power below which the grid channel does not deliver frames, dBm [-99]", m_rxPowerFloor);
+    cmd.AddValue ("overhead-bucket", "Bucket of the HWMP path discovery counters added to the rounds of the .sta file, seconds, 0 = off [0]", m_overheadBucket);
+    cmd.AddValue ("adaptive-beacon", "Lengthen the beacon interval while the peer links are stable [false]", m_adaptiveBeacon);
+    cmd.AddValue ("max-beacon", "Longest beacon interval with adaptive-beacon, seconds [4]", m_maxBeaconInterval);
+    cmd.AddValue ("link-model", "File of the mesh link model, written by a full run and read by an abstract-mac run []", m_linkModelFile);
+    cmd.AddValue ("abstract-mac", "Replace the 802.11s mesh by the delays and losses of the link-model file [false]", m_abstractMac);
+    cmd.AddValue ("sweep", "Variants run from the end of the warm-up (init), separated by ';', each a ','-separated list of Config::Set path=value []", m_sweep);
+    cmd.AddValue ("sweep-jobs", "Number of variants of the sweep run at once [number of processors]", m_sweepJobs);
+    cmd.AddValue ("mst-paths", "Install the HWMP paths along the MST at start, PREQ/PREP only repair them [false]", m_mstPaths);
 
     cmd.Parse (argc, argv);
+    if (m_sweepJobs == 0)
+        NS_FATAL_ERROR ("sweep-jobs should be at least 1");
     NS_LOG_DEBUG ("Grid:" << m_xSize << "*" << m_ySize);
     NS_LOG_DEBUG ("Simulation time: " << m_totalTime << " s");
 }
@@ -360,6 +432,17 @@ void HbyHAgg_PP_SMPC_Protocol::CreateNodes (){
     wifiPhy.Set ("RxNoiseFigure", DoubleValue (7.0) );
 
     YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+    if (m_cachedLoss){
+        // same models as the default channel, the meters do not move
+        wifiChannel = YansWifiChannelHelper ();
+        wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+        wifiChannel.AddPropagationLoss ("ns3::CachedPropagationLossModel",
+                                        "Model", PointerValue (CreateObject<LogDistancePropagationLossModel> ()));
+    }
+    if (m_gridChannel){
+        // the meters do not move: skip the receivers far below the energy detection threshold
+        wifiChannel.SetChannelType ("ns3::GridYansWifiChannel", "RxPowerFloor", DoubleValue (m_rxPowerFloor));
+    }
     wifiPhy.SetChannel (wifiChannel.Create ());
 
     // Configure the parameters of the Peer Link
@@ -376,6 +459,7 @@ void HbyHAgg_PP_SMPC_Protocol::CreateNodes (){
     Config::SetDefault ("ns3::dot11s::HwmpProtocol::UnicastDataThreshold",UintegerValue (5));
     Config::SetDefault ("ns3::dot11s::HwmpProtocol::DoFlag", BooleanValue (true));
     Config::SetDefault ("ns3::dot11s::HwmpProtocol::RfFlag", BooleanValue (false));
+    Config::SetDefault ("ns3::dot11s::HwmpProtocol::OverheadBucket", TimeValue (Seconds (m_overheadBucket)));
 
     if (m_arpwait != 1.0) {
         Config::SetDefault ("ns3::ArpCache::WaitReplyTimeout", TimeValue (Seconds (m_arpwait)));
@@ -406,7 +490,10 @@ void HbyHAgg_PP_SMPC_Protocol::CreateNodes (){
     }
     
     mesh.SetStandard (WIFI_PHY_STANDARD_80211g);
-    mesh.SetMacType ("RandomStart", TimeValue (Seconds(m_randomStart)));
+    mesh.SetMacType ("RandomStart", TimeValue (Seconds(m_randomStart)),
+                     "AdaptiveBeaconing", BooleanValue (m_adaptiveBeacon),
+                     "MaxBeaconInterval", TimeValue (Seconds (m_maxBeaconInterval)),
+                     "BeaconGeneration", BooleanValue (!m_abstractMac));
     mesh.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("ErpOfdmRate6Mbps"), "RtsCtsThreshold", UintegerValue (2500));
  
     // Set number of interfaces - default is single-interface mesh point
@@ -415,6 +502,20 @@ void HbyHAgg_PP_SMPC_Protocol::CreateNodes (){
     // Install protocols and return container if MeshPointDevices
     meshDevices = mesh.Install (wifiPhy, nodes);
 
+    // Calibrate the link model on this run, or use it instead of the mesh
+    if (m_abstractMac && m_linkModelFile.empty ()){
+        NS_FATAL_ERROR ("abstract-mac needs the link-model file of a full run");
+    }
+    if (!m_linkModelFile.empty ()){
+        m_linkModel = CreateObject<MeshLinkModel> ();
+        if (m_abstractMac){
+            std::ifstream is (m_linkModelFile.c_str ());
+            m_linkModel->Load (is);
+            m_linkModel->SetAttribute ("Mode", EnumValue (MeshLinkModel::ABSTRACT));
+        }
+        m_linkModel->Install (meshDevices);
+    }
+
     // Setup mobility - static grid topology
     MobilityHelper mobility;
     if (m_gridtopology) {
@@ -488,7 +589,7 @@ void HbyHAgg_PP_SMPC_Protocol::CreateNodes (){
 
 void HbyHAgg_PP_SMPC_Protocol::InstallInternetStack (){
     //Config::SetDefault ("ns3::TcpSocketBase::OutputFilename", StringValue (m_filename));
-    //Config::SetDefault ("ns3::TcpSocketBase::PeaRto", BooleanValue (m_peartoActivated));
+    Config::SetDefault ("ns3::TcpSocketBase::PeaRto", BooleanValue (m_peartoActivated));
 
     InternetStackHelper internetStack;
     internetStack.Install (nodes);
@@ -497,6 +598,71 @@ void HbyHAgg_PP_SMPC_Protocol::InstallInternetStack (){
     interfaces = address.Assign (meshDevices);
 }
 
+void HbyHAgg_PP_SMPC_Protocol::InstallSecureArp (){
+    ArpL3Protocol::Mode mode;
+    switch (m_arpOp){
+    case 2: mode = ArpL3Protocol::CREATION_ONLY; break;
+    case 3: mode = ArpL3Protocol::MAINTENANCE_ONLY; break;
+    case 4: mode = ArpL3Protocol::PREINSTALLED; break;
+    default: mode = ArpL3Protocol::NORMAL; break;
+    }
+
+    // HWMP addresses the mesh points by MAC, their IP addresses come from
+    // the addressing plan: the maintenance mode resolves them without a
+    // broadcast request, HWMP still discovers the path
+    for (uint32_t i = 0; i < nodes.GetN (); i++){
+        m_meshAddresses[interfaces.GetAddress (i)] = meshDevices.Get (i)->GetAddress ();
+        Ptr<ArpL3Protocol> arp = nodes.Get (i)->GetObject<ArpL3Protocol> ();
+        arp->SetAttribute ("Mode", EnumValue (mode));
+        arp->SetResolveCallback (MakeCallback (&HbyHAgg_PP_SMPC_Protocol::ResolveMeshAddress, this));
+    }
+    if (mode != ArpL3Protocol::PREINSTALLED)
+        return;
+
+    // the meters only talk to their neighbours in the aggregation tree, and
+    // to the gateway when it sends the requests itself
+    for (int i = 0; i < m_sensor; i++)
+        InstallPermanentArp (child[i], parent[i]);
+    for (int i = 0; i < m_aggregator; i++)
+        InstallPermanentArp (aggnode[i], parent2[i]);
+    for (uint32_t i = 0; i < nodes.GetN () && !m_multiplex; i++){
+        if ((int) i != m_sink)
+            InstallPermanentArp (i, m_sink);
+    }
+}
+
+Address HbyHAgg_PP_SMPC_Protocol::ResolveMeshAddress (Ipv4Address address){
+    std::map<Ipv4Address, Address>::const_iterator it = m_meshAddresses.find (address);
+    if (it == m_meshAddresses.end ())
+        return Address ();
+    return it->second;
+}
+
+void HbyHAgg_PP_SMPC_Protocol::InstallPermanentArp (int a, int b){
+    int ends[2] = { a, b };
+    for (int j = 0; j < 2; j++){
+        std::pair<Ptr<Ipv4>, uint32_t> local = interfaces.Get (ends[j]);
+        Ptr<ArpCache> cache = local.first->GetObject<Ipv4L3Protocol> ()->GetInterface (local.second)->GetArpCache ();
+        cache->AddPermanent (interfaces.GetAddress (ends[1 - j]), meshDevices.Get (ends[1 - j])->GetAddress ());
+    }
+}
+
+void HbyHAgg_PP_SMPC_Protocol::InstallMstPaths (){
+    // parent of each meter in the aggregation tree, the gateway has none
+    std::map<uint32_t, uint32_t> treeParent;
+    for (int i = 0; i < m_sensor; i++)
+        treeParent[child[i]] = parent[i];
+    for (int i = 0; i < m_aggregator; i++)
+        treeParent[aggnode[i]] = parent2[i];
+
+    // every meter reaches its ancestors (reports, TCP acks) and the
+    // ancestors reach it back (gateway requests, TCP data)
+    if (!Dot11sStack::InstallTreePaths (meshDevices, treeParent, Seconds (m_totalTime + 20))){
+        std::cerr << "Error: the MST has a cycle\n";
+        exit (EXIT_FAILURE);
+    }
+}
+
 void HbyHAgg_PP_SMPC_Protocol::InstallHwmpTcpInterface (){
     for (NetDeviceContainer::Iterator i = meshDevices.Begin (); i != meshDevices.End (); ++i){
         Ptr<MeshPointDevice> mp = (*i)->GetObject<MeshPointDevice> ();
@@ -506,6 +672,11 @@ void HbyHAgg_PP_SMPC_Protocol::InstallHwmpTcpInterface (){
 
         Ptr<ns3::dot11s::HwmpProtocol> hwmp = mp->GetObject<ns3::dot11s::HwmpProtocol> ();
         hwmp->SetReportHwmpTcpInterfaceCallback (MakeCallback (&HwmpTcpInterface::ReceivedPerrInfoFromHwmp, PeekPointer (hti)));
+        hwmp->SetReportPathResolvedCallback (MakeCallback (&HwmpTcpInterface::ReceivedPathResolvedFromHwmp, PeekPointer (hti)));
+
+        Ptr<TcpL4Protocol> tcp = node->GetObject<TcpL4Protocol> ();
+        tcp->SetPathErrorCallback (MakeCallback (&HwmpTcpInterface::CheckHwmpForPerrInfo, PeekPointer (hti)));
+        hti->SetPathRepairedCallback (MakeCallback (&TcpL4Protocol::NotifyPathRepaired, PeekPointer (tcp)));
     }
 }
 
@@ -592,14 +763,23 @@ void HbyHAgg_PP_SMPC_Protocol::InstallApplication (double m_pktInterval, uint32_
     sink.SetAttribute("Child", UintegerValue (child_count));
     sink.SetAttribute("MeterType", UintegerValue(0));
     sink.SetAttribute("LeafMeters", UintegerValue(m_numOfLeafMeters));
+    if (m_multiplex){
+        // the requests start at the same time as the sources of the gateway would
+        sink.SetAttribute ("Multiplex", BooleanValue (true));
+        sink.SetAttribute ("CoalesceWindow", TimeValue (Seconds (m_coalesceWindow)));
+        sink.SetAttribute ("RequestSize", UintegerValue (m_kSize));
+        sink.SetAttribute ("FirstRequestTime", TimeValue (Seconds (m_initstart+m_firstSendingTime-0.1)));
+        sink.SetAttribute ("RequestInterval", TimeValue (Seconds (m_pktInterval)));
+    }
     ApplicationContainer receiver = sink.Install (nodes.Get(m_sink));
+    m_gatewaySink = DynamicCast<SmpcPacketSink> (receiver.Get (0));
     receiver.Start (Seconds (0.1));
     receiver.Stop (Seconds (m_totalTime+20));
     
     std::cout << "IPv4 Address of the gateway: " << interfaces.GetAddress (m_sink) << std::endl;
     
-    // Sources for the gateway 
-    for (i = 0; i < m_ySize*m_xSize-1; i++){
+    // Sources for the gateway, the multiplexed sinks send the requests themselves
+    for (i = 0; i < m_ySize*m_xSize-1 && !m_multiplex; i++){
         m_source = array[i];
         
 	strcpy(onoff,"onoff");
@@ -659,6 +839,8 @@ void HbyHAgg_PP_SMPC_Protocol::InstallApplication (double m_pktInterval, uint32_
         leafSink.SetAttribute ("PacketSize", UintegerValue(m_FxSize));
         leafSink.SetAttribute("MeterType", UintegerValue(2));
         leafSink.SetAttribute("LeafMeters", UintegerValue(m_numOfLeafMeters));
+        leafSink.SetAttribute ("Multiplex", BooleanValue (m_multiplex));
+        leafSink.SetAttribute ("CoalesceWindow", TimeValue (Seconds (m_coalesceWindow)));
         
         receiver = leafSink.Install (nodes.Get(it->first));
         std::cout << "The IPv4 address of leaf meter " << it->first << ": " << 
@@ -689,6 +871,8 @@ void HbyHAgg_PP_SMPC_Protocol::InstallApplication (double m_pktInterval, uint32_
         aggSink.SetAttribute("MeterType", UintegerValue(1));
         aggSink.SetAttribute("Child", UintegerValue (count[i]));
         aggSink.SetAttribute("LeafMeters", UintegerValue(m_numOfLeafMeters));
+        aggSink.SetAttribute ("Multiplex", BooleanValue (m_multiplex));
+        aggSink.SetAttribute ("CoalesceWindow", TimeValue (Seconds (m_coalesceWindow)));
         
         receiver = aggSink.Install (nodes.Get(aggnode[i]));
         std::cout << "The IPv4 address of aggregator meter " << aggnode[i] << ": " << 
@@ -697,18 +881,20 @@ void HbyHAgg_PP_SMPC_Protocol::InstallApplication (double m_pktInterval, uint32_
         receiver.Stop (Seconds (m_totalTime+20));
         
         // sinks for gateway data collection request packets
-        SmpcPacketSinkHelper aggSink2 (m_protocol, Address (InetSocketAddress(
-                                   interfaces.GetAddress(aggnode[i]), 7000)));
+        if (!m_multiplex){
+            SmpcPacketSinkHelper aggSink2 (m_protocol, Address (InetSocketAddress(
+                                       interfaces.GetAddress(aggnode[i]), 7000)));
         
-        aggSink2.SetAttribute ("DefaultRxSize", UintegerValue(m_kSize));
-        aggSink2.SetAttribute("MeterType", UintegerValue(1));
-        aggSink2.SetAttribute("LeafMeters", UintegerValue(m_numOfLeafMeters));
+            aggSink2.SetAttribute ("DefaultRxSize", UintegerValue(m_kSize));
+            aggSink2.SetAttribute("MeterType", UintegerValue(1));
+            aggSink2.SetAttribute("LeafMeters", UintegerValue(m_numOfLeafMeters));
         
-        receiver = aggSink2.Install (nodes.Get(aggnode[i]));
-        std::cout << "The IPv4 address of aggregator meter " << aggnode[i] << ": " << 
-                     interfaces.GetAddress (aggnode[i]) << std::endl;
-        receiver.Start (Seconds (0.1));
-        receiver.Stop (Seconds (m_totalTime+20));
+            receiver = aggSink2.Install (nodes.Get(aggnode[i]));
+            std::cout << "The IPv4 address of aggregator meter " << aggnode[i] << ": " << 
+                         interfaces.GetAddress (aggnode[i]) << std::endl;
+            receiver.Start (Seconds (0.1));
+            receiver.Stop (Seconds (m_totalTime+20));
+        }
         
         Ptr<Node> meshNode = nodes.Get (aggnode[i]);
         Ptr<Ipv4StaticRouting> meshStaticRouting = ipv4RoutingHelper.GetStaticRouting (meshNode->GetObject<Ipv4> ());
@@ -730,6 +916,24 @@ int HbyHAgg_PP_SMPC_Protocol::Run (){
     else
         tmp << "r" << m_xSize;      
     
+    if (m_multiplex)
+        tmp << "-mux";
+    
+    if (m_mstPaths)
+        tmp << "-mst";
+    
+    if (m_peartoActivated)
+        tmp << "-pearto";
+    
+    if (m_arpOp != 1)
+        tmp << "-arp" << m_arpOp;
+    
+    if (m_adaptiveBeacon)
+        tmp << "-ab" << m_maxBeaconInterval;
+    
+    if (m_abstractMac)
+        tmp << "-abs";
+    
     m_filename = tmp.str ();
     
     CreateNodes ();
@@ -752,7 +956,10 @@ int HbyHAgg_PP_SMPC_Protocol::Run (){
     }
     
     InstallInternetStack ();
+    InstallSecureArp ();
     InstallHwmpTcpInterface ();
+    if (m_mstPaths)
+        InstallMstPaths ();
 
     // Create a mesh gateway pointer
     Ptr<Node> meshGateway = nodes.Get (m_sink);
@@ -765,10 +972,30 @@ int HbyHAgg_PP_SMPC_Protocol::Run (){
  
     m_timeStart=clock();
     Simulator::Schedule (Seconds (m_totalTime), &HbyHAgg_PP_SMPC_Protocol::Report, this);
-    Simulator::Stop (Seconds (m_totalTime));
+    if (!m_sweep.empty () && !RunSweep ()){
+        Simulator::Destroy ();
+        return 0;
+    }
+    Simulator::Stop (Seconds (m_totalTime) - Simulator::Now ());
 
     Simulator::Run ();
 
+    if (m_sweepRuns.IsVariant ()){
+        // the summary of the variant, gathered by the original process
+        std::ostringstream summary;
+        summary << m_sweepVariant << " rounds=" << m_gatewaySink->GetCompletedRounds ()
+                << " mean-ct(ms)=" << m_gatewaySink->GetMeanCompletionTime ().GetSeconds () * 1000
+                << " rx(bytes)=" << m_gatewaySink->GetTotalRx ()
+                << " wall-clock(ms)=" << m_sweepClock.End () << std::endl;
+        m_sweepRuns.Report (summary.str ());
+    }
+
+    if (m_linkModel != 0 && !m_abstractMac){
+        std::ofstream os (m_linkModelFile.c_str ());
+        m_linkModel->Save (os);
+    }
+    m_linkModel = 0;
+
     Simulator::Destroy ();
     m_timeEnd=clock();
     m_timeTotal=(m_timeEnd - m_timeStart)/(double) CLOCKS_PER_SEC;
@@ -778,6 +1005,93 @@ int HbyHAgg_PP_SMPC_Protocol::Run (){
     return 0;
 }
 
+bool HbyHAgg_PP_SMPC_Protocol::RunSweep (){
+    if (m_initstart >= m_totalTime)
+        NS_FATAL_ERROR ("The warm-up (init) should end before the simulation time");
+    std::vector<std::string> variants;
+    std::istringstream is (m_sweep);
+    std::string variant;
+    while (std::getline (is, variant, ';'))
+        variants.push_back (variant);
+
+    // The applications are installed but have not sent anything yet
+    m_sweepRuns.RunWarmup (Seconds (m_initstart));
+    std::cout << "Warm-up done at " << m_sweepRuns.GetWarmupTime ().GetSeconds () << "s, "
+              << variants.size () << " variants" << std::endl;
+
+    std::vector<std::string> summaries;
+    uint32_t failed = 0;
+    for (size_t first = 0; first < variants.size (); first += m_sweepJobs){
+        for (size_t v = first; v < std::min<size_t> (variants.size (), first + m_sweepJobs); v++){
+            if (m_sweepRuns.Fork ()){
+                ApplyVariant (v, variants[v]);
+                return true;
+            }
+        }
+        // the summaries of the copies, in variant order
+        failed += m_sweepRuns.Wait (summaries);
+        for (size_t v = first; v < summaries.size (); v++){
+            if (summaries[v].empty ())
+                summaries[v] = "variant=" + variants[v] + " failed\n";
+        }
+    }
+
+    std::ostringstream osf;
+    osf << m_filename << "-sweep.txt";
+    std::ofstream of (osf.str().c_str(), std::ios::out | std::ios::app);
+    for (size_t v = 0; v < summaries.size (); v++){
+        std::cout << "v" << v << " " << summaries[v];
+        of << "v" << v << " " << summaries[v];
+    }
+    of.close ();
+    std::cout << "\n*** Sweep: " << variants.size () - failed << "/" << variants.size () << " variants done\n\n";
+    // the sinks of the original process only ran the warm-up
+    SetSinkOutputSuffix ("-warmup");
+    return false;
+}
+
+void HbyHAgg_PP_SMPC_Protocol::SetSinkOutputSuffix (const std::string &suffix){
+    Config::MatchContainer sinks = Config::LookupMatches ("/NodeList/*/ApplicationList/*/$ns3::SmpcPacketSink");
+    for (Config::MatchContainer::Iterator it = sinks.Begin (); it != sinks.End (); ++it){
+        StringValue fileName;
+        (*it)->GetAttribute ("FileName", fileName);
+        std::string name = fileName.Get ();
+        if (name.compare (0, m_filename.size (), m_filename) == 0)
+            name.insert (m_filename.size (), suffix);
+        else
+            name += suffix;
+        (*it)->SetAttribute ("FileName", StringValue (name));
+    }
+}
+
+void HbyHAgg_PP_SMPC_Protocol::ApplyVariant (uint32_t index, const std::string &variant){
+    m_sweepClock.Start ();
+    m_timeStart = clock ();
+    m_sweepVariant = "variant=" + variant;
+
+    // own output files for each variant
+    std::ostringstream suffix;
+    suffix << "-v" << index;
+    SetSinkOutputSuffix (suffix.str ());
+    m_filename += suffix.str ();
+    if (m_linkModel != 0 && !m_abstractMac)
+        m_linkModelFile += suffix.str ();
+
+    std::istringstream is (variant);
+    std::string assignment;
+    while (std::getline (is, assignment, ',')){
+        size_t equal = assignment.find ('=');
+        size_t slash = assignment.rfind ('/', equal);
+        if (equal == std::string::npos || slash == std::string::npos)
+            NS_FATAL_ERROR ("Expected path/attribute=value in the sweep, got " << assignment);
+        std::string path = assignment.substr (0, equal);
+        if (Config::LookupMatches (path.substr (0, slash)).GetN () == 0)
+            NS_FATAL_ERROR ("No object matches " << path);
+        NS_LOG_INFO ("Variant " << index << ": " << path << " = " << assignment.substr (equal + 1));
+        Config::Set (path, StringValue (assignment.substr (equal + 1)));
+    }
+}
+
 void HbyHAgg_PP_SMPC_Protocol::Report (){
     std::ostringstream osf;
     osf << m_filename << "-stat.txt";
@@ -804,6 +1118,19 @@ void HbyHAgg_PP_SMPC_Protocol::Report (){
         m_totPerrForward += hwmp->ReportPathErrorForward();
         m_totPerrPath += hwmp->ReportPathErrorPath();
         m_totFixRto += m_totnorto;
+
+        // path discovery overhead, split between the rounds which overlap each bucket
+        const std::vector<ns3::dot11s::HwmpProtocol::Overhead> &overhead = hwmp->GetOverhead ();
+        for (size_t b = 0; b < overhead.size (); b++){
+            SmpcPacketSink::RoutingOverhead bucket;
+            bucket.preq = overhead[b].txPreq;
+            bucket.prep = overhead[b].txPrep;
+            bucket.perr = overhead[b].txPerr;
+            bucket.discoveries = overhead[b].discoveries;
+            bucket.discoveryTime = overhead[b].discoveryTime;
+            bucket.drops = overhead[b].queueDrops;
+            m_gatewaySink->AddRoutingOverhead (Seconds (m_overheadBucket * b), Seconds (m_overheadBucket * (b + 1)), bucket);
+        }
     }
     
     osf1.close ();
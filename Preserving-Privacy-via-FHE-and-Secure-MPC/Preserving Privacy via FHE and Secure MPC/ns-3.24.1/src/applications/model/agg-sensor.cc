@@ -445,7 +445,8 @@ void AggSensor::SendPacket ()
 {
   NS_LOG_FUNCTION (this);
   
-  std::vector<uint8_t> data (m_pktSize, 0);
+  // The block is a zero-filled payload, never allocated
+  Ptr<Packet> data = Create<Packet> (m_pktSize);
   
   m_protocol->StartTransmission(m_localClientServiceId,
     m_destinationClientServiceId,
@@ -268,7 +268,8 @@ void Sensor::SendPacket ()
                m_localClientServiceId << " To: " << m_destinationLtpId << " " <<
                m_pktSize << " bytes " << "TXtime: " << Simulator::Now() );
   
-  std::vector<uint8_t> data (m_pktSize, 0);
+  // The block is a zero-filled payload, never allocated
+  Ptr<Packet> data = Create<Packet> (m_pktSize);
   m_protocol->StartTransmission(m_localClientServiceId,
     m_destinationClientServiceId,
     m_destinationLtpId,
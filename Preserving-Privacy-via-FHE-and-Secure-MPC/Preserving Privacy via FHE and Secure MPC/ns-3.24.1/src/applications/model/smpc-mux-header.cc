@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/header.h"
+#include "smpc-mux-header.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SmpcMuxHeader");
+
+NS_OBJECT_ENSURE_REGISTERED (SmpcMuxHeader);
+
+SmpcMuxHeader::SmpcMuxHeader ()
+  : m_stream (0),
+    m_length (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SmpcMuxHeader::SetStreamId (uint8_t stream)
+{
+  NS_LOG_FUNCTION (this << (uint32_t)stream);
+  m_stream = stream;
+}
+
+uint8_t
+SmpcMuxHeader::GetStreamId (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_stream;
+}
+
+void
+SmpcMuxHeader::SetLength (uint32_t length)
+{
+  NS_LOG_FUNCTION (this << length);
+  m_length = length;
+}
+
+uint32_t
+SmpcMuxHeader::GetLength (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_length;
+}
+
+TypeId
+SmpcMuxHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SmpcMuxHeader")
+    .SetParent<Header> ()
+    .SetGroupName("Applications")
+    .AddConstructor<SmpcMuxHeader> ()
+  ;
+  return tid;
+}
+TypeId
+SmpcMuxHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+void
+SmpcMuxHeader::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << "(stream=" << (uint32_t)m_stream << " length=" << m_length << ")";
+}
+uint32_t
+SmpcMuxHeader::GetSerializedSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return 1+4;
+}
+
+void
+SmpcMuxHeader::Serialize (Buffer::Iterator start) const
+{
+  NS_LOG_FUNCTION (this << &start);
+  Buffer::Iterator i = start;
+  i.WriteU8 (m_stream);
+  i.WriteHtonU32 (m_length);
+}
+uint32_t
+SmpcMuxHeader::Deserialize (Buffer::Iterator start)
+{
+  NS_LOG_FUNCTION (this << &start);
+  Buffer::Iterator i = start;
+  m_stream = i.ReadU8 ();
+  m_length = i.ReadNtohU32 ();
+  return GetSerializedSize ();
+}
+
+} // namespace ns3
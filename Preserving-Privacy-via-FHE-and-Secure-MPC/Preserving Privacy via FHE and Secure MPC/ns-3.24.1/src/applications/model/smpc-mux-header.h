@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SMPC_MUX_HEADER_H
+#define SMPC_MUX_HEADER_H
+
+#include "ns3/header.h"
+
+namespace ns3 {
+/**
+ * \ingroup applications
+ *
+ * \brief Frame header of the messages multiplexed by the smart meters on
+ *        the connection of a tree edge
+ *
+ * When SmpcPacketSink runs in multiplexed mode, the messages of all the
+ * rounds and of all the purposes are sent on the single TCP connection
+ * between a meter and its parent. Each message is preceded by this header,
+ * which carries the stream id (the purpose of the message) and the length
+ * of the message which follows, so that the receiver can split the byte
+ * stream back into messages.
+ */
+class SmpcMuxHeader : public Header
+{
+public:
+  /// Purpose of a message
+  enum StreamId
+  {
+    REQUEST = 1,  //!< round start request ("k"), from the gateway down the tree
+    REPORT = 2,   //!< meter report ("F(x)"), from the meters up the tree
+    ACK = 3       //!< acknowledgement of a request by a whole subtree, up the tree
+  };
+
+  SmpcMuxHeader ();
+
+  /**
+   * \param stream the stream id of the message
+   */
+  void SetStreamId (uint8_t stream);
+  /**
+   * \return the stream id of the message
+   */
+  uint8_t GetStreamId (void) const;
+  /**
+   * \param length the length of the message which follows the header
+   */
+  void SetLength (uint32_t length);
+  /**
+   * \return the length of the message which follows the header
+   */
+  uint32_t GetLength (void) const;
+
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint8_t m_stream;  //!< Stream id
+  uint32_t m_length; //!< Length of the message
+};
+
+} // namespace ns3
+
+#endif /* SMPC_MUX_HEADER_H */
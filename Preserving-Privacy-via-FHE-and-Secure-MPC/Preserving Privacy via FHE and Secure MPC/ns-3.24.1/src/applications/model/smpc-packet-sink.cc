@@ -35,9 +35,13 @@
 #include "ns3/uinteger.h"
 #include "ns3/string.h"
 #include "ns3/qos-utils.h"
+#include "ns3/boolean.h"
+#include "smpc-mux-header.h"
+#include "smpc-stream-decoder.h"
 #include "smpc-packet-sink.h"
 
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -101,6 +105,33 @@ SmpcPacketSink::GetTypeId (void)
                     UintegerValue (0),
                     MakeUintegerAccessor (&SmpcPacketSink::m_operationId),
                     MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Multiplex", "Send all the messages on the connection to the parent meter, "
+                   "including the round start requests relayed from the gateway",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SmpcPacketSink::m_multiplex),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RequestSize", "The size of the round start requests sent by the gateway (multiplexed mode)",
+                   UintegerValue (66),
+                   MakeUintegerAccessor (&SmpcPacketSink::m_requestSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FirstRequestTime", "The time of the first round start request, after the start of the gateway (multiplexed mode)",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&SmpcPacketSink::m_firstRequestTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("RequestInterval", "The interval between the round start requests (multiplexed mode)",
+                   TimeValue (Seconds (60)),
+                   MakeTimeAccessor (&SmpcPacketSink::m_requestInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("CoalesceWindow", "The messages which are ready to be sent on a connection within this "
+                   "time are sent together, 0 to send them at once (multiplexed mode)",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&SmpcPacketSink::m_coalesceWindow),
+                   MakeTimeChecker ())
+    .AddAttribute ("RequestTimeout", "The gateway sends a request again to the children which did not "
+                   "acknowledge it after this time, 0 to disable (multiplexed mode)",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&SmpcPacketSink::m_requestTimeout),
+                   MakeTimeChecker ())
     .AddTraceSource ("Rx", "A packet has been received",
                      MakeTraceSourceAccessor (&SmpcPacketSink::m_rxTrace),
                      "ns3::Packet::TracedCallback")
@@ -124,6 +155,11 @@ SmpcPacketSink::SmpcPacketSink ()
   m_meterType = 0;
   m_mode = 0;
   m_childNum = 0;
+  m_multiplex = false;
+  m_requestSize = 66;
+  m_requestSeqnum = 0;
+  m_sentMessages = 0;
+  m_sentSegments = 0;
 }
 
 SmpcPacketSink::~SmpcPacketSink()
@@ -158,6 +194,9 @@ void SmpcPacketSink::DoDispose (void)
   m_socket = 0;
   m_targetSocket = 0;
   m_socketList.clear ();
+  m_muxConnections.clear ();
+  m_decoders.clear ();
+  m_pendingAcks.clear ();
 
   // chain up
   Application::DoDispose ();
@@ -178,7 +217,10 @@ void SmpcPacketSink::StartApplication ()    // Called at time specified by Start
           NS_LOG_INFO("Local-SMPCPacketSink::StartApplication: ns3::TcpSocketFactory");
           m_socket->Listen ();
           
-          m_socket->ShutdownSend ();
+          if (!m_multiplex){
+              // the accepted sockets inherit the shutdown
+              m_socket->ShutdownSend ();
+          }
           
           m_socket->SetAcceptCallback (
             MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
@@ -222,7 +264,14 @@ void SmpcPacketSink::StartApplication ()    // Called at time specified by Start
             }
             
             m_targetSocket->SetAllowBroadcast (true);
-            m_targetSocket->ShutdownRecv ();
+            if (m_multiplex){
+                // the requests of the gateway come down on the same connection
+                m_targetSocket->SetRecvCallback (MakeCallback (&SmpcPacketSink::HandleRead, this));
+                m_muxConnections[m_targetSocket].peer = m_target;
+            }
+            else{
+                m_targetSocket->ShutdownRecv ();
+            }
 
             m_targetSocket->SetConnectCallback (
                 MakeCallback (&SmpcPacketSink::ConnectionSucceeded, this),
@@ -239,12 +288,21 @@ void SmpcPacketSink::StartApplication ()    // Called at time specified by Start
         NS_LOG_INFO("Connection Establishment First");
       }
   }
-  
+
+  if (m_multiplex && m_meterType == (uint32_t)0){
+      m_requestEvent = Simulator::Schedule (m_firstRequestTime, &SmpcPacketSink::SendRequest, this);
+  }
 }
 
 void SmpcPacketSink::StopApplication ()     // Called at time specified by Stop
 {
   NS_LOG_FUNCTION (this);
+  for (MuxConnectionMap::iterator it = m_muxConnections.begin (); it != m_muxConnections.end (); ++it)
+    {
+      FlushMux (it->first);
+      // the FINs are not messages
+      it->first->TraceDisconnectWithoutContext ("HighestSequence", MakeCallback (&SmpcPacketSink::SegmentSent, this));
+    }
   while(!m_socketList.empty ()) //these are accepted sockets, close them
     {
       Ptr<Socket> acceptedSocket = m_socketList.front ();
@@ -279,11 +337,18 @@ void SmpcPacketSink::CancelEvents ()
       Time delta (Simulator::Now () - m_lastStartTime);
     }
   Simulator::Cancel (m_sendEvent);
+  Simulator::Cancel (m_requestEvent);
+  Simulator::Cancel (m_retryEvent);
 }
 
 void SmpcPacketSink::HandleRead (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
+  if (m_multiplex)
+    {
+      HandleMuxRead (socket);
+      return;
+    }
   Ptr<Packet> packet;
   Address from;
   while ((packet = socket->RecvFrom (from)))
@@ -295,83 +360,23 @@ void SmpcPacketSink::HandleRead (Ptr<Socket> socket)
  //     InetSocketAddress iaddr = InetSocketAddress::ConvertFrom (from);
  //      NS_LOG_INFO("From : " << from << " Socket : " << iaddr.GetIpv4 () << " port: " << iaddr.GetPort () );
 
-      uint16_t m_pktsize = packet->GetSize();
       m_totalRx += packet->GetSize ();
       m_rxTrace (packet, from);
-      // check whether there is a previous save packet first
-      Ptr<Packet> m_prevPacket = packet;
-      
-//==============================================================================      
-//      if(packet->GetSize () == 80)
-//        HandleReport(m_prevPacket,from);
-//==============================================================================
-      
-      uint16_t m_savePktSize = 0;
-      if (IsThereAnyPreviousStoredPacket(from)) {
-         for(std::vector<DataWaitingPacket>::iterator it = m_waitingPacket.begin(); it != m_waitingPacket.end(); ++it) {
-	    if(it->from == from) {
-	          m_prevPacket = it->pkt;
-	          m_savePktSize = m_prevPacket->GetSize();
-	          break;
-	    }
-         }   
-      }
-      if (m_savePktSize > 0) {  // there is a previously saved packet, m_prevPacket is concatenation of previous and received
-         // concatenate 
-         NS_LOG_INFO("Concatenate previous stored packet and the received packet " << m_savePktSize << " " << m_pktsize );
-         m_prevPacket->AddAtEnd (packet);
-         m_pktsize = m_prevPacket->GetSize ();    // new pkt size from concatenation
-         // delete the old record
-         NS_LOG_INFO("Delete previous stored packet ! " << from << " " << m_savePktSize);
-         if (m_waitingPacket.size() > 1) {
-            std::vector<DataWaitingPacket> tmp (m_waitingPacket); // copy to temp
-            m_waitingPacket.clear();
-            
-            for(std::vector<DataWaitingPacket>::iterator itw = tmp.begin() ; itw != tmp.end(); ++itw) {
-	        if(itw->from != from) { // keep maintain in the waiting list
-	            DataWaitingPacket keep;
-	            keep.from = itw->from;
-	            keep.pkt   = itw->pkt;
-	            m_waitingPacket.push_back(keep);
-	            NS_LOG_INFO("Keep waiting packet " << keep.from << " " << keep.pkt->GetSize() << " " << m_waitingPacket.size () );
-	        }
-             }
-         } else m_waitingPacket.clear();
-      } else m_prevPacket = packet; // there were saved packets, but none was from this address
-      
-      if (m_pktsize == m_defSize) {
-          HandleReport(m_prevPacket,from);
-      } else {
-        // two cases, > and <, if higher, split them
-      	if (m_pktsize > m_defSize) {
-      	    uint16_t m_begin = 0;
-      	    uint16_t m_length = m_defSize;
-      	    while (m_pktsize >= m_defSize) {
-      	        NS_LOG_INFO("Split packet : " << m_pktsize << " from : " << m_begin << " length " << m_length);
-      	        Ptr<Packet> frag = m_prevPacket->CreateFragment(m_begin, m_length);
-      	        HandleReport(frag, from);
-      	        m_begin += (m_length);
-      	        m_pktsize -= m_defSize;
-      	        if (m_pktsize >= m_defSize) m_length = m_defSize;
-      	        else {
-      	          m_length = m_pktsize;
-      	        }
-      	    }
-      	    if (m_pktsize > 0) {
-               DataWaitingPacket tmp;
-               tmp.from = from;
-               tmp.pkt  = m_prevPacket->CreateFragment(m_begin, m_length);
-               m_waitingPacket.push_back(tmp);
-	       NS_LOG_INFO("add the rest of the packet in the waiting packet " << tmp.from << " " << tmp.pkt->GetSize() << " " << m_waitingPacket.size () );               
-      	    }
-      	} else {
-           DataWaitingPacket tmp;
-           tmp.from = from;
-           tmp.pkt  = m_prevPacket;
-           m_waitingPacket.push_back(tmp);
-           NS_LOG_INFO("add waiting packet " << tmp.from << " " << tmp.pkt->GetSize() << " " << m_waitingPacket.size () );               
-      	} // end of else m_pktsize > m_defSize
-      } // end else m_pktsize == m_defSize	  
+
+      // the reports of a sender have m_defSize bytes, split the stream back into reports
+      DecoderMap::iterator decoder = m_decoders.find (from);
+      if (decoder == m_decoders.end ())
+        {
+          decoder = m_decoders.insert (std::make_pair (from, SmpcStreamDecoder (m_defSize))).first;
+        }
+      decoder->second.Feed (packet);
+      uint8_t stream;
+      Ptr<Packet> report;
+      while ((report = decoder->second.Next (stream)))
+        {
+          HandleReport (report, from);
+        }
+      NS_LOG_LOGIC ("Keep " << decoder->second.GetBufferedBytes () << " bytes of " << from << " for the next report");
     } // end while
 }
 
@@ -521,7 +526,14 @@ void SmpcPacketSink::SendPacket ()
   packet->AddHeader (seqTs);
   
   m_txTrace (packet);
-  m_targetSocket->Send (packet);
+  if (m_multiplex)
+    {
+      SendMux (m_targetSocket, SmpcMuxHeader::REPORT, packet);
+    }
+  else
+    {
+      m_targetSocket->Send (packet);
+    }
   m_totBytes += m_pktSize;
   if (InetSocketAddress::IsMatchingType (m_target))
     {
@@ -550,23 +562,29 @@ void SmpcPacketSink::ConnectionSucceeded (Ptr<Socket> socket)
   NS_LOG_FUNCTION (this << socket);
   NS_LOG_INFO("Connection Succeed");
   m_connected = true;
+  if (m_multiplex)
+    {
+      CountSegments (socket);
+    }
 }
 
-void SmpcPacketSink::ConnectionFailed (Ptr<Socket> socket)
+void SmpcPacketSink::CountSegments (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
-  NS_LOG_INFO("Connection Failed");
+  // the highest sequence number sent moves once per segment with new data
+  socket->TraceConnectWithoutContext ("HighestSequence", MakeCallback (&SmpcPacketSink::SegmentSent, this));
 }
 
-bool SmpcPacketSink::IsThereAnyPreviousStoredPacket(Address from) {
-    bool lfoundPacket = false;
-    for(std::vector<DataWaitingPacket>::iterator it = m_waitingPacket.begin(); it != m_waitingPacket.end(); ++it) {
-       if(it->from == from) {
-          lfoundPacket=true;
-          break;
-       }
-    }     
-    return lfoundPacket;
+void SmpcPacketSink::SegmentSent (SequenceNumber32 oldValue, SequenceNumber32 newValue)
+{
+  NS_LOG_FUNCTION (this << oldValue << newValue);
+  m_sentSegments++;
+}
+
+void SmpcPacketSink::ConnectionFailed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  NS_LOG_INFO("Connection Failed");
 }
 
 void SmpcPacketSink::StatPrint () 
@@ -606,7 +624,14 @@ void SmpcPacketSink::StatPrint ()
       counter++;
       NS_LOG_INFO (it->round << " " << it->rxCount << " " << it->rxBytes << " " << it->totDelay << " " << 
             it->firstRxTime << " " << it->lastRxTime << " " << it->minTxTime << " " << ct);
-      osf << it->round << " " << it->rxCount << " " << it->rxBytes << " " << it->totDelay << " " << it->firstRxTime << " " << it->lastRxTime << " " << it->minTxTime << " " << ct << std::endl;
+      osf << it->round << " " << it->rxCount << " " << it->rxBytes << " " << it->totDelay << " " << it->firstRxTime << " " << it->lastRxTime << " " << it->minTxTime << " " << ct;
+      if (!m_routingOverhead.empty ()){
+          // routing overhead between the first report sent and the last one received in the round
+          RoutingOverhead round = GetRoutingOverhead (it->minTxTime, it->lastRxTime);
+          osf << " " << round.preq << " " << round.prep << " " << round.perr << " " << round.discoveries
+              << " " << round.discoveryTime.ToInteger (Time::US) << " " << round.drops;
+      }
+      osf << std::endl;
       
    }
    osf.close();
@@ -632,6 +657,80 @@ void SmpcPacketSink::StatPrint ()
    std::ofstream osf1 (os1.str().c_str(), std::ios::out | std::ios::app);
    osf1 << totrxCount << " " << maxCount*counter << " " << totrxBytes << " " << maxLastRx << " " << minfirstRx << " " << delta << " " << toteteDelay << " " << totCT << " PDR " << pdr << " TP " << tp << " ETE Delay " << ete << " seconds " << " CT " << avgCT << std::endl ;
    osf1.close();
+
+   if (m_multiplex){
+       // messages and TCP segments sent, to compare the runs with and without a CoalesceWindow
+       NS_LOG_INFO ("Sent " << m_sentMessages << " messages in " << m_sentSegments << " segments");
+       std::ostringstream os3;
+       os3 << m_outputFilename+".coa";
+       std::ofstream osf3 (os3.str().c_str(), std::ios::out | std::ios::app);
+       osf3 << m_meterType << " " << m_coalesceWindow.GetSeconds () << " " << m_sentMessages << " " << m_sentSegments << std::endl;
+       osf3.close();
+   }
+
+   if (!m_requestStat.empty ()){
+       // round start latency of the multiplexed mode: request sent, acknowledged by all the meters
+       std::ostringstream os2;
+       os2 << m_outputFilename+".req";
+       std::ofstream osf2 (os2.str().c_str(), std::ios::out | std::ios::app);
+       for(std::vector<RequestRecord>::iterator it = m_requestStat.begin(); it != m_requestStat.end(); ++it) {
+          osf2 << it->seq << " " << it->requestTime << " " << it->ackTime << " "
+               << (it->ackTime - it->requestTime).ToInteger (Time::US) << std::endl;
+       }
+       osf2.close();
+   }
+}
+
+SmpcPacketSink::RoutingOverhead::RoutingOverhead ()
+  : preq (0),
+    prep (0),
+    perr (0),
+    discoveries (0),
+    discoveryTime (Seconds (0)),
+    drops (0)
+{
+}
+
+void SmpcPacketSink::AddRoutingOverhead (Time start, Time end, const RoutingOverhead &overhead)
+{
+  NS_LOG_FUNCTION (this << start << end);
+  NS_ASSERT (start <= end);
+  RoutingOverheadRecord record;
+  record.start = start;
+  record.end = end;
+  record.overhead = overhead;
+  m_routingOverhead.push_back (record);
+}
+
+SmpcPacketSink::RoutingOverhead
+SmpcPacketSink::GetRoutingOverhead (Time begin, Time end) const
+{
+  RoutingOverhead round;
+  for (RoutingOverheadList::const_iterator o = m_routingOverhead.begin (); o != m_routingOverhead.end (); ++o)
+    {
+      double share;
+      if (o->start == o->end)
+        {
+          // an instant belongs to the round when it is within its bounds
+          share = (o->start >= begin && o->start <= end) ? 1.0 : 0.0;
+        }
+      else
+        {
+          Time overlap = std::min (o->end, end) - std::max (o->start, begin);
+          if (!overlap.IsStrictlyPositive ())
+            {
+              continue;
+            }
+          share = overlap.GetSeconds () / (o->end - o->start).GetSeconds ();
+        }
+      round.preq += share * o->overhead.preq;
+      round.prep += share * o->overhead.prep;
+      round.perr += share * o->overhead.perr;
+      round.discoveries += share * o->overhead.discoveries;
+      round.discoveryTime += Seconds (share * o->overhead.discoveryTime.GetSeconds ());
+      round.drops += share * o->overhead.drops;
+    }
+  return round;
 }
 
 void SmpcPacketSink::ReportStat (std::ostream & os)  
@@ -694,6 +793,307 @@ void SmpcPacketSink::HandleAccept (Ptr<Socket> s, const Address& from)
   NS_LOG_FUNCTION (this << s << from);
   s->SetRecvCallback (MakeCallback (&SmpcPacketSink::HandleRead, this));
   m_socketList.push_back (s);
+  if (m_multiplex)
+    {
+      m_muxConnections[s].peer = from;
+      CountSegments (s);
+      // the child connected after the requests in progress were relayed
+      for (PendingAckMap::iterator it = m_pendingAcks.begin (); it != m_pendingAcks.end (); ++it)
+        {
+          NS_LOG_INFO ("Meter " << GetNode ()->GetId () << " sends the request " << it->first
+                       << " to a child which connected late");
+          it->second.waiting.insert (s);
+          SendMux (s, SmpcMuxHeader::REQUEST, it->second.request);
+        }
+    }
+}
+
+void SmpcPacketSink::HandleMuxRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  MuxConnection &connection = m_muxConnections[socket];
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      if (packet->GetSize () == 0)
+        { //EOF
+          break;
+        }
+      m_totalRx += packet->GetSize ();
+      m_rxTrace (packet, connection.peer);
+      connection.decoder.Feed (packet);
+    }
+
+  uint8_t stream;
+  Ptr<Packet> message;
+  while ((message = connection.decoder.Next (stream)))
+    {
+      HandleMuxMessage (socket, stream, message);
+    }
+}
+
+void SmpcPacketSink::HandleMuxMessage (Ptr<Socket> socket, uint8_t stream, Ptr<Packet> message)
+{
+  NS_LOG_FUNCTION (this << socket << (uint32_t)stream << message);
+  if (stream == SmpcMuxHeader::REQUEST)
+    {
+      HandleRequest (message);
+    }
+  else if (stream == SmpcMuxHeader::REPORT)
+    {
+      HandleReport (message, m_muxConnections[socket].peer);
+    }
+  else if (stream == SmpcMuxHeader::ACK)
+    {
+      HandleAck (socket, message);
+    }
+  else
+    {
+      NS_LOG_WARN ("Unknown stream id " << (uint32_t)stream);
+    }
+}
+
+void SmpcPacketSink::HandleRequest (Ptr<Packet> message)
+{
+  NS_LOG_FUNCTION (this << message);
+  SeqTsHeader seqTs;
+  message->PeekHeader (seqTs);
+  uint32_t seq = seqTs.GetSeq ();
+  if (m_meterType == (uint32_t)1)
+    {
+      PendingAckMap::iterator pending = m_pendingAcks.find (seq);
+      if (pending != m_pendingAcks.end ())
+        {
+          // the parent did not get our ack in time, retry the children which did not answer
+          NS_LOG_INFO ("Aggregator " << GetNode ()->GetId () << " relays the request " << seq
+                       << " again to " << pending->second.waiting.size () << " children");
+          for (std::set<Ptr<Socket> >::iterator it = pending->second.waiting.begin (); it != pending->second.waiting.end (); ++it)
+            {
+              SendMux (*it, SmpcMuxHeader::REQUEST, message);
+            }
+          return;
+        }
+      if (seq < m_requestSeqnum)
+        {
+          // the whole subtree has already acknowledged this request
+          SendAck (seq);
+          return;
+        }
+      m_requestSeqnum = seq + 1;
+      if (m_childNum == 0 && m_socketList.empty ())
+        {
+          SendAck (seq);
+          return;
+        }
+      NS_LOG_INFO ("Aggregator " << GetNode ()->GetId () << " relays the request " << seq
+                   << " to " << m_socketList.size () << " of its " << m_childNum << " children");
+      RelayRequest (seq, message);
+    }
+  else if (m_meterType == (uint32_t)2)
+    {
+      if (seq >= m_requestSeqnum)
+        {
+          m_requestSeqnum = seq + 1;
+          NS_LOG_INFO ("Leaf " << GetNode ()->GetId () << " has received the request " << seq);
+          NS_LOG_INFO ("A send operation is scheduled after " << m_procDelay << " nanoseconds.");
+          m_sendEvent = Simulator::Schedule (NanoSeconds (m_procDelay), &SmpcPacketSink::SendPacket, this);
+        }
+      SendAck (seq);
+    }
+}
+
+void SmpcPacketSink::HandleAck (Ptr<Socket> socket, Ptr<Packet> message)
+{
+  NS_LOG_FUNCTION (this << socket << message);
+  SeqTsHeader seqTs;
+  message->PeekHeader (seqTs);
+  uint32_t seq = seqTs.GetSeq ();
+  PendingAckMap::iterator pending = m_pendingAcks.find (seq);
+  if (pending == m_pendingAcks.end ())
+    {
+      NS_LOG_LOGIC ("Duplicate ack of the request " << seq);
+      return;
+    }
+  if (pending->second.waiting.erase (socket) == 0)
+    {
+      NS_LOG_LOGIC ("Duplicate ack of the request " << seq);
+      return;
+    }
+  pending->second.acked++;
+  // the children which did not connect yet have not received the request
+  if (!pending->second.waiting.empty ()
+      || pending->second.acked < std::max<uint32_t> (m_childNum, m_socketList.size ()))
+    {
+      return;
+    }
+  if (m_meterType == (uint32_t)0)
+    {
+      RequestRecord record;
+      record.seq = seq;
+      record.requestTime = pending->second.requestTime;
+      record.ackTime = Simulator::Now ();
+      m_requestStat.push_back (record);
+      NS_LOG_INFO ("All the meters have acknowledged the request " << seq << " after "
+                   << (record.ackTime - record.requestTime).GetSeconds () << " seconds");
+    }
+  else
+    {
+      SendAck (seq);
+    }
+  m_pendingAcks.erase (pending);
+}
+
+void SmpcPacketSink::RelayRequest (uint32_t seq, Ptr<Packet> request)
+{
+  NS_LOG_FUNCTION (this << seq << request);
+  PendingAck &ack = m_pendingAcks[seq];
+  ack.requestTime = Simulator::Now ();
+  ack.request = request;
+  ack.acked = 0;
+  for (std::list<Ptr<Socket> >::iterator it = m_socketList.begin (); it != m_socketList.end (); ++it)
+    {
+      ack.waiting.insert (*it);
+      SendMux (*it, SmpcMuxHeader::REQUEST, request);
+    }
+}
+
+void SmpcPacketSink::SendAck (uint32_t seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  SeqTsHeader seqTs;
+  seqTs.SetSeq (seq);
+  Ptr<Packet> ack = Create<Packet> ();
+  ack->AddHeader (seqTs);
+  SendMux (m_targetSocket, SmpcMuxHeader::ACK, ack);
+}
+
+void SmpcPacketSink::SendMux (Ptr<Socket> socket, uint8_t stream, Ptr<const Packet> message)
+{
+  NS_LOG_FUNCTION (this << socket << (uint32_t)stream << message);
+  SmpcMuxHeader header;
+  header.SetStreamId (stream);
+  header.SetLength (message->GetSize ());
+  Ptr<Packet> frame = message->Copy ();
+  frame->AddHeader (header);
+  m_sentMessages++;
+  if (m_coalesceWindow.IsZero ())
+    {
+      socket->Send (frame);
+      return;
+    }
+
+  // the messages which are ready within the window leave in one segment
+  MuxConnection &connection = m_muxConnections[socket];
+  if (connection.queued == 0)
+    {
+      connection.queued = frame;
+      connection.queuedFrames = 1;
+      connection.flushEvent = Simulator::Schedule (m_coalesceWindow, &SmpcPacketSink::FlushMux, this, socket);
+    }
+  else
+    {
+      connection.queued->AddAtEnd (frame);
+      connection.queuedFrames++;
+    }
+}
+
+void SmpcPacketSink::FlushMux (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  MuxConnection &connection = m_muxConnections[socket];
+  if (connection.queued == 0)
+    {
+      return;
+    }
+  Simulator::Cancel (connection.flushEvent);
+  NS_LOG_LOGIC ("Send " << connection.queuedFrames << " messages in " << connection.queued->GetSize () << " bytes");
+  socket->Send (connection.queued);
+  connection.queued = 0;
+  connection.queuedFrames = 0;
+}
+
+uint32_t SmpcPacketSink::GetSentMessages () const
+{
+  return m_sentMessages;
+}
+
+uint32_t SmpcPacketSink::GetSentSegments () const
+{
+  return m_sentSegments;
+}
+
+uint32_t SmpcPacketSink::GetCompletedRounds () const
+{
+  uint32_t rounds = 0;
+  for (std::vector<StatRecord>::const_iterator it = m_stat.begin (); it != m_stat.end (); ++it)
+    {
+      rounds += it->rxCount == m_childNum;
+    }
+  return rounds;
+}
+
+Time SmpcPacketSink::GetMeanCompletionTime () const
+{
+  Time total = Seconds (0);
+  uint32_t rounds = 0;
+  for (std::vector<StatRecord>::const_iterator it = m_stat.begin (); it != m_stat.end (); ++it)
+    {
+      if (it->rxCount == m_childNum)
+        {
+          total += it->lastRxTime - it->minTxTime;
+          rounds++;
+        }
+    }
+  if (rounds == 0)
+    {
+      return Seconds (0);
+    }
+  return NanoSeconds (total.GetNanoSeconds () / rounds + m_procDelay);
+}
+
+uint32_t SmpcPacketSink::GetAcknowledgedRequests () const
+{
+  return m_requestStat.size ();
+}
+
+void SmpcPacketSink::SendRequest ()
+{
+  NS_LOG_FUNCTION (this);
+  SeqTsHeader seqTs;
+  seqTs.SetSeq (m_requestSeqnum++);
+  uint32_t size = std::max (m_requestSize, seqTs.GetSerializedSize ());
+  Ptr<Packet> request = Create<Packet> (size - seqTs.GetSerializedSize ());
+  request->AddHeader (seqTs);
+  NS_LOG_INFO ("Gateway sends the request " << seqTs.GetSeq () << " to " << m_socketList.size ()
+               << " of its " << m_childNum << " children");
+  RelayRequest (seqTs.GetSeq (), request);
+  if (!m_requestTimeout.IsZero () && !m_retryEvent.IsRunning ())
+    {
+      m_retryEvent = Simulator::Schedule (m_requestTimeout, &SmpcPacketSink::RetryRequests, this);
+    }
+  m_requestEvent = Simulator::Schedule (m_requestInterval, &SmpcPacketSink::SendRequest, this);
+}
+
+void SmpcPacketSink::RetryRequests ()
+{
+  NS_LOG_FUNCTION (this);
+  for (PendingAckMap::iterator it = m_pendingAcks.begin (); it != m_pendingAcks.end (); ++it)
+    {
+      if (Simulator::Now () - it->second.requestTime < m_requestTimeout)
+        {
+          continue;
+        }
+      NS_LOG_INFO ("Gateway sends the request " << it->first << " again to "
+                   << it->second.waiting.size () << " children");
+      for (std::set<Ptr<Socket> >::iterator child = it->second.waiting.begin (); child != it->second.waiting.end (); ++child)
+        {
+          SendMux (*child, SmpcMuxHeader::REQUEST, it->second.request);
+        }
+    }
+  if (!m_pendingAcks.empty ())
+    {
+      m_retryEvent = Simulator::Schedule (m_requestTimeout, &SmpcPacketSink::RetryRequests, this);
+    }
 }
 
 } // Namespace ns3
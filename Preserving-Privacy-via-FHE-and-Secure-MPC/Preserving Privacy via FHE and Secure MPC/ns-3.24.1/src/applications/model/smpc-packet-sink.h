@@ -20,6 +20,11 @@
 #include "ns3/traced-callback.h"
 #include "ns3/address.h"
 #include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/sequence-number.h"
+#include "smpc-stream-decoder.h"
+#include <map>
+#include <set>
 
 namespace ns3 {
 
@@ -84,6 +89,68 @@ public:
    */
   std::list<Ptr<Socket> > GetAcceptedSockets (void) const;
 
+  /**
+   * \return the number of messages sent on the connections of the
+   *         multiplexed mode
+   */
+  uint32_t GetSentMessages () const;
+
+  /**
+   * \return the number of TCP segments carrying new data sent on these
+   *         connections, as counted by TCP, to compare the runs with and
+   *         without a CoalesceWindow
+   */
+  uint32_t GetSentSegments () const;
+
+  /**
+   * \return the number of rounds in which the reports of all the children
+   *         were received
+   */
+  uint32_t GetCompletedRounds () const;
+
+  /**
+   * \return the mean completion time of these rounds, from the first report
+   *         sent to the last one received, with the processing delay, as in
+   *         the .rcp file
+   */
+  Time GetMeanCompletionTime () const;
+
+  /**
+   * \return the number of round start requests acknowledged by all the
+   *         meters (gateway of the multiplexed mode), as in the .req file
+   */
+  uint32_t GetAcknowledgedRequests () const;
+
+  /// Routing overhead of the network, e.g. the path discovery of HWMP
+  struct RoutingOverhead {
+          double preq;          //!< PREQ frames sent
+          double prep;          //!< PREP frames sent
+          double perr;          //!< PERR frames sent
+          double discoveries;   //!< path discoveries which ended
+          Time discoveryTime;   //!< total time of these discoveries
+          double drops;         //!< packets dropped while waiting for a path
+          RoutingOverhead ();
+  };
+
+  /**
+   * Record the routing overhead of an interval of time, e.g. a bucket of
+   * the HWMP counters. The gateway splits it between the rounds which
+   * overlap the interval, in proportion to the overlap, and writes the
+   * share of each round in the .sta file.
+   *
+   * \param start the start of the interval
+   * \param end the end of the interval
+   * \param overhead the overhead during the interval
+   */
+  void AddRoutingOverhead (Time start, Time end, const RoutingOverhead &overhead);
+  /**
+   * \param begin the start of a round
+   * \param end the end of the round
+   * \return the share of the recorded routing overhead which falls in the
+   *         round, the overhead of an interval being spread evenly over it
+   */
+  RoutingOverhead GetRoutingOverhead (Time begin, Time end) const;
+
 protected:
   virtual void DoDispose (void);
 private:
@@ -96,20 +163,99 @@ private:
   void HandlePeerClose (Ptr<Socket>);
   void HandlePeerError (Ptr<Socket>);
   void HandleReport (Ptr<Packet> pkt, Address from);
-  bool IsThereAnyPreviousStoredPacket(Address from);
   void StatPrint ();
   
   void SendPacket ();
   void ConnectionSucceeded (Ptr<Socket> socket);
+
+  /**
+   * Count the TCP segments sent on a connection of the multiplexed mode.
+   *
+   * \param socket the connection
+   */
+  void CountSegments (Ptr<Socket> socket);
+  /**
+   * Invoked when a connection of the multiplexed mode sends a segment with
+   * new data.
+   *
+   * \param oldValue the previous highest sequence number sent
+   * \param newValue the new highest sequence number sent
+   */
+  void SegmentSent (SequenceNumber32 oldValue, SequenceNumber32 newValue);
+
+  /**
+   * Split the bytes received on a connection of the multiplexed mode into
+   * messages.
+   *
+   * \param socket the connected socket
+   */
+  void HandleMuxRead (Ptr<Socket> socket);
+  /**
+   * Handle a message received in the multiplexed mode.
+   *
+   * \param socket the connection the message was received on
+   * \param stream the stream id of the message
+   * \param message the message, without its SmpcMuxHeader
+   */
+  void HandleMuxMessage (Ptr<Socket> socket, uint8_t stream, Ptr<Packet> message);
+  /**
+   * Send a message on a connection of the multiplexed mode.
+   *
+   * \param socket the connected socket
+   * \param stream the stream id of the message
+   * \param message the message
+   */
+  void SendMux (Ptr<Socket> socket, uint8_t stream, Ptr<const Packet> message);
+  /**
+   * Send the messages queued on a connection during the CoalesceWindow.
+   *
+   * \param socket the connected socket
+   */
+  void FlushMux (Ptr<Socket> socket);
+  /**
+   * Send the round start request of the gateway to its children (multiplexed
+   * mode only).
+   */
+  void SendRequest ();
+  /**
+   * Send the requests which were not acknowledged by all the children within
+   * RequestTimeout again, to the children which did not acknowledge them.
+   */
+  void RetryRequests ();
+  /**
+   * Handle a round start request of the multiplexed mode: the aggregators
+   * relay it to their children, the leaves schedule their report. Both
+   * acknowledge it once their whole subtree has received it.
+   *
+   * \param message the request
+   */
+  void HandleRequest (Ptr<Packet> message);
+  /**
+   * Handle the acknowledgement of a request by the subtree of a child.
+   *
+   * \param socket the connection to the child
+   * \param message the acknowledgement
+   */
+  void HandleAck (Ptr<Socket> socket, Ptr<Packet> message);
+  /**
+   * Start waiting for the acknowledgement of a request by the children, and
+   * send it to the children which are already connected. The children which
+   * connect later get it from HandleAccept.
+   *
+   * \param seq the sequence number of the request
+   * \param request the request
+   */
+  void RelayRequest (uint32_t seq, Ptr<Packet> request);
+  /**
+   * Acknowledge a request to the parent meter.
+   *
+   * \param seq the sequence number of the request
+   */
+  void SendAck (uint32_t seq);
   void ConnectionFailed (Ptr<Socket> socket);
   
   void CancelEvents ();
 
-  struct DataWaitingPacket {
-          Address from;
-          Ptr<Packet> pkt;
-  };
-
   struct StatRecord {
 	  uint16_t round;
 	  uint32_t rxCount;
@@ -124,7 +270,8 @@ private:
   // listening socket is stored seperately from the accepted sockets
   Ptr<Socket>     m_socket;       // Listening socket
   std::list<Ptr<Socket> > m_socketList; //the accepted sockets
-  std::vector<DataWaitingPacket> m_waitingPacket;
+  typedef std::map<Address, SmpcStreamDecoder> DecoderMap;
+  DecoderMap      m_decoders;     // Reports received partially, by sender
   std::vector<StatRecord> m_stat;
   
   typedef std::map<uint32_t, uint32_t> MeterSeqNumMap;
@@ -152,6 +299,53 @@ private:
   uint32_t        m_operationId;
   std::string     m_outputFilename;
 
+  /// State of a connection in the multiplexed mode
+  struct MuxConnection {
+          Address peer;        //!< address of the other end
+          SmpcStreamDecoder decoder; //!< bytes received which do not form a full message yet
+          Ptr<Packet> queued;        //!< messages waiting for the end of the CoalesceWindow
+          uint32_t queuedFrames;     //!< number of messages in queued
+          EventId flushEvent;        //!< end of the CoalesceWindow
+  };
+  typedef std::map<Ptr<Socket>, MuxConnection> MuxConnectionMap;
+
+  /// A request which was not acknowledged by all the children yet
+  struct PendingAck {
+          Time requestTime;                 //!< time the request was sent to the children
+          Ptr<Packet> request;              //!< the request, to retry it and to send it to late children
+          std::set<Ptr<Socket> > waiting;   //!< children which did not acknowledge it yet
+          uint32_t acked;                   //!< number of children which acknowledged it
+  };
+  typedef std::map<uint32_t, PendingAck> PendingAckMap;
+
+  struct RequestRecord {
+          uint32_t seq;
+          Time     requestTime;
+          Time     ackTime;
+  };
+
+  bool            m_multiplex;    // One connection per tree edge, carrying all the messages
+  MuxConnectionMap m_muxConnections;
+  uint32_t        m_requestSize;  // Size of the round start requests sent by the gateway
+  Time            m_firstRequestTime; // Time of the first request, after the application start
+  Time            m_requestInterval;  // Interval between the requests
+  uint32_t        m_requestSeqnum;
+  EventId         m_requestEvent; // Eventid of pending "send request" event
+  Time            m_requestTimeout; // Time after which the gateway retries a request
+  EventId         m_retryEvent;   // Eventid of pending "retry requests" event
+  Time            m_coalesceWindow; // Time the messages wait for others to be sent with
+  uint32_t        m_sentMessages; // Messages sent on the multiplexed connections
+  uint32_t        m_sentSegments; // TCP segments with new data sent on them
+  PendingAckMap   m_pendingAcks;  // Requests waiting for the ack of the children, by seqnum
+  std::vector<RequestRecord> m_requestStat; // Requests acknowledged by all the meters (gateway)
+  struct RoutingOverheadRecord {
+          Time start;
+          Time end;
+          RoutingOverhead overhead;
+  };
+  typedef std::vector<RoutingOverheadRecord> RoutingOverheadList;
+  RoutingOverheadList m_routingOverhead; // Routing overhead, by interval of time
+
 };
 
 } // namespace ns3
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "smpc-mux-header.h"
+#include "smpc-stream-decoder.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SmpcStreamDecoder");
+
+SmpcStreamDecoder::SmpcStreamDecoder ()
+  : m_offset (0),
+    m_size (0),
+    m_frameSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SmpcStreamDecoder::SmpcStreamDecoder (uint32_t frameSize)
+  : m_offset (0),
+    m_size (0),
+    m_frameSize (frameSize)
+{
+  NS_LOG_FUNCTION (this << frameSize);
+}
+
+void
+SmpcStreamDecoder::Feed (Ptr<Packet> segment)
+{
+  NS_LOG_FUNCTION (this << segment);
+  if (segment->GetSize () == 0)
+    {
+      return;
+    }
+  m_segments.push_back (segment);
+  m_size += segment->GetSize ();
+}
+
+Ptr<Packet>
+SmpcStreamDecoder::Next (uint8_t &stream)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_frameSize != 0)
+    {
+      if (m_size < m_frameSize)
+        {
+          return 0;
+        }
+      stream = 0;
+      return Extract (m_frameSize, true);
+    }
+
+  SmpcMuxHeader header;
+  if (m_size < header.GetSerializedSize ())
+    {
+      return 0;
+    }
+  Extract (header.GetSerializedSize (), false)->PeekHeader (header);
+  if (m_size < header.GetSerializedSize () + header.GetLength ())
+    {
+      return 0;
+    }
+  Extract (header.GetSerializedSize (), true);
+  stream = header.GetStreamId ();
+  if (header.GetLength () == 0)
+    {
+      return Create<Packet> ();
+    }
+  return Extract (header.GetLength (), true);
+}
+
+uint32_t
+SmpcStreamDecoder::GetBufferedBytes (void) const
+{
+  return m_size;
+}
+
+void
+SmpcStreamDecoder::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_segments.clear ();
+  m_offset = 0;
+  m_size = 0;
+}
+
+Ptr<Packet>
+SmpcStreamDecoder::Extract (uint32_t size, bool consume)
+{
+  NS_LOG_FUNCTION (this << size << consume);
+  NS_ASSERT (size > 0 && size <= m_size);
+  Ptr<Packet> data = 0;
+  uint32_t offset = m_offset;
+  uint32_t left = size;
+  std::deque<Ptr<Packet> >::iterator it = m_segments.begin ();
+  while (left > 0)
+    {
+      NS_ASSERT (it != m_segments.end ());
+      uint32_t length = std::min (left, (*it)->GetSize () - offset);
+      Ptr<Packet> fragment = (*it)->CreateFragment (offset, length);
+      if (data == 0)
+        {
+          data = fragment;
+        }
+      else
+        {
+          data->AddAtEnd (fragment);
+        }
+      left -= length;
+      offset += length;
+      if (offset == (*it)->GetSize ())
+        {
+          offset = 0;
+          it++;
+        }
+    }
+  if (consume)
+    {
+      m_segments.erase (m_segments.begin (), it);
+      m_offset = offset;
+      m_size -= size;
+    }
+  return data;
+}
+
+} // namespace ns3
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SMPC_STREAM_DECODER_H
+#define SMPC_STREAM_DECODER_H
+
+#include <deque>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Split the byte stream of a connection back into messages
+ *
+ * The segments returned by Socket::Recv on a stream socket do not follow
+ * the message boundaries of the sender. The decoder is fed with the
+ * received segments, in order, and returns the messages once they are
+ * complete. Two framings are supported:
+ *
+ *  - length-prefixed: every message is preceded by a SmpcMuxHeader, which
+ *    gives its stream id and its length, so that messages of different
+ *    sizes can share the connection;
+ *  - fixed size: every message has the same size and no header, as sent
+ *    by the meters which do not multiplex their connection.
+ *
+ * The segments are kept in a ring until they have been consumed; a message
+ * which lies in a single segment is returned as a fragment of it, without
+ * copying the payload.
+ */
+class SmpcStreamDecoder
+{
+public:
+  /**
+   * Create a decoder of length-prefixed messages.
+   */
+  SmpcStreamDecoder ();
+  /**
+   * Create a decoder of fixed size messages.
+   *
+   * \param frameSize the size of the messages, 0 for length-prefixed messages
+   */
+  SmpcStreamDecoder (uint32_t frameSize);
+
+  /**
+   * \param segment the next bytes received on the connection
+   */
+  void Feed (Ptr<Packet> segment);
+  /**
+   * \param stream the stream id of the returned message, 0 for fixed size
+   *        messages
+   * \return the next complete message, without its SmpcMuxHeader, or 0 if
+   *         the next message has not been fully received yet
+   */
+  Ptr<Packet> Next (uint8_t &stream);
+  /**
+   * \return the number of bytes received and not returned yet
+   */
+  uint32_t GetBufferedBytes (void) const;
+  /**
+   * Drop the bytes received and not returned yet.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * \param size the number of bytes, at most GetBufferedBytes ()
+   * \param consume whether the bytes are removed from the ring
+   * \return the first bytes of the ring
+   */
+  Ptr<Packet> Extract (uint32_t size, bool consume);
+
+  std::deque<Ptr<Packet> > m_segments; //!< Ring of the received segments
+  uint32_t m_offset;    //!< Bytes of the first segment already returned
+  uint32_t m_size;      //!< Bytes received and not returned yet
+  uint32_t m_frameSize; //!< Size of the fixed size messages, 0 if length-prefixed
+};
+
+} // namespace ns3
+
+#endif /* SMPC_STREAM_DECODER_H */
@@ -81,6 +81,11 @@ VanetPacketSink::GetTypeId (void)
                    UintegerValue (512),
                    MakeUintegerAccessor (&VanetPacketSink::m_defSize),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FrameSize", "The size of the messages received on the TCP connections, "
+                   "0 to handle the received segments as they are",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&VanetPacketSink::m_frameSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("Mode", "The default size of packets received",
                    UintegerValue (1),
                    MakeUintegerAccessor (&VanetPacketSink::m_mode),
@@ -148,6 +153,7 @@ VanetPacketSink::VanetPacketSink ()
   m_lastStartTime = Seconds (0);
   m_meterType = 0;
   m_mode = 0;
+  m_frameSize = 0;
   m_scenario = 1;
   m_childNum = 0;
   m_nNodes = 25;
@@ -169,6 +175,7 @@ VanetPacketSink::VanetPacketSink (uint16_t port, Address local, uint32_t delay)
   m_lastStartTime = Seconds (0);
   m_meterType = 0;
   m_mode = 0;
+  m_frameSize = 0;
   m_scenario = 1;
   m_childNum = 0;
   m_nNodes = 25;
@@ -209,6 +216,7 @@ void VanetPacketSink::DoDispose (void)
   m_targetSocket = 0;
   m_UDPTargetSocket = 0;
   m_socketList.clear ();
+  m_decoders.clear ();
   m_targetSockets.clear();
 
   // chain up
@@ -477,7 +485,27 @@ void VanetPacketSink::HandleReadTCP (Ptr<Socket> socket)
         { //EOF
           break;
       }
+      if (m_frameSize == 0){
+          HandleMessageTCP (socket, packet, from);
+          continue;
+      }
       
+      // forward whole messages rather than the segments of the stream
+      DecoderMap::iterator decoder = m_decoders.find (socket);
+      if (decoder == m_decoders.end ()){
+          decoder = m_decoders.insert (std::make_pair (socket, SmpcStreamDecoder (m_frameSize))).first;
+      }
+      decoder->second.Feed (packet);
+      uint8_t stream;
+      Ptr<Packet> message;
+      while ((message = decoder->second.Next (stream))){
+          HandleMessageTCP (socket, message, from);
+      }
+  }
+}
+
+void VanetPacketSink::HandleMessageTCP (Ptr<Socket> socket, Ptr<Packet> packet, Address from)
+{
       //[0]->GW, [1]->AGG, [2]->LEAF
       
         if(m_meterType == (uint32_t)0){
@@ -521,7 +549,6 @@ void VanetPacketSink::HandleReadTCP (Ptr<Socket> socket)
         else{
             NS_LOG_INFO("We have a problem with meter type!");
         }
-  }
 }
  //     InetSocketAddress iaddr = InetSocketAddress::ConvertFrom (from);
  //      NS_LOG_INFO("From : " << from << " Socket : " << iaddr.GetIpv4 () << " port: " << iaddr.GetPort () );
@@ -14,6 +14,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/address.h"
 #include "ns3/string.h"
+#include "smpc-stream-decoder.h"
 
 #include <map>
 
@@ -92,6 +93,15 @@ private:
 
   void HandleReadUDP (Ptr<Socket>);
   void HandleReadTCP (Ptr<Socket> socket);
+  /**
+   * Handle a message received on a TCP connection: the whole message when
+   * FrameSize is set, a segment of the stream otherwise.
+   *
+   * \param socket the connected socket
+   * \param packet the message
+   * \param from the address of the peer
+   */
+  void HandleMessageTCP (Ptr<Socket> socket, Ptr<Packet> packet, Address from);
   void EchoPacket(Ptr<Packet>);
   void SendToTarget(Ptr<Packet>);
   void SendToTargetSocket(Ptr<Packet> packet, Ptr<Socket> socket);
@@ -173,6 +183,9 @@ private:
   uint32_t        m_DCRLMode;
   std::string     m_outputFilename;
   uint8_t         m_multTargetFlag;
+  uint32_t        m_frameSize;    // Size of the messages received on TCP, 0 to handle the segments
+  typedef std::map<Ptr<Socket>, SmpcStreamDecoder> DecoderMap;
+  DecoderMap      m_decoders;     // Messages received partially, by connection
 
 };
 
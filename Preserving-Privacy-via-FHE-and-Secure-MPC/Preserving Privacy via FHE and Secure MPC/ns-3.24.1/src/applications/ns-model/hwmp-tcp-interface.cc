@@ -34,11 +34,23 @@ HwmpTcpInterface::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::HwmpTcpInterface")
     .SetParent<Object> ()
     .AddConstructor<HwmpTcpInterface> ()
-   
+    .AddAttribute ("MaxRecords",
+                   "The maximum number of PERRs kept, the oldest ones are dropped first. "
+                   "It is used when the first PERR is received.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&HwmpTcpInterface::m_maxRecords),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Retention",
+                   "The time a PERR is kept, 0 to keep it until MaxRecords newer PERRs are received.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&HwmpTcpInterface::m_retention),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
 HwmpTcpInterface::HwmpTcpInterface()
+  : m_head (0),
+    m_count (0)
 {
 //     NS_LOG_FUNCTION (this);
   m_total=0;
@@ -52,32 +64,104 @@ HwmpTcpInterface::~HwmpTcpInterface()
 void
 HwmpTcpInterface::ReceivedPerrInfoFromHwmp(uint32_t count, Time ts)
 {
-   m_timePerrIssued.push_back(ts);  
-   NS_LOG_INFO("Recording Path Error Information " << ts << " " << m_timePerrIssued.size() << " " << count );
+   if (m_maxRecords == 0)
+     {
+       return;
+     }
+   if (m_timePerrIssued.empty ())
+     {
+       m_timePerrIssued.resize (m_maxRecords);
+     }
+   Expire ();
+   uint32_t size = m_timePerrIssued.size ();
+   if (m_count == size)
+     {
+       // the ring is full, overwrite the oldest PERR
+       m_head = (m_head + 1) % size;
+       m_count--;
+     }
+   // the PERRs are reported in time order, keep the ring sorted otherwise
+   uint32_t i = m_count;
+   while (i > 0 && GetPerr (i - 1) > ts)
+     {
+       m_timePerrIssued[(m_head + i) % size] = GetPerr (i - 1);
+       i--;
+     }
+   m_timePerrIssued[(m_head + i) % size] = ts;
+   m_count++;
+   NS_LOG_INFO("Recording Path Error Information " << ts << " " << m_count << " " << count );
 }
-// if found, we do also the deletion of the old history to save make a faster search
 bool
 HwmpTcpInterface::CheckHwmpForPerrInfo(Time beginTs, Time endTs)
 {
-  bool lfoundPathErrorEvent = false;
-  NS_LOG_INFO("Checking between " << beginTs << " and " << endTs << " " << m_timePerrIssued.size() );
-  for (std::vector<Time>::iterator it = m_timePerrIssued.begin() ; it != m_timePerrIssued.end (); ++it)
-  {
-      if ( (*it >= beginTs) && (*it <= endTs) ) {       
-          m_total++;
-          lfoundPathErrorEvent = true;
-          NS_LOG_INFO("Found Path Error, no doubling RTO " << *it << " " << m_total);
-          break;
-      } 
-  }
-  if (!lfoundPathErrorEvent) 
-      m_timePerrIssued.clear();
-  return lfoundPathErrorEvent;
+  Expire ();
+  NS_LOG_INFO("Checking between " << beginTs << " and " << endTs << " " << m_count );
+  // first PERR issued at or after beginTs
+  uint32_t low = 0;
+  uint32_t high = m_count;
+  while (low < high)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (GetPerr (middle) < beginTs)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  if (low < m_count && GetPerr (low) <= endTs)
+    {
+      m_total++;
+      NS_LOG_INFO("Found Path Error, no doubling RTO " << GetPerr (low) << " " << m_total);
+      return true;
+    }
+  return false;
+}
+uint32_t
+HwmpTcpInterface::GetPerrCount () const
+{
+  return m_count;
+}
+Time
+HwmpTcpInterface::GetPerr (uint32_t i) const
+{
+  NS_ASSERT (i < m_count);
+  return m_timePerrIssued[(m_head + i) % m_timePerrIssued.size ()];
+}
+void
+HwmpTcpInterface::Expire ()
+{
+  if (!m_retention.IsStrictlyPositive ())
+    {
+      return;
+    }
+  Time oldest = Simulator::Now () - m_retention;
+  while (m_count > 0 && GetPerr (0) < oldest)
+    {
+      m_head = (m_head + 1) % m_timePerrIssued.size ();
+      m_count--;
+    }
 }
 uint32_t
 HwmpTcpInterface::GetReportRto()
 {
    return m_total;
 }
+void
+HwmpTcpInterface::ReceivedPathResolvedFromHwmp (Mac48Address destination)
+{
+  NS_LOG_INFO ("Path resolved to " << destination);
+  if (!m_pathRepairedCallback.IsNull ())
+    {
+      m_pathRepairedCallback (destination);
+    }
+}
+void
+HwmpTcpInterface::SetPathRepairedCallback (Callback<void, const Address &> cb)
+{
+  m_pathRepairedCallback = cb;
+}
 }
 
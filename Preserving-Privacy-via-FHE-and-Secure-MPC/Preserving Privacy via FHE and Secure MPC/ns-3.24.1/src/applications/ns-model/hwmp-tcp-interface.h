@@ -21,16 +21,29 @@
 #ifndef HWMP_TCP_INTERFACE_H
 #define HWMP_TCP_INTERFACE_H
 
+#include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/callback.h"
+#include "ns3/mac48-address.h"
+#include "ns3/address.h"
 
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 namespace ns3 {
 
+   /**
+    * \brief Tell TCP whether HWMP issued a path error in a window of time
+    *
+    * The times of the PERRs are kept in a ring, in time order, so that a
+    * window is checked with a binary search. The ring holds at most
+    * MaxRecords PERRs, the oldest ones are overwritten, and the PERRs older
+    * than Retention are dropped.
+    */
    class HwmpTcpInterface : public Object
    {
      public:
@@ -40,13 +53,44 @@ namespace ns3 {
   	 virtual ~HwmpTcpInterface();
 
   	 void ReceivedPerrInfoFromHwmp(uint32_t count, Time ts);
+        /**
+         * \param beginTs the start of the window
+         * \param endTs the end of the window
+         * \return true if a PERR was issued in [beginTs, endTs]
+         */
         bool CheckHwmpForPerrInfo(Time beginTs, Time endTs);
         uint32_t GetReportRto();
+        /**
+         * Forward the end of a successful HWMP path discovery to TCP, whose
+         * sockets to the destination retransmit at once if a path error
+         * froze their RTO.
+         *
+         * \param destination the destination of the path
+         */
+        void ReceivedPathResolvedFromHwmp (Mac48Address destination);
+        /**
+         * \param cb the callback notified when a path is repaired, e.g.
+         *        TcpL4Protocol::NotifyPathRepaired
+         */
+        void SetPathRepairedCallback (Callback<void, const Address &> cb);
+        /**
+         * \return the number of PERRs kept
+         */
+        uint32_t GetPerrCount () const;
 
- 	
 	private:
- 	   std::vector<Time> m_timePerrIssued;
+          /// \return the i-th oldest PERR kept
+          Time GetPerr (uint32_t i) const;
+          /// Drop the PERRs older than the retention
+          void Expire ();
+
+ 	   std::vector<Time> m_timePerrIssued; // ring of the PERR times
+          uint32_t m_head;        // index of the oldest PERR in the ring
+          uint32_t m_count;       // number of PERRs in the ring
+          uint32_t m_maxRecords;  // size of the ring
+          Time m_retention;       // age after which a PERR is dropped, 0 to keep it
           uint32_t m_total;
+          Callback<void, const Address &> m_pathRepairedCallback;
    };
 
 } // namespace
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/uinteger.h"
+#include "ns3/hwmp-tcp-interface.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * Test the PERR window queries of the HwmpTcpInterface, with a full ring
+ * and with a retention
+ */
+
+class HwmpTcpInterfaceTestCase : public TestCase
+{
+public:
+  HwmpTcpInterfaceTestCase ();
+  virtual ~HwmpTcpInterfaceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckRetention (Ptr<HwmpTcpInterface> hti);
+
+};
+
+HwmpTcpInterfaceTestCase::HwmpTcpInterfaceTestCase ()
+  : TestCase ("Test the PERR window queries of the HwmpTcpInterface")
+{
+}
+
+HwmpTcpInterfaceTestCase::~HwmpTcpInterfaceTestCase ()
+{
+}
+
+void HwmpTcpInterfaceTestCase::CheckRetention (Ptr<HwmpTcpInterface> hti)
+{
+  // at 10 s with a retention of 3 s, only the PERRs of 7 s and later are kept
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (0), Seconds (6.5)), false, "Check that the old PERRs were dropped");
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (0), Seconds (8)), true, "Check that the recent PERRs were kept");
+  NS_TEST_EXPECT_MSG_EQ (hti->GetPerrCount (), 3, "Check the number of PERRs kept");
+}
+
+void HwmpTcpInterfaceTestCase::DoRun (void)
+{
+  // a ring of 4 PERRs, filled with the PERRs at 1, 2, ... 6 s
+  Ptr<HwmpTcpInterface> hti = CreateObject<HwmpTcpInterface> ();
+  hti->SetAttribute ("MaxRecords", UintegerValue (4));
+  for (uint32_t i = 1; i <= 6; i++)
+    {
+      hti->ReceivedPerrInfoFromHwmp (i, Seconds (i));
+    }
+  NS_TEST_EXPECT_MSG_EQ (hti->GetPerrCount (), 4, "Check that the ring is bounded");
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (0), Seconds (2.5)), false, "Check that the oldest PERRs were overwritten");
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (3), Seconds (3)), true, "Check a window reduced to a PERR time");
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (4.2), Seconds (4.8)), false, "Check a window between two PERRs");
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (5.5), Seconds (10)), true, "Check a window with the newest PERR");
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (6.5), Seconds (10)), false, "Check a window after the newest PERR");
+  // a PERR reported late is kept in time order
+  hti->ReceivedPerrInfoFromHwmp (7, Seconds (4.5));
+  NS_TEST_EXPECT_MSG_EQ (hti->CheckHwmpForPerrInfo (Seconds (4.2), Seconds (4.8)), true, "Check a PERR reported out of order");
+  NS_TEST_EXPECT_MSG_EQ (hti->GetReportRto (), 3, "Check the number of windows with a PERR");
+
+  Ptr<HwmpTcpInterface> retained = CreateObject<HwmpTcpInterface> ();
+  retained->SetAttribute ("Retention", TimeValue (Seconds (3)));
+  for (uint32_t i = 1; i <= 9; i++)
+    {
+      retained->ReceivedPerrInfoFromHwmp (i, Seconds (i));
+    }
+  Simulator::Schedule (Seconds (10), &HwmpTcpInterfaceTestCase::CheckRetention, this, retained);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+
+class HwmpTcpInterfaceTestSuite : public TestSuite
+{
+public:
+  HwmpTcpInterfaceTestSuite ();
+};
+
+HwmpTcpInterfaceTestSuite::HwmpTcpInterfaceTestSuite ()
+  : TestSuite ("hwmp-tcp-interface", UNIT)
+{
+  AddTestCase (new HwmpTcpInterfaceTestCase, TestCase::QUICK);
+}
+
+static HwmpTcpInterfaceTestSuite hwmpTcpInterfaceTestSuite;
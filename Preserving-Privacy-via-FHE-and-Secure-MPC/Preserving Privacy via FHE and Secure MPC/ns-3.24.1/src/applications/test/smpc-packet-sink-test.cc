@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/smpc-packet-sink.h"
+#include "ns3/smpc-packet-sink-helper.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * Test that, in the multiplexed mode, the round start request reaches a
+ * child which connects to its aggregator after the request was relayed,
+ * and that the gateway only gets the acknowledgement of the request once
+ * all the children of the aggregator have acknowledged it.
+ */
+
+class SmpcLateChildTestCase : public TestCase
+{
+public:
+  SmpcLateChildTestCase ();
+  virtual ~SmpcLateChildTestCase ();
+
+private:
+  virtual void DoRun (void);
+  ApplicationContainer InstallSink (Ptr<Node> node, Address local, Address target,
+                                    uint32_t meterType, uint32_t children);
+
+};
+
+SmpcLateChildTestCase::SmpcLateChildTestCase ()
+  : TestCase ("Test that a late child gets the request and delays the ack of its aggregator")
+{
+}
+
+SmpcLateChildTestCase::~SmpcLateChildTestCase ()
+{
+}
+
+ApplicationContainer
+SmpcLateChildTestCase::InstallSink (Ptr<Node> node, Address local, Address target,
+                                    uint32_t meterType, uint32_t children)
+{
+  SmpcPacketSinkHelper sink = (target.GetLength () == 0)
+    ? SmpcPacketSinkHelper ("ns3::TcpSocketFactory", local)
+    : SmpcPacketSinkHelper ("ns3::TcpSocketFactory", local, target, 0);
+  sink.SetAttribute ("FileName", StringValue (CreateTempDirFilename ("smpc-late-child")));
+  sink.SetAttribute ("MeterType", UintegerValue (meterType));
+  sink.SetAttribute ("Child", UintegerValue (children));
+  sink.SetAttribute ("PacketSize", UintegerValue (100));
+  sink.SetAttribute ("DefaultRxSize", UintegerValue (100));
+  sink.SetAttribute ("Multiplex", BooleanValue (true));
+  sink.SetAttribute ("FirstRequestTime", TimeValue (Seconds (0.5)));
+  sink.SetAttribute ("RequestInterval", TimeValue (Seconds (100.0)));
+  return sink.Install (node);
+}
+
+void SmpcLateChildTestCase::DoRun (void)
+{
+  // gateway (0), aggregator (1) and its two leaves (2, 3) on one channel
+  NodeContainer n;
+  n.Create (4);
+  InternetStackHelper internet;
+  internet.Install (n);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer d;
+  for (uint32_t i = 0; i < n.GetN (); i++)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      dev->SetAddress (Mac48Address::Allocate ());
+      n.Get (i)->AddDevice (dev);
+      dev->SetChannel (channel);
+      d.Add (dev);
+    }
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  Address gateway (InetSocketAddress (i.GetAddress (0), 8000));
+  Address aggregator (InetSocketAddress (i.GetAddress (1), 8000));
+  ApplicationContainer gatewayApp = InstallSink (n.Get (0), gateway, Address (), 0, 1);
+  ApplicationContainer aggregatorApp = InstallSink (n.Get (1), aggregator, gateway, 1, 2);
+  ApplicationContainer leafApp = InstallSink (n.Get (2), InetSocketAddress (i.GetAddress (2), 7000), aggregator, 2, 0);
+  ApplicationContainer lateApp = InstallSink (n.Get (3), InetSocketAddress (i.GetAddress (3), 7000), aggregator, 2, 0);
+  gatewayApp.Start (Seconds (0.1));
+  aggregatorApp.Start (Seconds (0.1));
+  leafApp.Start (Seconds (0.1));
+  // the second leaf connects after the request was relayed
+  lateApp.Start (Seconds (2.0));
+  Ptr<SmpcPacketSink> gatewaySink = DynamicCast<SmpcPacketSink> (gatewayApp.Get (0));
+  Ptr<SmpcPacketSink> lateSink = DynamicCast<SmpcPacketSink> (lateApp.Get (0));
+
+  Simulator::Stop (Seconds (1.9));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (gatewaySink->GetAcknowledgedRequests (), 0,
+                         "Check that the request is not acknowledged before the second leaf has it");
+
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_GT (lateSink->GetTotalRx (), 0, "Check that the late leaf has received the request");
+  NS_TEST_EXPECT_MSG_EQ (gatewaySink->GetAcknowledgedRequests (), 1,
+                         "Check that the request is acknowledged once both leaves have it");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Test the count of the messages and of the TCP segments sent by a leaf,
+ * whose report and ack are ready 1 ms apart, with and without a
+ * CoalesceWindow
+ */
+
+class SmpcSegmentCountTestCase : public TestCase
+{
+public:
+  /**
+   * \param window the CoalesceWindow of the meters
+   * \param segments the expected number of segments sent by the leaf
+   */
+  SmpcSegmentCountTestCase (Time window, uint32_t segments);
+  virtual ~SmpcSegmentCountTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  Time m_window;
+  uint32_t m_segments;
+};
+
+SmpcSegmentCountTestCase::SmpcSegmentCountTestCase (Time window, uint32_t segments)
+  : TestCase (window.IsZero () ? "Test the count of the segments sent without a CoalesceWindow"
+              : "Test the count of the segments sent with a CoalesceWindow"),
+    m_window (window),
+    m_segments (segments)
+{
+}
+
+SmpcSegmentCountTestCase::~SmpcSegmentCountTestCase ()
+{
+}
+
+void SmpcSegmentCountTestCase::DoRun (void)
+{
+  // gateway (0) and its leaf (1) on one channel
+  NodeContainer n;
+  n.Create (2);
+  InternetStackHelper internet;
+  internet.Install (n);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer d;
+  for (uint32_t i = 0; i < n.GetN (); i++)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      dev->SetAddress (Mac48Address::Allocate ());
+      n.Get (i)->AddDevice (dev);
+      dev->SetChannel (channel);
+      d.Add (dev);
+    }
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  Address gateway (InetSocketAddress (i.GetAddress (0), 8000));
+  SmpcPacketSinkHelper gatewaySink ("ns3::TcpSocketFactory", gateway);
+  // the leaf acknowledges the request at once and reports 1 ms later
+  SmpcPacketSinkHelper leafSink ("ns3::TcpSocketFactory", InetSocketAddress (i.GetAddress (1), 7000), gateway, 1000000);
+  gatewaySink.SetAttribute ("MeterType", UintegerValue (0));
+  leafSink.SetAttribute ("MeterType", UintegerValue (2));
+  SmpcPacketSinkHelper *sinks[] = { &gatewaySink, &leafSink };
+  for (uint32_t j = 0; j < 2; j++)
+    {
+      sinks[j]->SetAttribute ("FileName", StringValue (CreateTempDirFilename ("smpc-segment-count")));
+      sinks[j]->SetAttribute ("Child", UintegerValue (1));
+      sinks[j]->SetAttribute ("PacketSize", UintegerValue (100));
+      sinks[j]->SetAttribute ("DefaultRxSize", UintegerValue (100));
+      sinks[j]->SetAttribute ("Multiplex", BooleanValue (true));
+      sinks[j]->SetAttribute ("CoalesceWindow", TimeValue (m_window));
+      sinks[j]->SetAttribute ("FirstRequestTime", TimeValue (Seconds (0.5)));
+      sinks[j]->SetAttribute ("RequestInterval", TimeValue (Seconds (100.0)));
+    }
+  ApplicationContainer apps = gatewaySink.Install (n.Get (0));
+  apps.Add (leafSink.Install (n.Get (1)));
+  apps.Start (Seconds (0.1));
+  Ptr<SmpcPacketSink> leaf = DynamicCast<SmpcPacketSink> (apps.Get (1));
+
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (leaf->GetSentMessages (), 2, "Check that the leaf sent its ack and its report");
+  NS_TEST_EXPECT_MSG_EQ (leaf->GetSentSegments (), m_segments, "Check the number of segments sent by the leaf");
+
+  Simulator::Destroy ();
+}
+/**
+ * Test the split of the routing overhead of the buckets of time between the
+ * rounds which overlap them
+ */
+
+class SmpcRoutingOverheadTestCase : public TestCase
+{
+public:
+  SmpcRoutingOverheadTestCase ();
+  virtual ~SmpcRoutingOverheadTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SmpcRoutingOverheadTestCase::SmpcRoutingOverheadTestCase ()
+  : TestCase ("Test the split of the routing overhead between the rounds")
+{
+}
+
+SmpcRoutingOverheadTestCase::~SmpcRoutingOverheadTestCase ()
+{
+}
+
+void SmpcRoutingOverheadTestCase::DoRun (void)
+{
+  Ptr<SmpcPacketSink> sink = CreateObject<SmpcPacketSink> ();
+  SmpcPacketSink::RoutingOverhead first;
+  first.preq = 10;
+  first.discoveryTime = MilliSeconds (100);
+  SmpcPacketSink::RoutingOverhead second;
+  second.preq = 4;
+  second.perr = 2;
+  SmpcPacketSink::RoutingOverhead instant;
+  instant.drops = 1;
+  sink->AddRoutingOverhead (Seconds (0), Seconds (1), first);
+  sink->AddRoutingOverhead (Seconds (1), Seconds (3), second);
+  sink->AddRoutingOverhead (Seconds (2.5), Seconds (2.5), instant);
+
+  // a round which straddles the two buckets gets a share of each
+  SmpcPacketSink::RoutingOverhead round = sink->GetRoutingOverhead (Seconds (0.5), Seconds (2));
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.preq, 7, 1e-9, "Check the PREQs of half of each bucket");
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.perr, 1, 1e-9, "Check the PERRs of half of the second bucket");
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.discoveryTime.GetSeconds (), 0.05, 1e-6, "Check the discovery time of half of the first bucket");
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.drops, 0, 1e-9, "Check that the instant after the round is not counted");
+
+  // a round longer than the buckets gets all of them
+  round = sink->GetRoutingOverhead (Seconds (0), Seconds (3));
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.preq, 14, 1e-9, "Check the PREQs of both buckets");
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.drops, 1, 1e-9, "Check the drop at an instant of the round");
+
+  // a round shorter than a bucket gets its share
+  round = sink->GetRoutingOverhead (Seconds (1.5), Seconds (2));
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.preq, 1, 1e-9, "Check the PREQs of a quarter of the second bucket");
+
+  round = sink->GetRoutingOverhead (Seconds (5), Seconds (6));
+  NS_TEST_EXPECT_MSG_EQ_TOL (round.preq + round.perr + round.drops, 0, 1e-9, "Check that a later round has no overhead");
+}
+
+
+class SmpcPacketSinkTestSuite : public TestSuite
+{
+public:
+  SmpcPacketSinkTestSuite ();
+};
+
+SmpcPacketSinkTestSuite::SmpcPacketSinkTestSuite ()
+  : TestSuite ("smpc-packet-sink", UNIT)
+{
+  AddTestCase (new SmpcLateChildTestCase, TestCase::QUICK);
+  AddTestCase (new SmpcSegmentCountTestCase (Seconds (0), 2), TestCase::QUICK);
+  AddTestCase (new SmpcSegmentCountTestCase (MilliSeconds (5), 1), TestCase::QUICK);
+  AddTestCase (new SmpcRoutingOverheadTestCase, TestCase::QUICK);
+}
+
+static SmpcPacketSinkTestSuite smpcPacketSinkTestSuite;
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <vector>
+#include "ns3/packet.h"
+#include "ns3/smpc-mux-header.h"
+#include "ns3/smpc-stream-decoder.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * Test that the SmpcStreamDecoder splits a byte stream back into messages,
+ * whatever the segmentation of the stream
+ */
+
+class SmpcStreamDecoderTestCase : public TestCase
+{
+public:
+  SmpcStreamDecoderTestCase ();
+  virtual ~SmpcStreamDecoderTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Ptr<Packet> Frame (uint8_t stream, uint32_t size, uint8_t fill);
+
+};
+
+SmpcStreamDecoderTestCase::SmpcStreamDecoderTestCase ()
+  : TestCase ("Test that the SmpcStreamDecoder splits a segmented stream into messages")
+{
+}
+
+SmpcStreamDecoderTestCase::~SmpcStreamDecoderTestCase ()
+{
+}
+
+Ptr<Packet>
+SmpcStreamDecoderTestCase::Frame (uint8_t stream, uint32_t size, uint8_t fill)
+{
+  std::vector<uint8_t> data (size, fill);
+  Ptr<Packet> frame = Create<Packet> (size == 0 ? 0 : &data[0], size);
+  SmpcMuxHeader header;
+  header.SetStreamId (stream);
+  header.SetLength (size);
+  frame->AddHeader (header);
+  return frame;
+}
+
+void SmpcStreamDecoderTestCase::DoRun (void)
+{
+  // three messages of different sizes, received in segments of 5 bytes
+  Ptr<Packet> stream = Frame (SmpcMuxHeader::REQUEST, 2, 0x11);
+  stream->AddAtEnd (Frame (SmpcMuxHeader::REPORT, 80, 0x22));
+  stream->AddAtEnd (Frame (SmpcMuxHeader::ACK, 0, 0));
+  uint32_t total = stream->GetSize ();
+
+  SmpcStreamDecoder decoder;
+  std::vector<Ptr<Packet> > messages;
+  std::vector<uint8_t> streams;
+  uint8_t id;
+  Ptr<Packet> message;
+  for (uint32_t offset = 0; offset < total; offset += 5)
+    {
+      decoder.Feed (stream->CreateFragment (offset, std::min (5u, total - offset)));
+      while ((message = decoder.Next (id)))
+        {
+          messages.push_back (message);
+          streams.push_back (id);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (messages.size (), 3, "Check that the three messages were decoded");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)streams[0], (uint32_t)SmpcMuxHeader::REQUEST, "Check the stream of the request");
+  NS_TEST_EXPECT_MSG_EQ (messages[0]->GetSize (), 2, "Check the size of the request");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)streams[1], (uint32_t)SmpcMuxHeader::REPORT, "Check the stream of the report");
+  NS_TEST_EXPECT_MSG_EQ (messages[1]->GetSize (), 80, "Check the size of the report");
+  uint8_t payload[80];
+  messages[1]->CopyData (payload, 80);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)payload[0], 0x22, "Check the first byte of the report");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)payload[79], 0x22, "Check the last byte of the report");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)streams[2], (uint32_t)SmpcMuxHeader::ACK, "Check the stream of the ack");
+  NS_TEST_EXPECT_MSG_EQ (messages[2]->GetSize (), 0, "Check the size of the ack");
+  NS_TEST_EXPECT_MSG_EQ (decoder.GetBufferedBytes (), 0, "Check that no byte is left");
+
+  // a message larger than 64 KiB followed by a small one, in segments of 1500 bytes
+  stream = Frame (SmpcMuxHeader::REPORT, 70000, 0x33);
+  stream->AddAtEnd (Frame (SmpcMuxHeader::ACK, 8, 0x44));
+  total = stream->GetSize ();
+  messages.clear ();
+  streams.clear ();
+  for (uint32_t offset = 0; offset < total; offset += 1500)
+    {
+      decoder.Feed (stream->CreateFragment (offset, std::min (1500u, total - offset)));
+      while ((message = decoder.Next (id)))
+        {
+          messages.push_back (message);
+          streams.push_back (id);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (messages.size (), 2, "Check that the large message and the next one were decoded");
+  NS_TEST_EXPECT_MSG_EQ (messages[0]->GetSize (), 70000, "Check the size of the large message");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)streams[1], (uint32_t)SmpcMuxHeader::ACK, "Check the stream of the message after the large one");
+  NS_TEST_EXPECT_MSG_EQ (messages[1]->GetSize (), 8, "Check the size of the message after the large one");
+
+  // fixed size messages, received in a single segment with the start of the next one
+  SmpcStreamDecoder fixed (12);
+  fixed.Feed (Create<Packet> (30));
+  uint32_t count = 0;
+  while ((message = fixed.Next (id)))
+    {
+      NS_TEST_EXPECT_MSG_EQ (message->GetSize (), 12, "Check the size of a fixed size message");
+      count++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, 2, "Check that two messages were decoded");
+  NS_TEST_EXPECT_MSG_EQ (fixed.GetBufferedBytes (), 6, "Check that the start of the third message is kept");
+  fixed.Feed (Create<Packet> (6));
+  message = fixed.Next (id);
+  NS_TEST_EXPECT_MSG_NE (message, 0, "Check that the third message was completed");
+}
+
+
+class SmpcStreamDecoderTestSuite : public TestSuite
+{
+public:
+  SmpcStreamDecoderTestSuite ();
+};
+
+SmpcStreamDecoderTestSuite::SmpcStreamDecoderTestSuite ()
+  : TestSuite ("smpc-stream-decoder", UNIT)
+{
+  AddTestCase (new SmpcStreamDecoderTestCase, TestCase::QUICK);
+}
+
+static SmpcStreamDecoderTestSuite smpcStreamDecoderTestSuite;
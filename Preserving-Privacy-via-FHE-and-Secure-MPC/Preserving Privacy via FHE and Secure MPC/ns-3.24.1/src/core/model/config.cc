@@ -27,6 +27,8 @@
 #include "log.h"
 
 #include <sstream>
+#include <limits>
+#include <map>
 
 /**
  * \file
@@ -156,6 +158,9 @@ public:
   /**
    * Construct from a Config path specification.
    *
+   * The specification is parsed once, into the ranges of the indices
+   * it matches.
+   *
    * \param [in] element The Config path specification.
    */
   ArrayMatcher (std::string element);
@@ -166,7 +171,20 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (uint32_t i) const;
+  /**
+   * Test if the Config path specification matches a single index.
+   *
+   * \param [out] i The index.
+   * \returns \c true if the specification is a single index.
+   */
+  bool GetSingleIndex (uint32_t *i) const;
 private:
+  /**
+   * Parse a Config path specification without alternatives.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void AddElement (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -177,6 +195,8 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** The ranges of the indices matched, bounds included. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 };
 
 
@@ -184,68 +204,73 @@ ArrayMatcher::ArrayMatcher (std::string element)
   : m_element (element)
 {
   NS_LOG_FUNCTION (this << element);
-}
-bool
-ArrayMatcher::Matches (uint32_t i) const
-{
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  std::string::size_type start = 0;
+  std::string::size_type tmp;
+  while ((tmp = element.find ("|", start)) != std::string::npos)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      AddElement (element.substr (start, tmp - start));
+      start = tmp + 1;
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  AddElement (element.substr (start));
+}
+void
+ArrayMatcher::AddElement (std::string element)
+{
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      m_ranges.push_back (std::make_pair (0, std::numeric_limits<uint32_t>::max ()));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
-      if (StringToUint32 (lowerBound, &min) && 
+      if (StringToUint32 (lowerBound, &min) &&
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
+          m_ranges.push_back (std::make_pair (min, max));
         }
-      else
+      return;
+    }
+  uint32_t value;
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator range = m_ranges.begin ();
+       range != m_ranges.end (); ++range)
+    {
+      if (i >= range->first && i <= range->second)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
         }
     }
-  uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
+  return false;
+}
+bool
+ArrayMatcher::GetSingleIndex (uint32_t *i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_ranges.size () == 1 && m_ranges[0].first == m_ranges[0].second)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+      *i = m_ranges[0].first;
       return true;
     }
-  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
 }
 
@@ -261,10 +286,16 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 
 /**
  * Abstract class to parse Config paths into object references.
+ *
+ * The paths are split into their elements once, and kept as a tree of
+ * elements: the objects matched by the common start of several paths
+ * are looked up once for all of them.
  */
 class Resolver
 {
 public:
+  /** Construct without any path. */
+  Resolver ();
   /**
    * Construct from a base Config path.
    *
@@ -275,38 +306,90 @@ public:
   virtual ~Resolver ();
 
   /**
-   * Parse the stored Config path into an object reference,
+   * Add a Config path to resolve.
+   *
+   * \param [in] path The Config path.
+   * \returns The index of the path, given to DoOne with its matches.
+   */
+  uint32_t AddPath (std::string path);
+  /**
+   * Parse the stored Config paths into object references,
    * beginning at the indicated root object.
    *
    * \param [in] root The object corresponding to the current position in
    *                  in the Config path.
    */
   void Resolve (Ptr<Object> root);
-  
+
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
+  /** An element of the Config paths, with the elements which follow it. */
+  struct Element
+  {
+    /**
+     * Construct from the element of the Config path.
+     *
+     * \param [in] item The element.
+     */
+    Element (std::string item);
+    /** The element, empty for the root of the paths. */
+    std::string item;
+    /** The element parsed as an index, when it follows an object container. */
+    ArrayMatcher matcher;
+    /** The elements which follow, as indices in m_elements. */
+    std::vector<uint32_t> children;
+    /** The paths which end with this element. */
+    std::vector<uint32_t> paths;
+  };
+
+  /** An attribute through which a Config path goes on. */
+  struct PathAttribute
+  {
+    std::string name;   //!< The name of the attribute
+    bool isPointer;     //!< The attribute holds an object
+    bool isContainer;   //!< The attribute holds a container of objects
+  };
+  /** The attributes which match an element of a path, for a TypeId. */
+  typedef std::vector<PathAttribute> PathAttributes;
+
   /**
-   * Parse the next element in the Config path.
+   * Find the attributes of an object type through which a Config path
+   * goes on. They are looked up once per type and element.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] tid The type of the object.
+   * \param [in] item The element of the Config path.
+   * \returns The attributes of the type and of its parents which hold an
+   *          object or a container of objects, and match the element.
+   */
+  static const PathAttributes & GetPathAttributes (TypeId tid, std::string item);
+  /**
+   * Ensure the Config path starts and ends with a '/'.
+   *
+   * \param [in] path The Config path.
+   * \returns The canonical Config path.
+   */
+  static std::string Canonicalize (std::string path);
+  /**
+   * Parse the elements which follow an element of the Config paths.
+   *
+   * \param [in] element The element reached, in m_elements.
    * \param [in] root The object corresponding to the current positon
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (uint32_t element, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
+   * \param [in] element The element of the object container, in m_elements.
    * \param [in,out] vector The resulting list of matching objects.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (uint32_t element, const ObjectPtrContainerValue &vector);
   /**
-   * Handle one object found on the path.
+   * Handle one object found on the paths.
    *
+   * \param [in] element The last element of the paths, in m_elements.
    * \param [in] object The current object on the Config path.
    */
-  void DoResolveOne (Ptr<Object> object);
+  void DoResolveOne (uint32_t element, Ptr<Object> object);
   /**
    * Get the current Config path.
    *
@@ -318,51 +401,103 @@ private:
    *
    * \param [in] object The found object.
    * \param [in] path The matching Config path context.
+   * \param [in] index The index of the Config path, from AddPath.
    */
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
+  virtual void DoOne (Ptr<Object> object, std::string path, uint32_t index) = 0;
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The elements of the Config paths, the root first. */
+  std::vector<Element> m_elements;
+  /** The number of Config paths. */
+  uint32_t m_nPaths;
 };
 
+Resolver::Element::Element (std::string item)
+  : item (item),
+    matcher (item)
+{
+}
+
+Resolver::Resolver ()
+  : m_nPaths (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_elements.push_back (Element (""));
+}
 Resolver::Resolver (std::string path)
-  : m_path (path)
+  : m_nPaths (0)
 {
   NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  m_elements.push_back (Element (""));
+  AddPath (path);
 }
 Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
 }
-void
-Resolver::Canonicalize (void)
+std::string
+Resolver::Canonicalize (std::string path)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (path);
 
   // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
+  std::string::size_type tmp = path.find ("/");
   if (tmp != 0)
     {
       // no slash at start
-      m_path = "/" + m_path;
+      path = "/" + path;
     }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
     {
       // no slash at end
-      m_path = m_path + "/";
+      path = path + "/";
     }
+  return path;
 }
 
-void 
+uint32_t
+Resolver::AddPath (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  path = Canonicalize (path);
+  uint32_t element = 0;
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", start)) != std::string::npos)
+    {
+      std::string item = path.substr (start, next - start);
+      start = next + 1;
+      uint32_t child = 0;
+      for (std::vector<uint32_t>::const_iterator i = m_elements[element].children.begin ();
+           i != m_elements[element].children.end (); ++i)
+        {
+          if (m_elements[*i].item == item)
+            {
+              child = *i;
+              break;
+            }
+        }
+      if (child == 0)
+        {
+          child = m_elements.size ();
+          m_elements.push_back (Element (item));
+          m_elements[element].children.push_back (child);
+        }
+      element = child;
+    }
+  m_elements[element].paths.push_back (m_nPaths);
+  return m_nPaths++;
+}
+
+void
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -378,130 +513,164 @@ Resolver::GetResolvedPath (void) const
   return fullPath;
 }
 
-void 
-Resolver::DoResolveOne (Ptr<Object> object)
+void
+Resolver::DoResolveOne (uint32_t element, Ptr<Object> object)
 {
-  NS_LOG_FUNCTION (this << object);
+  NS_LOG_FUNCTION (this << element << object);
 
   NS_LOG_DEBUG ("resolved="<<GetResolvedPath ());
-  DoOne (object, GetResolvedPath ());
+  std::string path = GetResolvedPath ();
+  for (std::vector<uint32_t>::const_iterator i = m_elements[element].paths.begin ();
+       i != m_elements[element].paths.end (); ++i)
+    {
+      DoOne (object, path, *i);
+    }
+}
+
+const Resolver::PathAttributes &
+Resolver::GetPathAttributes (TypeId tid, std::string item)
+{
+  NS_LOG_FUNCTION (tid << item);
+
+  static std::map<std::pair<TypeId, std::string>, PathAttributes> cache;
+  std::pair<TypeId, std::string> key = std::make_pair (tid, item);
+  std::map<std::pair<TypeId, std::string>, PathAttributes>::const_iterator found = cache.find (key);
+  if (found != cache.end ())
+    {
+      return found->second;
+    }
+  PathAttributes &attributes = cache[key];
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info;
+          info = tid.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          PathAttribute attribute;
+          attribute.name = info.name;
+          attribute.isPointer = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0;
+          attribute.isContainer = dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0;
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+          if (attribute.isPointer || attribute.isContainer)
+            {
+              attributes.push_back (attribute);
+            }
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+  return attributes;
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t element, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << element << root);
 
-  if (next == std::string::npos)
+  if (!m_elements[element].paths.empty ())
     {
       //
-      // If root is zero, we're beginning to see if we can use the object name 
-      // service to resolve this path.  It is impossible to have a object name 
+      // If root is zero, we're beginning to see if we can use the object name
+      // service to resolve this path.  It is impossible to have a object name
       // associated with the root of the object name service since that root
       // is not an object.  This path must be referring to something in another
       // namespace and it will have been found already since the name service
       // is always consulted last.
-      // 
+      //
       if (root)
         {
-          DoResolveOne (root);
+          DoResolveOne (element, root);
         }
-      return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  //
-  // If root is zero, we're beginning to see if we can use the object name 
-  // service to resolve this path.  In this case, we must see the name space 
-  // "/Names" on the front of this path.  There is no object associated with 
-  // the root of the "/Names" namespace, so we just ignore it and move on to 
-  // the next segment.
-  //
-  if (root == 0)
+  for (std::vector<uint32_t>::const_iterator i = m_elements[element].children.begin ();
+       i != m_elements[element].children.end (); ++i)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      uint32_t child = *i;
+      const std::string &item = m_elements[child].item;
+
+      //
+      // If root is zero, we're beginning to see if we can use the object name
+      // service to resolve this path.  In this case, we must see the name space
+      // "/Names" on the front of this path.  There is no object associated with
+      // the root of the "/Names" namespace, so we just ignore it and move on to
+      // the next segment.
+      //
+      if (root == 0)
         {
+          if (item.compare (0, 5, "Names") == 0)
+            {
+              m_workStack.push_back (item);
+              DoResolve (child, root);
+              m_workStack.pop_back ();
+              continue;
+            }
+        }
+
+      //
+      // We have an item (possibly a segment of a namespace path.  Check to see if
+      // we can determine that this segment refers to a named object.  If root is
+      // zero, this means to look in the root of the "/Names" name space, otherwise
+      // it refers to a name space context (level).
+      //
+      Ptr<Object> namedObject = Names::Find<Object> (root, item);
+      if (namedObject)
+        {
+          NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (child, namedObject);
           m_workStack.pop_back ();
-          return;
+          continue;
         }
-    }
 
-  //
-  // We have an item (possibly a segment of a namespace path.  Check to see if
-  // we can determine that this segment refers to a named object.  If root is
-  // zero, this means to look in the root of the "/Names" name space, otherwise
-  // it refers to a name space context (level).
-  //
-  Ptr<Object> namedObject = Names::Find<Object> (root, item);
-  if (namedObject)
-    {
-      NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
-      m_workStack.pop_back ();
-      return;
-    }
-
-  //
-  // We're done with the object name service hooks, so proceed down the path
-  // of types and attributes; but only if root is nonzero.  If root is zero
-  // and we find ourselves here, we are trying to check in the namespace for
-  // a path that is not in the "/Names" namespace.  We will have previously
-  // found any matches, so we just bail out.
-  //
-  if (root == 0)
-    {
-      return;
-    }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
-    {
-      // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
-      Ptr<Object> object = root->GetObject<Object> (tid);
-      if (object == 0)
+      //
+      // We're done with the object name service hooks, so proceed down the path
+      // of types and attributes; but only if root is nonzero.  If root is zero
+      // and we find ourselves here, we are trying to check in the namespace for
+      // a path that is not in the "/Names" namespace.  We will have previously
+      // found any matches, so we just bail out.
+      //
+      if (root == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
-          return;
+          continue;
         }
-      m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
-      m_workStack.pop_back ();
-    }
-  else 
-    {
-      // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-      
-      do
+      std::string::size_type dollarPos = item.find ("$");
+      if (dollarPos == 0)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          // This is a call to GetObject
+          std::string tidString = item.substr (1, item.size () - 1);
+          NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
+          TypeId tid = TypeId::LookupByName (tidString);
+          Ptr<Object> object = root->GetObject<Object> (tid);
+          if (object == 0)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
-                {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
+              NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+              continue;
+            }
+          m_workStack.push_back (item);
+          DoResolve (child, object);
+          m_workStack.pop_back ();
+        }
+      else
+        {
+          // this is a normal attribute.
+          const PathAttributes &attributes = GetPathAttributes (root->GetInstanceTypeId (), item);
+          bool foundMatch = false;
+
+          for (PathAttributes::const_iterator attribute = attributes.begin ();
+               attribute != attributes.end (); ++attribute)
+            {
+              if (attribute->isPointer)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
+                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<attribute->name<<" on path="<<GetResolvedPath ());
                   PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
+                  root->GetAttribute (attribute->name, ptr);
                   Ptr<Object> object = ptr.Get<Object> ();
                   if (object == 0)
                     {
@@ -511,63 +680,66 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                       continue;
                     }
                   foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
+                  m_workStack.push_back (attribute->name);
+                  DoResolve (child, object);
                   m_workStack.pop_back ();
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              if (attribute->isContainer)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
+                  NS_LOG_DEBUG ("GetAttribute(vector)="<<attribute->name<<" on path="<<GetResolvedPath ());
                   foundMatch = true;
                   ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
+                  root->GetAttribute (attribute->name, vector);
+                  m_workStack.push_back (attribute->name);
+                  DoArrayResolve (child, vector);
                   m_workStack.pop_back ();
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
             }
 
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
-      
-      if (!foundMatch)
-        {
-          NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
-          return;
+          if (!foundMatch)
+            {
+              NS_LOG_DEBUG ("Requested item="<<item<<" does not exist on path="<<GetResolvedPath ());
+            }
         }
     }
 }
 
-void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+void
+Resolver::DoArrayResolve (uint32_t element, const ObjectPtrContainerValue &container)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
-    {
-      return;
-    }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  NS_LOG_FUNCTION(this << element << &container);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
-  ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+  for (std::vector<uint32_t>::const_iterator i = m_elements[element].children.begin ();
+       i != m_elements[element].children.end (); ++i)
     {
-      if (matcher.Matches ((*it).first))
+      uint32_t child = *i;
+      const ArrayMatcher &matcher = m_elements[child].matcher;
+      uint32_t index;
+      if (matcher.GetSingleIndex (&index))
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          // Look the index up rather than going through the container
+          Ptr<Object> object = container.Get (index);
+          if (object != 0)
+            {
+              std::ostringstream oss;
+              oss << index;
+              m_workStack.push_back (oss.str ());
+              DoResolve (child, object);
+              m_workStack.pop_back ();
+            }
+          continue;
+        }
+      ObjectPtrContainerValue::Iterator it;
+      for (it = container.Begin (); it != container.End (); ++it)
+        {
+          if (matcher.Matches ((*it).first))
+            {
+              std::ostringstream oss;
+              oss << (*it).first;
+              m_workStack.push_back (oss.str ());
+              DoResolve (child, (*it).second);
+              m_workStack.pop_back ();
+            }
         }
     }
 }
@@ -588,6 +760,13 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   Config::MatchContainer LookupMatches (std::string path);
+  /**
+   * Find the objects matching several Config paths, in one traversal.
+   *
+   * \param [in] paths The Config paths.
+   * \returns The objects which match each path.
+   */
+  std::vector<Config::MatchContainer> LookupMatches (const std::vector<std::string> &paths);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -687,7 +866,7 @@ ConfigImpl::LookupMatches (std::string path)
     LookupMatchesResolver (std::string path)
       : Resolver (path)
     {}
-    virtual void DoOne (Ptr<Object> object, std::string path) {
+    virtual void DoOne (Ptr<Object> object, std::string path, uint32_t index) {
       m_objects.push_back (object);
       m_contexts.push_back (path);
     }
@@ -709,6 +888,42 @@ ConfigImpl::LookupMatches (std::string path)
   return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
 }
 
+std::vector<Config::MatchContainer>
+ConfigImpl::LookupMatches (const std::vector<std::string> &paths)
+{
+  NS_LOG_FUNCTION (this << paths.size ());
+  class LookupMatchesResolver : public Resolver 
+  {
+  public:
+    LookupMatchesResolver (uint32_t n)
+      : m_objects (n),
+        m_contexts (n)
+    {}
+    virtual void DoOne (Ptr<Object> object, std::string path, uint32_t index) {
+      m_objects[index].push_back (object);
+      m_contexts[index].push_back (path);
+    }
+    std::vector<std::vector<Ptr<Object> > > m_objects;
+    std::vector<std::vector<std::string> > m_contexts;
+  } resolver = LookupMatchesResolver (paths.size ());
+  for (std::vector<std::string>::const_iterator i = paths.begin (); i != paths.end (); i++)
+    {
+      resolver.AddPath (*i);
+    }
+  for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
+    {
+      resolver.Resolve (*i);
+    }
+  resolver.Resolve (0);
+
+  std::vector<Config::MatchContainer> containers;
+  for (uint32_t i = 0; i < paths.size (); i++)
+    {
+      containers.push_back (Config::MatchContainer (resolver.m_objects[i], resolver.m_contexts[i], paths[i]));
+    }
+  return containers;
+}
+
 void 
 ConfigImpl::RegisterRootNamespaceObject (Ptr<Object> obj)
 {
@@ -873,6 +1088,93 @@ Ptr<Object> GetRootNamespaceObject (uint32_t i)
   return ConfigImpl::Get ()->GetRootNamespaceObject (i);
 }
 
+void
+Batch::Add (Kind kind, std::string path, Ptr<const AttributeValue> value, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << kind << path << value << &cb);
+  std::string::size_type slash = path.find_last_of ("/");
+  NS_ASSERT (slash != std::string::npos);
+  Call call;
+  call.kind = kind;
+  call.path = path.substr (0, slash);
+  call.name = path.substr (slash + 1, path.size () - (slash + 1));
+  call.value = value;
+  call.cb = cb;
+  m_calls.push_back (call);
+}
+
+void
+Batch::Set (std::string path, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << path << &value);
+  Add (SET, path, value.Copy (), CallbackBase ());
+}
+
+void
+Batch::Connect (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+  Add (CONNECT, path, 0, cb);
+}
+
+void
+Batch::ConnectWithoutContext (std::string path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << path << &cb);
+  Add (CONNECT_WITHOUT_CONTEXT, path, 0, cb);
+}
+
+uint32_t
+Batch::GetN (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_calls.size ();
+}
+
+uint32_t
+Batch::Apply (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Each distinct path is resolved once
+  std::vector<std::string> paths;
+  std::map<std::string, uint32_t> indices;
+  std::vector<uint32_t> callPaths;
+  for (std::vector<Call>::const_iterator call = m_calls.begin (); call != m_calls.end (); ++call)
+    {
+      std::map<std::string, uint32_t>::const_iterator found = indices.find (call->path);
+      if (found == indices.end ())
+        {
+          found = indices.insert (std::make_pair (call->path, paths.size ())).first;
+          paths.push_back (call->path);
+        }
+      callPaths.push_back (found->second);
+    }
+  std::vector<MatchContainer> containers = ConfigImpl::Get ()->LookupMatches (paths);
+
+  uint32_t applied = 0;
+  for (uint32_t i = 0; i < m_calls.size (); i++)
+    {
+      const Call &call = m_calls[i];
+      MatchContainer &container = containers[callPaths[i]];
+      switch (call.kind)
+        {
+        case SET:
+          container.Set (call.name, *call.value);
+          break;
+        case CONNECT:
+          container.Connect (call.name, call.cb);
+          break;
+        case CONNECT_WITHOUT_CONTEXT:
+          container.ConnectWithoutContext (call.name, call.cb);
+          break;
+        }
+      applied += container.GetN ();
+    }
+  m_calls.clear ();
+  return applied;
+}
+
 } // namespace Config
 
 } // namespace ns3
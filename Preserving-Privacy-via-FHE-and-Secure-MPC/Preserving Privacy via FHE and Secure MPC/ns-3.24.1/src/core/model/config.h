@@ -21,6 +21,7 @@
 #define CONFIG_H
 
 #include "ptr.h"
+#include "callback.h"
 #include <string>
 #include <vector>
 
@@ -287,6 +288,102 @@ uint32_t GetRootNamespaceObjectN (void);
  */
 Ptr<Object> GetRootNamespaceObject (uint32_t i);
 
+/**
+ * \ingroup config
+ * \brief A set of Config::Set and Config::Connect calls, resolved together.
+ *
+ * Each call of Config::Set or Config::Connect parses its path and walks
+ * the objects it matches from the root namespace objects. A Batch
+ * records the calls instead, and Apply parses each distinct path once
+ * and walks the objects matched by all the paths in one traversal: the
+ * objects reached by the common start of several paths, such as
+ * "/NodeList/<i>/DeviceList/<j>", are looked up once for all of them.
+ *
+ * \code
+ *   Config::Batch batch;
+ *   for (uint32_t i = 0; i < nodes.GetN (); i++)
+ *     {
+ *       std::ostringstream oss;
+ *       oss << "/NodeList/" << nodes.Get (i)->GetId () << "/DeviceList/0/$ns3::WifiNetDevice/Phy/";
+ *       batch.Connect (oss.str () + "PhyTxBegin", MakeCallback (&TxBegin));
+ *       batch.Connect (oss.str () + "PhyRxEnd", MakeCallback (&RxEnd));
+ *     }
+ *   batch.Apply ();
+ * \endcode
+ *
+ * The paths are resolved against the objects present when Apply is
+ * called, and the calls are then made in the order they were added. A
+ * Set of the batch should thus not change the objects traversed by the
+ * paths of the later calls of the batch, since they have been resolved
+ * beforehand.
+ */
+class Batch
+{
+public:
+  /**
+   * \param [in] path A path to match attributes.
+   * \param [in] value The value to set in all matching attributes.
+   *
+   * Record a call to Config::Set.
+   */
+  void Set (std::string path, const AttributeValue &value);
+  /**
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   *
+   * Record a call to Config::Connect.
+   */
+  void Connect (std::string path, const CallbackBase &cb);
+  /**
+   * \param [in] path A path to match trace sources.
+   * \param [in] cb The callback to connect to the matching trace sources.
+   *
+   * Record a call to Config::ConnectWithoutContext.
+   */
+  void ConnectWithoutContext (std::string path, const CallbackBase &cb);
+  /**
+   * \returns The number of calls recorded and not applied yet.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Resolve the paths of the recorded calls, make the calls on the
+   * matching objects and forget them.
+   *
+   * \returns The number of calls made, one per call and matching object.
+   */
+  uint32_t Apply (void);
+
+private:
+  /** The kinds of calls recorded. */
+  enum Kind
+  {
+    SET,                     //!< Config::Set
+    CONNECT,                 //!< Config::Connect
+    CONNECT_WITHOUT_CONTEXT  //!< Config::ConnectWithoutContext
+  };
+  /** A recorded call. */
+  struct Call
+  {
+    Kind kind;                      //!< The kind of call
+    std::string path;               //!< The path to the objects, up to the last slash
+    std::string name;               //!< The attribute or trace source
+    Ptr<const AttributeValue> value; //!< The value of a SET
+    CallbackBase cb;                //!< The callback of a CONNECT
+  };
+  /**
+   * Record a call.
+   *
+   * \param [in] kind The kind of call.
+   * \param [in] path The full path of the call.
+   * \param [in] value The value of a SET.
+   * \param [in] cb The callback of a CONNECT.
+   */
+  void Add (Kind kind, std::string path, Ptr<const AttributeValue> value, const CallbackBase &cb);
+
+  /** The recorded calls, in order. */
+  std::vector<Call> m_calls;
+};
+
 } // namespace Config
 
 } // namespace ns3
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator-sweep.h"
+#include "simulator.h"
+#include "fatal-error.h"
+#include "assert.h"
+#include "log.h"
+#include <iostream>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorSweep implementation, for Unix-like systems.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SimulatorSweep");
+
+SimulatorSweep::SimulatorSweep ()
+  : m_warmup (Seconds (0)),
+    m_warmedUp (false),
+    m_result (-1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SimulatorSweep::~SimulatorSweep ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_result >= 0)
+    {
+      close (m_result);
+    }
+  for (std::vector<Variant>::const_iterator i = m_variants.begin (); i != m_variants.end (); ++i)
+    {
+      close (i->result);
+    }
+}
+
+void
+SimulatorSweep::RunWarmup (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  NS_ASSERT_MSG (!m_warmedUp, "The warm-up is already done");
+  NS_ASSERT_MSG (time >= Simulator::Now (), "The end of the warm-up is in the past");
+  Simulator::Stop (time - Simulator::Now ());
+  Simulator::Run ();
+  m_warmup = Simulator::Now ();
+  m_warmedUp = true;
+}
+
+Time
+SimulatorSweep::GetWarmupTime (void) const
+{
+  return m_warmup;
+}
+
+bool
+SimulatorSweep::Fork (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_warmedUp, "The warm-up is not done");
+  NS_ASSERT_MSG (m_result < 0, "A variant forks nothing");
+  NS_ASSERT_MSG (Simulator::Now () == m_warmup, "The simulation has moved on from the warm-up");
+  int fds[2];
+  if (pipe (fds) < 0)
+    {
+      NS_FATAL_ERROR ("Cannot create the result pipe: " << std::strerror (errno));
+    }
+  // Otherwise the buffered output is written by the original and every copy
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::fflush (0);
+  pid_t pid = fork ();
+  if (pid < 0)
+    {
+      NS_FATAL_ERROR ("Cannot copy the process: " << std::strerror (errno));
+    }
+  if (pid == 0)
+    {
+      close (fds[0]);
+      for (std::vector<Variant>::const_iterator i = m_variants.begin (); i != m_variants.end (); ++i)
+        {
+          close (i->result);
+        }
+      m_variants.clear ();
+      m_result = fds[1];
+      return true;
+    }
+  NS_LOG_LOGIC ("Variant in process " << pid);
+  close (fds[1]);
+  Variant variant;
+  variant.pid = pid;
+  variant.result = fds[0];
+  m_variants.push_back (variant);
+  return false;
+}
+
+bool
+SimulatorSweep::IsVariant (void) const
+{
+  return m_result >= 0;
+}
+
+void
+SimulatorSweep::Report (const std::string &result)
+{
+  NS_LOG_FUNCTION (this << result);
+  NS_ASSERT_MSG (m_result >= 0, "Only a variant reports a result");
+  if (write (m_result, result.data (), result.size ()) != (ssize_t) result.size ())
+    {
+      NS_LOG_WARN ("Cannot send the result: " << std::strerror (errno));
+    }
+  close (m_result);
+  m_result = -1;
+}
+
+uint32_t
+SimulatorSweep::Wait (std::vector<std::string> &results)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t failed = 0;
+  for (std::vector<Variant>::const_iterator i = m_variants.begin (); i != m_variants.end (); ++i)
+    {
+      // the result is read first, the copy may block on a full pipe
+      std::string result;
+      char buffer[256];
+      ssize_t n;
+      while ((n = read (i->result, buffer, sizeof (buffer))) != 0)
+        {
+          if (n > 0)
+            {
+              result.append (buffer, n);
+            }
+          else if (errno != EINTR)
+            {
+              break;
+            }
+        }
+      close (i->result);
+      results.push_back (result);
+      int status;
+      while (waitpid (i->pid, &status, 0) < 0)
+        {
+          if (errno != EINTR)
+            {
+              NS_FATAL_ERROR ("Cannot wait for process " << i->pid << ": " << std::strerror (errno));
+            }
+        }
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          NS_LOG_WARN ("Process " << i->pid << " failed");
+          failed++;
+        }
+    }
+  m_variants.clear ();
+  return failed;
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATOR_SWEEP_H
+#define SIMULATOR_SWEEP_H
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "nstime.h"
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorSweep declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Run the variants of a sweep from the end of a shared warm-up,
+ * each in a copy of the process.
+ *
+ * RunWarmup runs the simulation up to the end of the warm-up, e.g. once
+ * the peer links of a mesh are up. Every Fork then continues it in a
+ * fork()ed copy of the process, which configures and runs one variant,
+ * sends a one-line result back with Report, and exits. The original
+ * collects the results with Wait.
+ *
+ * Nothing is written out: the warm-up only lives in the original process,
+ * for as long as it runs, and the class is only built on Unix-like
+ * systems.
+ *
+ * \code
+ *   SimulatorSweep sweep;
+ *   sweep.RunWarmup (Seconds (35));
+ *   for (uint32_t i = 0; i < variants.size (); i++)
+ *     {
+ *       if (sweep.Fork ())
+ *         {
+ *           // configure variant i, e.g. with Config::Set
+ *           Simulator::Stop (Seconds (100) - Simulator::Now ());
+ *           Simulator::Run ();
+ *           sweep.Report ("result of variant i");
+ *           Simulator::Destroy ();
+ *           exit (0);
+ *         }
+ *     }
+ *   std::vector<std::string> results;
+ *   uint32_t failed = sweep.Wait (results);
+ * \endcode
+ *
+ * A copy draws the same random numbers as the original would if it
+ * continued; RngSeedManager::SetRun only applies to the random variables
+ * created afterwards. A copy only has the thread which called Fork, so
+ * the sweep is for the default, single threaded, simulator implementation.
+ * The original should not run the simulation further while variants are
+ * to be forked.
+ */
+class SimulatorSweep
+{
+public:
+  SimulatorSweep ();
+  ~SimulatorSweep ();
+
+  /**
+   * \brief Run the simulation up to the end of the warm-up and keep it there
+   * \param time the end of the warm-up, absolute
+   *
+   * Called outside Simulator::Run, once.
+   */
+  void RunWarmup (Time time);
+  /// \return the simulation time of the end of the warm-up
+  Time GetWarmupTime (void) const;
+  /**
+   * \brief Continue the simulation from the end of the warm-up in a copy
+   * of the process
+   * \return true in the copy, false in the original
+   */
+  bool Fork (void);
+  /// \return whether this process is a copy running a variant
+  bool IsVariant (void) const;
+  /**
+   * \brief Send the result of the variant to the original process
+   * \param result a short text, e.g. one line of statistics
+   *
+   * Called once, in a copy.
+   */
+  void Report (const std::string &result);
+  /**
+   * \brief Wait for the end of the copies forked since the last call
+   * \param results the result of each copy, in fork order, appended; empty
+   * for a copy which reported nothing
+   * \return the number of copies which failed, with a non-zero exit status
+   * or a signal
+   */
+  uint32_t Wait (std::vector<std::string> &results);
+
+private:
+  /// A copy of the process and the read end of its result pipe
+  struct Variant
+  {
+    pid_t pid;
+    int result;
+  };
+
+  Time m_warmup;                    //!< End of the warm-up
+  bool m_warmedUp;                  //!< RunWarmup was called
+  int m_result;                     //!< In a copy: write end of its result pipe, -1 otherwise
+  std::vector<Variant> m_variants;  //!< The copies not waited for yet
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_SWEEP_H */
@@ -721,6 +721,101 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+// ===========================================================================
+// Test for the resolution of a batch of Sets and Connects in one traversal.
+// ===========================================================================
+class BatchConfigTestCase : public TestCase
+{
+public:
+  BatchConfigTestCase ();
+  virtual ~BatchConfigTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) { m_traced++; }
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_paths.push_back (path); }
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_traced;
+  std::vector<std::string> m_paths;
+};
+
+BatchConfigTestCase::BatchConfigTestCase ()
+  : TestCase ("Check ability to set and trace connect a batch of paths in one traversal")
+{
+}
+
+void
+BatchConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  //
+  // A root namespace object, an object under it and four objects in a
+  // vector one level down.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  a->SetNodeB (b);
+  Ptr<ConfigTestObject> obj[4];
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      obj[i] = CreateObject<ConfigTestObject> ();
+      b->AddNodeB (obj[i]);
+    }
+
+  //
+  // The paths share their start; the objects of earlier tests may match
+  // them too, so that the number of calls is checked against LookupMatches.
+  //
+  uint32_t expected = Config::LookupMatches ("/NodeA/NodeB").GetN ()
+    + Config::LookupMatches ("/NodeA/NodeB/NodesB/[0-1]|3").GetN ()
+    + Config::LookupMatches ("/NodeA/NodeB/NodesB/2").GetN ()
+    + Config::LookupMatches ("/NodeA/NodeB/NodesB/*").GetN ()
+    + Config::LookupMatches ("/NodeA/NodeB/NodesB/[0-1]|3").GetN ();
+  Config::Batch batch;
+  batch.Set ("/NodeA/NodeB/A", IntegerValue (1));
+  batch.Set ("/NodeA/NodeB/NodesB/[0-1]|3/A", IntegerValue (2));
+  batch.Set ("/NodeA/NodeB/NodesB/2/B", IntegerValue (3));
+  batch.ConnectWithoutContext ("/NodeA/NodeB/NodesB/*/Source",
+                               MakeCallback (&BatchConfigTestCase::Trace, this));
+  batch.Connect ("/NodeA/NodeB/NodesB/[0-1]|3/Source",
+                 MakeCallback (&BatchConfigTestCase::TraceWithPath, this));
+  NS_TEST_ASSERT_MSG_EQ (batch.GetN (), 5, "Calls not recorded");
+  NS_TEST_ASSERT_MSG_EQ (batch.Apply (), expected, "Unexpected number of calls made");
+  NS_TEST_ASSERT_MSG_EQ (batch.GetN (), 0, "Calls not forgotten by Apply");
+
+  b->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 1, "Object Attribute \"A\" not set by the batch");
+  obj[0]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 2, "Object Attribute \"A\" not set through the vector");
+  obj[2]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+  obj[2]->GetAttribute ("B", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 3, "Object Attribute \"B\" not set through the index");
+  obj[3]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 2, "Object Attribute \"A\" not set through the vector");
+
+  m_traced = 0;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      obj[i]->SetAttribute ("Source", IntegerValue (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_traced, 4, "Traces did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 3, "Traces with context did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[2], "/NodeA/NodeB/NodesB/3/Source", "Trace 3 did not provide expected context");
+
+  //
+  // An empty batch makes no call.
+  //
+  NS_TEST_ASSERT_MSG_EQ (batch.Apply (), 0, "Calls made by an empty batch");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -737,6 +832,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new BatchConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <unistd.h>
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-sweep.h"
+#include "ns3/random-variable-stream.h"
+
+using namespace ns3;
+
+/**
+ * \brief Check that the variants forked from the end of the warm-up run
+ * the events and draw the random numbers the original runs when it
+ * continues, and that their results are collected in fork order.
+ */
+class SimulatorSweepTestCase : public TestCase
+{
+public:
+  SimulatorSweepTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// Draw a random number, every second
+  void Draw (void);
+  /// \return the numbers drawn since the index, as text
+  std::string Format (size_t first) const;
+
+  Ptr<UniformRandomVariable> m_random;
+  std::vector<double> m_values;
+};
+
+SimulatorSweepTestCase::SimulatorSweepTestCase ()
+  : TestCase ("Check the variants forked from the end of the warm-up")
+{
+}
+
+void
+SimulatorSweepTestCase::Draw (void)
+{
+  m_values.push_back (m_random->GetValue ());
+  Simulator::Schedule (Seconds (1), &SimulatorSweepTestCase::Draw, this);
+}
+
+std::string
+SimulatorSweepTestCase::Format (size_t first) const
+{
+  std::ostringstream os;
+  os.precision (17);
+  for (size_t i = first; i < m_values.size (); i++)
+    {
+      os << m_values[i] << " ";
+    }
+  return os.str ();
+}
+
+void
+SimulatorSweepTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  Simulator::Schedule (Seconds (0), &SimulatorSweepTestCase::Draw, this);
+
+  SimulatorSweep sweep;
+  sweep.RunWarmup (Seconds (4.5));
+  NS_TEST_ASSERT_MSG_EQ (sweep.GetWarmupTime (), Seconds (4.5), "Wrong end of the warm-up");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (4.5), "The simulation should stop at the end of the warm-up");
+  NS_TEST_ASSERT_MSG_EQ (m_values.size (), 5, "The events of the warm-up should run");
+  NS_TEST_ASSERT_MSG_EQ (sweep.IsVariant (), false, "The original is not a variant");
+
+  // Two variants report the numbers drawn after the warm-up, a third one
+  // reports nothing and fails
+  for (uint32_t v = 0; v < 3; v++)
+    {
+      if (sweep.Fork ())
+        {
+          Simulator::Stop (Seconds (10) - Simulator::Now ());
+          Simulator::Run ();
+          if (v < 2 && sweep.IsVariant ())
+            {
+              sweep.Report (Format (5));
+            }
+          Simulator::Destroy ();
+          _exit (v < 2 ? 0 : 1);
+        }
+    }
+  std::vector<std::string> results;
+  NS_TEST_ASSERT_MSG_EQ (sweep.Wait (results), 1, "One variant should fail");
+  NS_TEST_ASSERT_MSG_EQ (results.size (), 3, "One result per variant expected");
+  NS_TEST_ASSERT_MSG_EQ (m_values.size (), 5, "The variants should not change the original");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (4.5), "The variants should not change the original");
+
+  // The original continues as the variants did
+  Simulator::Stop (Seconds (10) - Simulator::Now ());
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_values.size (), 10, "The events after the warm-up should run");
+  NS_TEST_EXPECT_MSG_EQ (results[0], Format (5), "The first variant should draw the numbers of the original");
+  NS_TEST_EXPECT_MSG_EQ (results[1], Format (5), "The second variant should draw the numbers of the original");
+  NS_TEST_EXPECT_MSG_EQ (results[2], "", "The failed variant reported nothing");
+  Simulator::Destroy ();
+}
+
+class SimulatorSweepTestSuite : public TestSuite
+{
+public:
+  SimulatorSweepTestSuite ()
+    : TestSuite ("simulator-sweep", UNIT)
+  {
+    AddTestCase (new SimulatorSweepTestCase (), TestCase::QUICK);
+  }
+} g_simulatorSweepTestSuite;
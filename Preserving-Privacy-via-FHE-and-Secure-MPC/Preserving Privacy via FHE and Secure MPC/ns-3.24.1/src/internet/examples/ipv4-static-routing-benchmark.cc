@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Micro-benchmark of the route lookups of Ipv4StaticRouting.
+//
+// A node has a host route per meter, as the gateway of a large mesh would,
+// plus some network routes and a default route. The routes to random
+// destinations are looked up with RouteOutput, by scanning the routes and
+// with the lookup tables (UseLookupTables attribute).
+//
+// ./waf --run "ipv4-static-routing-benchmark --Routes=10000 --Lookups=1000000"
+
+#include <iostream>
+#include <vector>
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/command-line.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/// \return the rate of an operation, per second
+static uint64_t
+Rate (uint64_t count, int64_t elapsed)
+{
+  return elapsed > 0 ? count * 1000 / elapsed : 0;
+}
+
+/// \return the time taken by the lookups, in ms
+static int64_t
+Lookups (Ptr<Ipv4StaticRouting> routing, const std::vector<Ipv4Address> &destinations, uint32_t nLookups, uint32_t *found)
+{
+  Ptr<Packet> p = Create<Packet> ();
+  Ipv4Header header;
+  Socket::SocketErrno sockerr;
+  SystemWallClockMs clock;
+  clock.Start ();
+  *found = 0;
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      header.SetDestination (destinations[i % destinations.size ()]);
+      *found += routing->RouteOutput (p, header, 0, sockerr)->GetGateway () != Ipv4Address ("10.0.0.254");
+    }
+  return clock.End ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nRoutes = 10000;
+  uint32_t nLookups = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("Routes", "The number of host routes", nRoutes);
+  cmd.AddValue ("Lookups", "The number of route lookups", nLookups);
+  cmd.Parse (argc, argv);
+
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  node->AddDevice (device);
+  uint32_t ifIndex = ipv4->AddInterface (device);
+  ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask ("/24")));
+  ipv4->SetUp (ifIndex);
+
+  // Host routes to 7.x.x.x, network routes to some /16 and /24, the default
+  // route catches the destinations without host route
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> routing = ipv4RoutingHelper.GetStaticRouting (ipv4);
+  routing->SetDefaultRoute (Ipv4Address ("10.0.0.254"), ifIndex);
+  for (uint32_t i = 0; i < 64; i++)
+    {
+      routing->AddNetworkRouteTo (Ipv4Address (0x07000000 | i << 16), Ipv4Mask ("/16"), Ipv4Address ("10.0.0.253"), ifIndex);
+      routing->AddNetworkRouteTo (Ipv4Address (0x07000000 | i << 8), Ipv4Mask ("/24"), Ipv4Address ("10.0.0.252"), ifIndex);
+    }
+  std::vector<Ipv4Address> hosts;
+  for (uint32_t i = 0; i < nRoutes; i++)
+    {
+      hosts.push_back (Ipv4Address (0x07000000 | i * 7));
+      routing->AddHostRouteTo (hosts.back (), Ipv4Address (0x0a000000 | (i % 250 + 2)), ifIndex);
+    }
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<Ipv4Address> destinations;
+  for (uint32_t i = 0; i < 4096; i++)
+    {
+      // mostly meters, some other destinations
+      if (random->GetInteger (0, 9) > 0)
+        {
+          destinations.push_back (hosts[random->GetInteger (0, nRoutes - 1)]);
+        }
+      else
+        {
+          destinations.push_back (Ipv4Address (random->GetInteger (0, 0xffffffff)));
+        }
+    }
+
+  uint32_t scanFound;
+  routing->SetAttribute ("UseLookupTables", BooleanValue (false));
+  int64_t scanElapsed = Lookups (routing, destinations, nLookups, &scanFound);
+  uint32_t tablesFound;
+  routing->SetAttribute ("UseLookupTables", BooleanValue (true));
+  int64_t tablesElapsed = Lookups (routing, destinations, nLookups, &tablesFound);
+
+  Simulator::Destroy ();
+
+  std::cout << "routes=" << routing->GetNRoutes () << " lookups=" << nLookups << std::endl;
+  std::cout << "scan: wall-clock(ms)=" << scanElapsed << " lookups/s=" << Rate (nLookups, scanElapsed)
+            << " not-default=" << scanFound << std::endl;
+  std::cout << "lookup tables: wall-clock(ms)=" << tablesElapsed << " lookups/s=" << Rate (nLookups, tablesElapsed)
+            << " not-default=" << tablesFound << std::endl;
+  return 0;
+}
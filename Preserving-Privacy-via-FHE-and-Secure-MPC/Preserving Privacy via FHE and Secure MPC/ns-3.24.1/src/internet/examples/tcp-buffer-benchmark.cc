@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Micro-benchmark of the TCP buffers, without the rest of the stack.
+//
+// The sender side writes messages (6 KB ciphertexts by default) into a
+// TcpTxBuffer, copies segments out of it in order, retransmits a fraction
+// of them and discards the acknowledged bytes. The receiver side adds the
+// segments to a TcpRxBuffer; the lost ones arrive later, after some other
+// segments, as retransmissions do, and the data is extracted when in order.
+//
+// ./waf --run "tcp-buffer-benchmark --Bytes=100000000 --Loss=0.02"
+
+#include <iostream>
+#include <vector>
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-header.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/command-line.h"
+#include "ns3/object.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/// \return the throughput, in MB/s
+static double
+Throughput (uint64_t bytes, int64_t elapsed)
+{
+  return elapsed > 0 ? bytes / 1000.0 / elapsed : 0;
+}
+
+int main (int argc, char *argv[])
+{
+  uint64_t nBytes = 100000000;
+  uint32_t messageSize = 6144;
+  uint32_t segmentSize = 536;
+  uint32_t bufferSize = 131072;
+  double loss = 0.02;
+  uint32_t reorder = 20;
+
+  CommandLine cmd;
+  cmd.AddValue ("Bytes", "The number of bytes sent", nBytes);
+  cmd.AddValue ("MessageSize", "The size of the messages written by the application", messageSize);
+  cmd.AddValue ("SegmentSize", "The size of the segments", segmentSize);
+  cmd.AddValue ("BufferSize", "The size of the buffers", bufferSize);
+  cmd.AddValue ("Loss", "The fraction of the segments lost", loss);
+  cmd.AddValue ("Reorder", "The number of segments received before the retransmission of a lost one", reorder);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  // Sender: the window is half the buffer, an ack every two segments
+  Ptr<TcpTxBuffer> tx = CreateObject<TcpTxBuffer> ();
+  tx->SetMaxBufferSize (bufferSize);
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t written = 0;
+  uint64_t sent = 0;
+  uint64_t acked = 0;
+  uint64_t retransmitted = 0;
+  uint32_t segments = 0;
+  while (acked < nBytes)
+    {
+      while (written < nBytes && tx->Add (Create<Packet> (messageSize)))
+        {
+          written += messageSize;
+        }
+      while (sent < written && sent - acked < bufferSize / 2)
+        {
+          Ptr<Packet> p = tx->CopyFromSequence (segmentSize, tx->HeadSequence () + SequenceNumber32 (sent - acked));
+          sent += p->GetSize ();
+          if (random->GetValue () < loss)
+            {
+              tx->CopyFromSequence (segmentSize, tx->HeadSequence ());
+              retransmitted++;
+            }
+          if (++segments % 2 == 0)
+            {
+              tx->DiscardUpTo (tx->HeadSequence () + SequenceNumber32 (sent - acked));
+              acked = sent;
+            }
+        }
+      if (sent == written && acked < sent)
+        {
+          tx->DiscardUpTo (tx->HeadSequence () + SequenceNumber32 (sent - acked));
+          acked = sent;
+        }
+    }
+  int64_t txElapsed = clock.End ();
+
+  // Receiver
+  Ptr<TcpRxBuffer> rx = CreateObject<TcpRxBuffer> ();
+  rx->SetMaxBufferSize (bufferSize);
+  rx->SetNextRxSequence (SequenceNumber32 (0));
+  std::vector<std::pair<uint32_t, uint64_t> > lost; // segments lost, with the segment count of their retransmission
+  clock.Start ();
+  uint64_t next = 0;
+  uint64_t received = 0;
+  uint64_t segment = 0;
+  TcpHeader header;
+  while (received < nBytes)
+    {
+      segment++;
+      if (!lost.empty () && lost.front ().second <= segment)
+        {
+          header.SetSequenceNumber (SequenceNumber32 (lost.front ().first));
+          rx->Add (Create<Packet> (segmentSize), header);
+          lost.erase (lost.begin ());
+        }
+      else if (next < nBytes && SequenceNumber32 (next + segmentSize) <= rx->MaxRxSequence ())
+        {
+          if (random->GetValue () < loss)
+            {
+              lost.push_back (std::make_pair ((uint32_t) next, segment + reorder));
+            }
+          else
+            {
+              header.SetSequenceNumber (SequenceNumber32 (next));
+              rx->Add (Create<Packet> (segmentSize), header);
+            }
+          next += segmentSize;
+        }
+      Ptr<Packet> p = rx->Extract (messageSize);
+      if (p != 0)
+        {
+          received += p->GetSize ();
+        }
+    }
+  int64_t rxElapsed = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << "bytes=" << nBytes << " message=" << messageSize << " segment=" << segmentSize
+            << " loss=" << loss << std::endl;
+  std::cout << "tx buffer: wall-clock(ms)=" << txElapsed << " MB/s=" << Throughput (nBytes, txElapsed)
+            << " retransmissions=" << retransmitted << std::endl;
+  std::cout << "rx buffer: wall-clock(ms)=" << rxElapsed << " MB/s=" << Throughput (nBytes, rxElapsed) << std::endl;
+  return 0;
+}
@@ -317,6 +317,24 @@ ArpCache::Add (Ipv4Address to)
   return entry;
 }
 
+ArpCache::Entry *
+ArpCache::AddPermanent (Ipv4Address to, Address macAddress)
+{
+  NS_LOG_FUNCTION (this << to << macAddress);
+  ArpCache::Entry *entry = Lookup (to);
+  if (entry == 0)
+    {
+      entry = Add (to);
+    }
+  else if (entry->IsWaitReply ())
+    { // Nothing is pending once the address is known
+      entry->ClearPendingPacket ();
+    }
+  entry->SetMacAddresss (macAddress);
+  entry->MarkPermanent ();
+  return entry;
+}
+
 void
 ArpCache::Remove (ArpCache::Entry *entry)
 {
@@ -390,6 +408,15 @@ ArpCache::Entry::MarkAlive (Address macAddress)
   UpdateSeen ();
 }
 void
+ArpCache::Entry::MarkResolved (Address macAddress)
+{
+  NS_LOG_FUNCTION (this << macAddress);
+  NS_ASSERT (m_state == ALIVE && m_macAddress.IsInvalid ());
+  m_macAddress = macAddress;
+  ClearRetries ();
+  UpdateSeen ();
+}
+void
 ArpCache::Entry::MarkPermanent (void)
 {
   NS_LOG_FUNCTION (this);
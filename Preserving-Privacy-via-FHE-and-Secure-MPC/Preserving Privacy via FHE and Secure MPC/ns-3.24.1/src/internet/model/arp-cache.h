@@ -150,6 +150,17 @@ public:
    * \brief Add an Ipv4Address to this ARP cache
    */
   ArpCache::Entry *Add (Ipv4Address to);
+  /**
+   * \brief Add a permanent entry, or make the existing entry permanent
+   *
+   * The entry is never refreshed nor flushed by an ARP timeout, e.g. the
+   * address of a neighbour installed before the simulation starts.
+   *
+   * \param to the IPv4 address
+   * \param macAddress the MAC address of the IPv4 address
+   * \return the entry
+   */
+  ArpCache::Entry *AddPermanent (Ipv4Address to, Address macAddress);
   /**
    * \brief Remove an entry.
    * \param entry pointer to delete it from the list
@@ -186,6 +197,12 @@ public:
      * \param macAddress
      */
     void MarkAlive (Address macAddress);
+    /**
+     * \brief Changes the state of a new entry to alive, its MAC address
+     * being known without an ARP exchange
+     * \param macAddress the MAC address
+     */
+    void MarkResolved (Address macAddress);
     /**
      * \param waiting
      */
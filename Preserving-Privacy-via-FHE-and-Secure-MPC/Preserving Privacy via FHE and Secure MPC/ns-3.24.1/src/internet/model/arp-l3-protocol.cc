@@ -25,6 +25,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/enum.h"
 
 #include "ipv4-l3-protocol.h"
 #include "arp-l3-protocol.h"
@@ -61,6 +62,19 @@ ArpL3Protocol::GetTypeId (void)
                    StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=10.0]"),
                    MakePointerAccessor (&ArpL3Protocol::m_requestJitter),
                    MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Mode",
+                   "How the entries of the ARP caches are created and "
+                   "maintained: by broadcast requests (Normal), by "
+                   "broadcast requests then kept permanently "
+                   "(CreationOnly), by the resolve callback then refreshed "
+                   "by unicast requests (MaintenanceOnly), or only from "
+                   "the permanent entries installed beforehand (Preinstalled)",
+                   EnumValue (NORMAL),
+                   MakeEnumAccessor (&ArpL3Protocol::m_mode),
+                   MakeEnumChecker (NORMAL, "Normal",
+                                    CREATION_ONLY, "CreationOnly",
+                                    MAINTENANCE_ONLY, "MaintenanceOnly",
+                                    PREINSTALLED, "Preinstalled"))
     .AddTraceSource ("Drop",
                      "Packet dropped because not enough room "
                      "in pending queue for a specific cache entry.",
@@ -71,6 +85,7 @@ ArpL3Protocol::GetTypeId (void)
 }
 
 ArpL3Protocol::ArpL3Protocol ()
+  : m_mode (NORMAL)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -88,6 +103,13 @@ ArpL3Protocol::AssignStreams (int64_t stream)
   return 1;
 }
 
+void
+ArpL3Protocol::SetResolveCallback (Callback<Address, Ipv4Address> resolve)
+{
+  NS_LOG_FUNCTION (this);
+  m_resolveCallback = resolve;
+}
+
 void 
 ArpL3Protocol::SetNode (Ptr<Node> node)
 {
@@ -127,6 +149,7 @@ ArpL3Protocol::DoDispose (void)
     }
   m_cacheList.clear ();
   m_node = 0;
+  m_resolveCallback = MakeNullCallback<Address, Ipv4Address> ();
   Object::DoDispose ();
 }
 
@@ -229,6 +252,10 @@ ArpL3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t pro
                                        << " for waiting entry -- flush");
                   Address from_mac = arp.GetSourceHardwareAddress ();
                   entry->MarkAlive (from_mac);
+                  if (m_mode == CREATION_ONLY)
+                    {
+                      entry->MarkPermanent ();
+                    }
                   Ptr<Packet> pending = entry->DequeuePending ();
                   while (pending != 0)
                     {
@@ -282,6 +309,14 @@ ArpL3Protocol::Lookup (Ptr<Packet> packet, Ipv4Address destination,
               entry->MarkWaitReply (packet);
               Simulator::Schedule (Time (MilliSeconds (m_requestJitter->GetValue ())), &ArpL3Protocol::SendArpRequest, this, cache, destination);
             } 
+          else if (entry->IsAlive () && m_mode == MAINTENANCE_ONLY)
+            {
+              NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
+                            ", alive entry for " << destination << " expired -- send unicast arp request");
+              Address mac = entry->GetMacAddress ();
+              entry->MarkWaitReply (packet);
+              Simulator::Schedule (Time (MilliSeconds (m_requestJitter->GetValue ())), &ArpL3Protocol::SendUnicastArpRequest, this, cache, destination, mac);
+            }
           else if (entry->IsAlive ()) 
             {
               NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
@@ -331,12 +366,31 @@ ArpL3Protocol::Lookup (Ptr<Packet> packet, Ipv4Address destination,
             }
         }
     }
+  else if (m_mode == PREINSTALLED)
+    {
+      NS_LOG_WARN ("node="<<m_node->GetId ()<<
+                   ", no permanent entry for " << destination << " -- drop");
+      m_dropTrace (packet);
+    }
   else
     {
+      Address mac;
+      if (m_mode == MAINTENANCE_ONLY && !m_resolveCallback.IsNull ())
+        {
+          mac = m_resolveCallback (destination);
+        }
+      entry = cache->Add (destination);
+      if (!mac.IsInvalid ())
+        {
+          NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
+                        ", no entry for " << destination << " -- resolved to " << mac << ", send");
+          entry->MarkResolved (mac);
+          *hardwareDestination = mac;
+          return true;
+        }
       // This is our first attempt to transmit data to this destination.
       NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
                     ", no entry for " << destination << " -- send arp request");
-      entry = cache->Add (destination);
       entry->MarkWaitReply (packet);
       Simulator::Schedule (Time (MilliSeconds (m_requestJitter->GetValue ())), &ArpL3Protocol::SendArpRequest, this, cache, destination);
     }
@@ -364,6 +418,24 @@ ArpL3Protocol::SendArpRequest (Ptr<const ArpCache> cache, Ipv4Address to)
   cache->GetDevice ()->Send (packet, device->GetBroadcast (), PROT_NUMBER);
 }
 
+void
+ArpL3Protocol::SendUnicastArpRequest (Ptr<const ArpCache> cache, Ipv4Address to, Address toMac)
+{
+  NS_LOG_FUNCTION (this << cache << to << toMac);
+  ArpHeader arp;
+  Ptr<Ipv4L3Protocol> ipv4 = m_node->GetObject<Ipv4L3Protocol> ();
+  Ptr<NetDevice> device = cache->GetDevice ();
+  NS_ASSERT (device != 0);
+  Ipv4Address source = ipv4->SelectSourceAddress (device,  to, Ipv4InterfaceAddress::GLOBAL);
+  NS_LOG_LOGIC ("ARP: sending unicast request from node "<<m_node->GetId ()<<
+                " || src: " << device->GetAddress () << " / " << source <<
+                " || dst: " << toMac << " / " << to);
+  arp.SetRequest (device->GetAddress (), source, toMac, to);
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (arp);
+  device->Send (packet, toMac, PROT_NUMBER);
+}
+
 void
 ArpL3Protocol::SendArpReply (Ptr<const ArpCache> cache, Ipv4Address myIp, Ipv4Address toIp, Address toMac)
 {
@@ -56,6 +56,21 @@ public:
   static TypeId GetTypeId (void);
   static const uint16_t PROT_NUMBER; //!< ARP protocol number (0x0806)
 
+  /**
+   * \brief How the entries of the ARP caches are created and maintained
+   *
+   * In a mesh, a broadcast ARP request is flooded by every mesh point, so
+   * that the first packet to each destination waits for a network-wide
+   * exchange. The modes other than NORMAL avoid some of these requests.
+   */
+  enum Mode
+  {
+    NORMAL = 1,           //!< Entries resolved by broadcast requests and refreshed by broadcast requests once expired
+    CREATION_ONLY = 2,    //!< Entries resolved by broadcast requests, then permanent
+    MAINTENANCE_ONLY = 3, //!< Entries resolved by the resolve callback, without request, and refreshed by unicast requests once expired
+    PREINSTALLED = 4      //!< No request sent: only the permanent entries installed with ArpCache::AddPermanent are used
+  };
+
   ArpL3Protocol ();
   virtual ~ArpL3Protocol ();
 
@@ -108,6 +123,18 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Set the callback resolving an IPv4 address without ARP request,
+   * used in the MAINTENANCE_ONLY mode, e.g. from the knowledge of the mesh
+   * routing protocol.
+   *
+   * The callback returns an invalid Address if it cannot resolve the
+   * IPv4 address, in which case a broadcast request is sent.
+   *
+   * \param resolve the callback
+   */
+  void SetResolveCallback (Callback<Address, Ipv4Address> resolve);
+
 protected:
   virtual void DoDispose (void);
   /*
@@ -146,6 +173,14 @@ private:
    * \param to the destination IP
    */
   void SendArpRequest (Ptr<const ArpCache>cache, Ipv4Address to);
+  /**
+   * \brief Send an ARP request to the MAC address already known for an
+   * host, to check that the address is still valid
+   * \param cache the ARP cache to use
+   * \param to the destination IP
+   * \param toMac the destination MAC address
+   */
+  void SendUnicastArpRequest (Ptr<const ArpCache> cache, Ipv4Address to, Address toMac);
   /**
    * \brief Send an ARP reply to an host
    * \param cache the ARP cache to use
@@ -159,6 +194,8 @@ private:
   Ptr<Node> m_node; //!< node the ARP L3 protocol is associated with
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by ARP
   Ptr<RandomVariableStream> m_requestJitter; //!< jitter to de-sync ARP requests
+  Mode m_mode; //!< how the entries are created and maintained
+  Callback<Address, Ipv4Address> m_resolveCallback; //!< resolution without request (MAINTENANCE_ONLY)
 
 };
 
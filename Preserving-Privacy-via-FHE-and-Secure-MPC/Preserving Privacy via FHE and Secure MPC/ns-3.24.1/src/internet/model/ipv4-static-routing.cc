@@ -31,6 +31,7 @@
 #include "ns3/simulator.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/boolean.h"
 #include "ipv4-static-routing.h"
 #include "ipv4-routing-table-entry.h"
 
@@ -49,16 +50,87 @@ Ipv4StaticRouting::GetTypeId (void)
     .SetParent<Ipv4RoutingProtocol> ()
     .SetGroupName ("Internet")
     .AddConstructor<Ipv4StaticRouting> ()
+    .AddAttribute ("UseLookupTables",
+                   "Look the network routes up in a hash table per prefix length "
+                   "instead of scanning all of them. The route chosen is the same.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4StaticRouting::m_useLookupTables),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
+/**
+ * \param length a prefix length
+ * \return the mask of this prefix length
+ */
+static Ipv4Mask
+PrefixMask (uint16_t length)
+{
+  return Ipv4Mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+}
+
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_irregularMasks (0),
+    m_useLookupTables (false),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
 
+void
+Ipv4StaticRouting::AddRoute (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  m_networkRoutes.push_back (make_pair (route,metric));
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  uint16_t masklen = mask.GetPrefixLength ();
+  if (mask != PrefixMask (masklen))
+    {
+      m_irregularMasks++;
+      return;
+    }
+  m_lookupTables[masklen][route->GetDestNetwork ().CombineMask (mask)].push_back (make_pair (route,metric));
+}
+
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::EraseRoute (NetworkRoutesI it)
+{
+  NS_LOG_FUNCTION (this << it->first);
+  Ipv4RoutingTableEntry *route = it->first;
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  uint16_t masklen = mask.GetPrefixLength ();
+  if (mask != PrefixMask (masklen))
+    {
+      m_irregularMasks--;
+    }
+  else
+    {
+      LookupTables::iterator table = m_lookupTables.find (masklen);
+      NS_ASSERT (table != m_lookupTables.end ());
+      PrefixTable::iterator routes = table->second.find (route->GetDestNetwork ().CombineMask (mask));
+      NS_ASSERT (routes != table->second.end ());
+      for (PrefixRoutes::iterator i = routes->second.begin (); i != routes->second.end (); i++)
+        {
+          if (i->first == route)
+            {
+              routes->second.erase (i);
+              break;
+            }
+        }
+      if (routes->second.empty ())
+        {
+          table->second.erase (routes);
+        }
+      if (table->second.empty ())
+        {
+          m_lookupTables.erase (table);
+        }
+    }
+  delete route;
+  return m_networkRoutes.erase (it);
+}
+
 void 
 Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network, 
                                       Ipv4Mask networkMask, 
@@ -72,7 +144,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         nextHop,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddRoute (route, metric);
 }
 
 void 
@@ -86,7 +158,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddRoute (route, metric);
 }
 
 void 
@@ -143,7 +215,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         outputInterface);
-  m_networkRoutes.push_back (make_pair (route,0));
+  AddRoute (route, 0);
 }
 
 uint32_t 
@@ -239,6 +311,10 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
       return rtentry;
     }
 
+  if (m_useLookupTables && m_irregularMasks == 0)
+    {
+      return LookupTablesStatic (dest, oif);
+    }
 
   for (NetworkRoutesI i = m_networkRoutes.begin (); 
        i != m_networkRoutes.end (); 
@@ -277,13 +353,7 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
               continue;
             }
           shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+          rtentry = CreateRoute (j);
         }
     }
   if (rtentry != 0)
@@ -297,6 +367,58 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
   return rtentry;
 }
 
+Ptr<Ipv4Route>
+Ipv4StaticRouting::LookupTablesStatic (Ipv4Address dest, Ptr<NetDevice> oif)
+{
+  NS_LOG_FUNCTION (this << dest << " " << oif);
+  for (LookupTables::const_iterator table = m_lookupTables.begin ();
+       table != m_lookupTables.end ();
+       table++)
+    {
+      PrefixTable::const_iterator routes = table->second.find (dest.CombineMask (PrefixMask (table->first)));
+      if (routes == table->second.end ())
+        {
+          continue;
+        }
+      // The lowest metric, the route added last if several have it
+      Ipv4RoutingTableEntry *route = 0;
+      uint32_t shortest_metric = 0xffffffff;
+      for (PrefixRoutes::const_iterator i = routes->second.begin (); i != routes->second.end (); i++)
+        {
+          if (oif != 0 && oif != m_ipv4->GetNetDevice (i->first->GetInterface ()))
+            {
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
+            }
+          if (i->second > shortest_metric)
+            {
+              continue;
+            }
+          shortest_metric = i->second;
+          route = i->first;
+        }
+      if (route != 0)
+        {
+          NS_LOG_LOGIC ("Matching route via " << route->GetGateway () << ", mask length " << table->first);
+          return CreateRoute (route);
+        }
+    }
+  NS_LOG_LOGIC ("No matching route to " << dest << " found");
+  return 0;
+}
+
+Ptr<Ipv4Route>
+Ipv4StaticRouting::CreateRoute (Ipv4RoutingTableEntry *route)
+{
+  uint32_t interfaceIdx = route->GetInterface ();
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (route->GetDest ());
+  rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
+  rtentry->SetGateway (route->GetGateway ());
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+  return rtentry;
+}
+
 Ptr<Ipv4MulticastRoute>
 Ipv4StaticRouting::LookupStatic (
   Ipv4Address origin, 
@@ -443,8 +565,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete j->first;
-          m_networkRoutes.erase (j);
+          EraseRoute (j);
           return;
         }
       tmp++;
@@ -593,6 +714,8 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_lookupTables.clear ();
+  m_irregularMasks = 0;
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -631,8 +754,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseRoute (it);
         }
       else
         {
@@ -678,8 +800,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkMask () == networkMask)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseRoute (it);
         }
       else
         {
@@ -23,9 +23,13 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include <list>
+#include <map>
+#include <vector>
+#include <functional>
 #include <utility>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/socket.h"
 #include "ns3/ptr.h"
@@ -62,6 +66,11 @@ class Node;
  * Ipv4RoutingProtocol that defines the interface methods that a routing 
  * protocol must support.
  *
+ * The network routes are looked up by scanning all of them, or, with the
+ * UseLookupTables attribute, in a hash table per prefix length, from the
+ * longest prefix to the shortest one. Both lookups choose the same route:
+ * the longest prefix, then the lowest metric, then the route added last.
+ *
  * \see Ipv4RoutingProtocol
  * \see Ipv4ListRouting
  * \see Ipv4ListRouting::AddRoutingProtocol
@@ -399,6 +408,45 @@ private:
   /// Iterator for container for the multicast routes
   typedef std::list<Ipv4MulticastRoutingTableEntry *>::iterator MulticastRoutesI;
 
+  /// Routes to the same network, in the order of the network routes
+  typedef std::vector<std::pair <Ipv4RoutingTableEntry *, uint32_t> > PrefixRoutes;
+
+  /// Routes of a prefix length, by network
+  typedef sgi::hash_map<Ipv4Address, PrefixRoutes, Ipv4AddressHash> PrefixTable;
+
+  /// Tables of the prefix lengths in use, the longest prefix first
+  typedef std::map<uint16_t, PrefixTable, std::greater<uint16_t> > LookupTables;
+
+  /**
+   * \brief Add a network route to the forwarding table and to the lookup tables.
+   * \param route the route, owned by the forwarding table
+   * \param metric metric of the route
+   */
+  void AddRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Remove a network route from the forwarding table and from the
+   * lookup tables, and delete it.
+   * \param it the route
+   * \return the route following it
+   */
+  NetworkRoutesI EraseRoute (NetworkRoutesI it);
+
+  /**
+   * \brief Lookup in the lookup tables for destination.
+   * \param dest destination address
+   * \param oif output interface if any (put 0 otherwise)
+   * \return Ipv4Route to route the packet to reach dest address
+   */
+  Ptr<Ipv4Route> LookupTablesStatic (Ipv4Address dest, Ptr<NetDevice> oif);
+
+  /**
+   * \brief Create the Ipv4Route of a network route.
+   * \param route the network route
+   * \return Ipv4Route to route the packet on this network route
+   */
+  Ptr<Ipv4Route> CreateRoute (Ipv4RoutingTableEntry *route);
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -430,6 +478,22 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes, by prefix length and network.
+   */
+  LookupTables m_lookupTables;
+
+  /**
+   * \brief number of network routes whose mask is not a prefix, which are
+   * not in the lookup tables: the lookups scan the forwarding table then.
+   */
+  uint32_t m_irregularMasks;
+
+  /**
+   * \brief look the routes up in the lookup tables.
+   */
+  bool m_useLookupTables;
+
   /**
    * \brief the forwarding table for multicast.
    */
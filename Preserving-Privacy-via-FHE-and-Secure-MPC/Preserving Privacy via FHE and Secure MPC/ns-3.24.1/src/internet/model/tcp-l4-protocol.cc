@@ -168,6 +168,7 @@ TcpL4Protocol::DoDispose (void)
   m_node = 0;
   m_downTarget.Nullify ();
   m_downTarget6.Nullify ();
+  m_pathErrorCallback.Nullify ();
   IpL4Protocol::DoDispose ();
 }
 
@@ -706,6 +707,34 @@ TcpL4Protocol::RemoveSocket (Ptr<TcpSocketBase> socket)
   return false;
 }
 
+void
+TcpL4Protocol::SetPathErrorCallback (Callback<bool, Time, Time> cb)
+{
+  m_pathErrorCallback = cb;
+}
+
+bool
+TcpL4Protocol::CheckPathError (Time begin, Time end) const
+{
+  if (m_pathErrorCallback.IsNull ())
+    {
+      return false;
+    }
+  return m_pathErrorCallback (begin, end);
+}
+
+void
+TcpL4Protocol::NotifyPathRepaired (const Address &destination)
+{
+  NS_LOG_FUNCTION (this << destination);
+  // A retransmission may close a socket, which removes it from m_sockets
+  std::vector<Ptr<TcpSocketBase> > sockets = m_sockets;
+  for (std::vector<Ptr<TcpSocketBase> >::iterator it = sockets.begin (); it != sockets.end (); ++it)
+    {
+      (*it)->PathRepaired (destination);
+    }
+}
+
 void
 TcpL4Protocol::SetDownTarget (IpL4Protocol::DownTargetCallback callback)
 {
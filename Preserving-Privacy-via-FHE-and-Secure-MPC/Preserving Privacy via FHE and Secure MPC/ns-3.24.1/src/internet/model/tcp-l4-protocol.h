@@ -26,6 +26,8 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/sequence-number.h"
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
 #include "ip-l4-protocol.h"
 
 
@@ -199,6 +201,35 @@ public:
    */
   bool RemoveSocket (Ptr<TcpSocketBase> socket);
 
+  /**
+   * \brief Set the callback telling whether the link layer reported a path
+   * error in a window of time, used by the sockets with PeaRto enabled
+   *
+   * \param cb the callback, called with the start and the end of the window
+   */
+  void SetPathErrorCallback (Callback<bool, Time, Time> cb);
+
+  /**
+   * \brief Check whether the link layer reported a path error in a window
+   *
+   * \param begin the start of the window
+   * \param end the end of the window
+   * \return true if a path error was reported, false if there was none or
+   *         if no path error callback is set
+   */
+  bool CheckPathError (Time begin, Time end) const;
+
+  /**
+   * \brief Notify the sockets that the link layer repaired a path
+   *
+   * The sockets to the destination whose RTO backoff was frozen by a path
+   * error retransmit their oldest unacknowledged segment.
+   *
+   * \param destination the link layer address of the destination of the
+   *        path, matched against the ARP entries of the peers of the sockets
+   */
+  void NotifyPathRepaired (const Address &destination);
+
   /**
    * \brief Remove an IPv4 Endpoint.
    * \param endPoint the end point to remove
@@ -286,6 +317,7 @@ private:
   std::vector<Ptr<TcpSocketBase> > m_sockets;      //!< list of sockets
   IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
   IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
+  Callback<bool, Time, Time> m_pathErrorCallback;   //!< Path errors of the link layer
 
   /**
    * \brief Copy constructor
@@ -52,7 +52,7 @@ TcpRxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpRxBuffer::TcpRxBuffer (uint32_t n)
-  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0)
+  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0), m_availSeq (n)
 {
 }
 
@@ -60,6 +60,11 @@ TcpRxBuffer::~TcpRxBuffer ()
 {
 }
 
+TcpRxBuffer::Block::Block ()
+  : size (0)
+{
+}
+
 SequenceNumber32
 TcpRxBuffer::NextRxSequence (void) const
 {
@@ -114,8 +119,12 @@ TcpRxBuffer::MaxRxSequence (void) const
     { // No data allowed beyond FIN
       return m_finSeq;
     }
-  else if (m_data.size ())
+  else if (m_availBytes > 0)
     { // No data allowed beyond Rx window allowed
+      return m_availSeq + SequenceNumber32 (m_maxBuffer);
+    }
+  else if (m_data.size ())
+    {
       return m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
     }
   return m_nextRxSeq + SequenceNumber32 (m_maxBuffer);
@@ -143,74 +152,81 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_FUNCTION (this << p << tcph);
 
   uint32_t pktSize = p->GetSize ();
-  SequenceNumber32 headSeq = tcph.GetSequenceNumber ();
+  SequenceNumber32 pktSeq = tcph.GetSequenceNumber ();
+  SequenceNumber32 headSeq = pktSeq;
   SequenceNumber32 tailSeq = headSeq + SequenceNumber32 (pktSize);
   NS_LOG_LOGIC ("Add pkt " << p << " len=" << pktSize << " seq=" << headSeq
                            << ", when NextRxSeq=" << m_nextRxSeq << ", buffsize=" << m_size);
 
   // Trim packet to fit Rx window specification
   if (headSeq < m_nextRxSeq) headSeq = m_nextRxSeq;
-  if (m_data.size ())
+  if (m_size)
     {
-      SequenceNumber32 maxSeq = m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      SequenceNumber32 maxSeq = (m_availBytes ? m_availSeq : m_data.begin ()->first) + SequenceNumber32 (m_maxBuffer);
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
+  // Find the block the packet follows or overlaps, the bytes it already
+  // holds are not stored again
+  BufIterator next = m_data.upper_bound (headSeq);
+  bool inOrder = (headSeq == m_nextRxSeq);
+  Block *block = 0; // Stays 0 if the packet is appended to the available data
+  SequenceNumber32 cursor = headSeq;
+  if (!inOrder && next != m_data.begin ())
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
+      BufIterator prev = next;
+      --prev;
+      SequenceNumber32 prevEnd = prev->first + SequenceNumber32 (prev->second.size);
+      if (prevEnd >= headSeq)
         {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
+          block = &prev->second;
+          cursor = prevEnd;
         }
-      ++i;
     }
-  // We now know how much we are going to store, trim the packet
-  if (headSeq >= tailSeq)
+  if (cursor >= tailSeq)
     {
       NS_LOG_LOGIC ("Nothing to buffer");
       return false; // Nothing to buffer anyway
     }
-  else
+  if (inOrder && m_availBytes == 0)
     {
-      uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
-      p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
+      m_availSeq = m_nextRxSeq;
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  else if (!inOrder && block == 0)
+    {
+      block = &m_data.insert (next, std::make_pair (headSeq, Block ()))->second;
+    }
+  // Fill the holes up to the tail of the packet, merging the blocks which
+  // follow them into this block
+  uint32_t added = 0;
+  while (next != m_data.end () && next->first <= tailSeq)
     {
-      if (i->first < m_nextRxSeq)
+      uint32_t length = next->first - cursor;
+      if (length > 0)
         {
-          continue;
+          Append (block, p->CreateFragment (cursor - pktSeq, length));
+          added += length;
         }
-      else if (i->first > m_nextRxSeq)
+      for (std::vector<Ptr<Packet> >::const_iterator i = next->second.data.begin (); i != next->second.data.end (); ++i)
         {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+          Append (block, *i);
+        }
+      cursor = next->first + SequenceNumber32 (next->second.size);
+      m_data.erase (next++);
+    }
+  if (cursor < tailSeq)
+    {
+      uint32_t length = tailSeq - cursor;
+      // Most segments are stored whole
+      Append (block, length == pktSize ? p : p->CreateFragment (cursor - pktSeq, length));
+      added += length;
+    }
+  NS_LOG_LOGIC ("Buffered " << added << " bytes of seqno=" << headSeq);
+  // Update variables
+  m_size += added;      // Occupancy
+  if (inOrder)
+    {
+      m_nextRxSeq = m_availSeq + SequenceNumber32 (m_availBytes);
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -228,41 +244,53 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   uint32_t extractSize = std::min (maxSize, m_availBytes);
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
-  NS_ASSERT (m_data.size ()); // At least we have something to extract
   Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
-  while (extractSize)
+  uint32_t left = extractSize;
+  while (left)
     { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
-      // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
-      if (pktSize <= extractSize)
+      NS_ASSERT (m_available.size ()); // At least we have something to extract
+      Ptr<Packet> pkt = m_available.front ();
+      uint32_t pktSize = pkt->GetSize ();
+      if (pktSize <= left)
         { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
-          extractSize -= pktSize;
+          outPkt->AddAtEnd (pkt);
+          m_available.pop_front ();
+          left -= pktSize;
         }
       else
         { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
-          extractSize = 0;
+          outPkt->AddAtEnd (pkt->CreateFragment (0, left));
+          m_available.front () = pkt->CreateFragment (left, pktSize - left);
+          left = 0;
         }
     }
-  if (outPkt->GetSize () == 0)
-    {
-      NS_LOG_LOGIC ("Nothing extracted.");
-      return 0;
-    }
+  m_availSeq += extractSize;
+  m_size -= extractSize;
+  m_availBytes -= extractSize;
   NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
-                             << ", num pkts in buffer=" << m_data.size ());
+                             << ", num blocks in buffer=" << GetBlockCount ());
   return outPkt;
 }
 
+void
+TcpRxBuffer::Append (Block *block, Ptr<Packet> p)
+{
+  if (block == 0)
+    {
+      m_available.push_back (p);
+      m_availBytes += p->GetSize ();
+    }
+  else
+    {
+      block->data.push_back (p);
+      block->size += p->GetSize ();
+    }
+}
+
+uint32_t
+TcpRxBuffer::GetBlockCount (void) const
+{
+  return m_data.size () + (m_availBytes > 0 ? 1 : 0);
+}
+
 } //namepsace ns3
@@ -22,6 +22,8 @@
 #define TCP_RX_BUFFER_H
 
 #include <map>
+#include <deque>
+#include <vector>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
@@ -36,6 +38,14 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * The data is kept as blocks of contiguous bytes: the block available to
+ * the application, which ends at NextRxSequence, and the blocks received
+ * out of order, keyed by the sequence number of their first byte. A segment
+ * only fills the holes between the blocks it overlaps, which are merged
+ * with it, so that the buffer holds one block per hole in the sequence
+ * space rather than one entry per segment. Segments received in order are
+ * appended to the available block without any lookup.
  */
 class TcpRxBuffer : public Object
 {
@@ -124,16 +134,39 @@ public:
    * \returns a packet
    */
   Ptr<Packet> Extract (uint32_t maxSize);
+
+  /**
+   * \brief Get the number of blocks of contiguous bytes in the buffer
+   * \returns the number of blocks, i.e. the holes in the buffered data, plus
+   *          one if data is available
+   */
+  uint32_t GetBlockCount (void) const;
 public:
+  /// A run of contiguous bytes received out of order
+  struct Block
+  {
+    Block ();
+    uint32_t size;                  //!< Number of bytes
+    std::vector<Ptr<Packet> > data; //!< The packets holding the bytes, in sequence order
+  };
+  /**
+   * \brief Append bytes to a block received out of order, or to the data
+   *        available to read
+   * \param block the block, or 0 for the data available to read
+   * \param p the packet holding the bytes
+   */
+  void Append (Block *block, Ptr<Packet> p);
   /// container for data stored in the buffer
-  typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  typedef std::map<SequenceNumber32, Block>::iterator BufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  SequenceNumber32 m_availSeq;               //!< Seqnum of the first byte available to read
+  std::deque<Ptr<Packet> > m_available;     //!< Data available to read, in sequence order
+  std::map<SequenceNumber32, Block> m_data; //!< Data received out of order, by sequence number of the first byte
 };
 
 } //namepsace ns3
@@ -33,6 +33,9 @@
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv6-route.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
 #include "ns3/ipv6-routing-protocol.h"
 #include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
@@ -96,6 +99,13 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("PeaRto",
+                   "Enable or disable the path error aware RTO: the RTO backoff is "
+                   "frozen when the link layer reported a path error within the RTO, "
+                   "and the lost segment is retransmitted once the path is repaired",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_peaRto),
+                   MakeBooleanChecker ())
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms. See http://www.postel.org/pipermail/end2end-interest/2004-November/004402.html
@@ -190,7 +200,10 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndScaleFactor (0),
     m_rcvScaleFactor (0),
     m_timestampEnabled (true),
-    m_timestampToEcho (0)
+    m_timestampToEcho (0),
+    m_peaRto (false),
+    m_peaFrozen (false),
+    m_peaSpent (false)
 
 {
   NS_LOG_FUNCTION (this);
@@ -237,7 +250,10 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndScaleFactor (sock.m_sndScaleFactor),
     m_rcvScaleFactor (sock.m_rcvScaleFactor),
     m_timestampEnabled (sock.m_timestampEnabled),
-    m_timestampToEcho (sock.m_timestampToEcho)
+    m_timestampToEcho (sock.m_timestampToEcho),
+    m_peaRto (sock.m_peaRto),
+    m_peaFrozen (false),
+    m_peaSpent (false)
 
 {
   NS_LOG_FUNCTION (this);
@@ -1976,9 +1992,12 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   if (m_retxEvent.IsExpired () )
     {
-      // RFC 6298, clause 2.5
-      Time doubledRto = m_rto + m_rto;
-      m_rto = Min (doubledRto, Time::FromDouble (60,  Time::S));
+      // RFC 6298, clause 2.5, unless the timeout was caused by a path error
+      if (!m_peaFrozen)
+        {
+          Time doubledRto = m_rto + m_rto;
+          m_rto = Min (doubledRto, Time::FromDouble (60,  Time::S));
+        }
 
       // Schedules retransmit
 
@@ -2253,6 +2272,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
                     (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
       m_retxEvent.Cancel ();
+      m_peaFrozen = false;
+      m_peaSpent = false;
       // On receiving a "New" ack we restart retransmission timer .. RFC 6298
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation ()*4), m_minRto);
@@ -2315,10 +2336,74 @@ TcpSocketBase::ReTxTimeout ()
     {
       return;
     }
+  // A segment lost on a broken mesh path is not a sign of congestion: keep
+  // the RTO for one more timeout, in which the path is likely repaired. If
+  // it is not, the loss has another cause and the backoff resumes.
+  if (m_peaFrozen)
+    {
+      NS_LOG_LOGIC (this << " Path not repaired within the frozen RTO, backoff resumed");
+      m_peaFrozen = false;
+    }
+  else if (m_peaRto && !m_peaSpent
+           && m_tcp->CheckPathError (Simulator::Now () - m_rto.Get (), Simulator::Now ()))
+    {
+      NS_LOG_LOGIC (this << " Path error within the RTO, backoff frozen");
+      m_peaFrozen = true;
+      m_peaSpent = true;
+    }
 
   Retransmit ();
 }
 
+void
+TcpSocketBase::PathRepaired (const Address &destination)
+{
+  NS_LOG_FUNCTION (this << destination);
+  if (!m_peaFrozen || !PeerMapsTo (destination))
+    {
+      return;
+    }
+  if (m_state != CLOSED && m_state != TIME_WAIT
+      && (m_state > ESTABLISHED || m_txBuffer->HeadSequence () < m_highTxMark))
+    {
+      NS_LOG_LOGIC (this << " Path repaired, retransmitting seq " << m_txBuffer->HeadSequence ());
+      // The timer is restarted by DoRetransmit with the frozen RTO
+      m_retxEvent.Cancel ();
+      DoRetransmit ();
+    }
+  m_peaFrozen = false;
+  m_peaSpent = false;
+}
+
+bool
+TcpSocketBase::PeerMapsTo (const Address &linkAddress) const
+{
+  if (m_endPoint == 0)
+    {
+      return false;
+    }
+  Ptr<Ipv4L3Protocol> ipv4 = m_node->GetObject<Ipv4L3Protocol> ();
+  if (ipv4 == 0)
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+    {
+      Ptr<ArpCache> cache = ipv4->GetInterface (i)->GetArpCache ();
+      if (cache == 0)
+        {
+          continue;
+        }
+      ArpCache::Entry *entry = cache->Lookup (m_endPoint->GetPeerAddress ());
+      if (entry != 0 && (entry->IsAlive () || entry->IsPermanent ())
+          && entry->GetMacAddress () == linkAddress)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 void
 TcpSocketBase::DelAckTimeout (void)
 {
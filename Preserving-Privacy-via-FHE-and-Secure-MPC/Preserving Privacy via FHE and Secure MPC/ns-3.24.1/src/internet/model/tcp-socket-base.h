@@ -166,6 +166,18 @@ public:
    */
   Ptr<TcpRxBuffer> GetRxBuffer (void) const;
 
+  /**
+   * \brief Notify the socket that the link layer repaired a path (PeaRto)
+   *
+   * If the path leads to the peer of the socket and the RTO backoff of the
+   * socket is frozen because of a path error, the oldest unacknowledged
+   * segment is retransmitted at once instead of waiting for the
+   * retransmission timer.
+   *
+   * \param destination the link layer address of the destination of the path
+   */
+  void PathRepaired (const Address &destination);
+
 
   // Necessary implementations of null functions from ns3::Socket
   virtual enum SocketErrno GetErrno (void) const;    // returns m_errno
@@ -594,6 +606,14 @@ protected:
    */
   virtual void Retransmit (void);
 
+  /**
+   * \brief Check whether the peer of the socket is reached at a link layer address
+   *
+   * \param linkAddress the link layer address
+   * \return true if an ARP entry of the node maps the peer to the address
+   */
+  bool PeerMapsTo (const Address &linkAddress) const;
+
   /**
    * \brief Action upon delay ACK timeout, i.e. send an ACK
    */
@@ -773,6 +793,10 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool     m_peaRto;              //!< Path error aware RTO enabled
+  bool     m_peaFrozen;           //!< RTO backoff frozen by a path error
+  bool     m_peaSpent;            //!< RTO backoff already frozen since the last new ACK or repair
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 };
 
@@ -57,7 +57,7 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_headOffset (0), m_cursor (0)
 {
 }
 
@@ -111,7 +111,10 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          Chunk chunk;
+          chunk.offset = m_headOffset + m_size;
+          chunk.data = p;
+          m_data.push_back (chunk);
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -133,6 +136,45 @@ TcpTxBuffer::SizeFromSequence (const SequenceNumber32& seq) const
   return lastSeq - seq;
 }
 
+uint32_t
+TcpTxBuffer::FindChunk (uint64_t offset)
+{
+  NS_ASSERT (offset >= m_headOffset && offset < m_headOffset + m_size);
+  // Segments are mostly sent in order: try where the last copy ended first
+  if (m_cursor < m_data.size ())
+    {
+      const Chunk &chunk = m_data[m_cursor];
+      if (chunk.offset <= offset && offset < chunk.offset + chunk.data->GetSize ())
+        {
+          return m_cursor;
+        }
+      if (m_cursor + 1 < m_data.size ())
+        {
+          const Chunk &next = m_data[m_cursor + 1];
+          if (next.offset <= offset && offset < next.offset + next.data->GetSize ())
+            {
+              return m_cursor + 1;
+            }
+        }
+    }
+  // Last chunk whose first byte is at or before the offset
+  uint32_t low = 0;
+  uint32_t high = m_data.size () - 1;
+  while (low < high)
+    {
+      uint32_t middle = low + (high - low + 1) / 2;
+      if (m_data[middle].offset <= offset)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle - 1;
+        }
+    }
+  return low;
+}
+
 Ptr<Packet>
 TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 {
@@ -148,55 +190,37 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     }
 
   // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
+  uint64_t offset = m_headOffset + (seq - m_firstByteSeq.Get ());
+  uint32_t i = FindChunk (offset);
+  NS_LOG_LOGIC ("First byte found in chunk #" << i << " of " << m_data.size ());
   Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  uint32_t left = s;
+  while (true)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
+      const Chunk &chunk = m_data[i];
+      uint32_t packetOffset = offset - chunk.offset;
+      uint32_t fragmentLength = std::min (left, chunk.data->GetSize () - packetOffset);
+      if (outPacket == 0)
+        { // The buffered packets are not modified
+          outPacket = chunk.data->CreateFragment (packetOffset, fragmentLength);
         }
-      else if (count + pktSize >= offset + s)
-        { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
+      else if (fragmentLength == chunk.data->GetSize ())
+        {
+          outPacket->AddAtEnd (chunk.data);
         }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (chunk.data->CreateFragment (0, fragmentLength));
+        }
+      left -= fragmentLength;
+      offset += fragmentLength;
+      if (left == 0)
+        {
+          break;
         }
-      count += pktSize;
+      i++;
     }
+  m_cursor = i;
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
 }
@@ -217,31 +241,19 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
+  // Drop the chunks which are fully acknowledged, the first chunk left may
+  // be partly acknowledged
+  uint32_t offset = std::min<uint32_t> (seq - m_firstByteSeq.Get (), m_size);  // Number of bytes to remove
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  m_headOffset += offset;
+  m_size -= offset;
+  m_firstByteSeq += offset;
+  while (!m_data.empty ()
+         && m_data.front ().offset + m_data.front ().data->GetSize () <= m_headOffset)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
-        }
+      NS_LOG_LOGIC ("Removed one packet of size " << m_data.front ().data->GetSize ());
+      m_data.pop_front ();
+      m_cursor = m_cursor > 0 ? m_cursor - 1 : 0;
     }
   // Catching the case of ACKing a FIN
   if (m_size == 0)
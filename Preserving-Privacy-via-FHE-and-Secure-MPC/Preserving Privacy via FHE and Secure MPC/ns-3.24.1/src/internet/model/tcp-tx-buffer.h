@@ -21,7 +21,7 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -36,6 +36,14 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets of the application are kept as chunks in a ring, each with the
+ * offset of its first byte in the stream. CopyFromSequence finds the chunk
+ * holding a sequence number with a binary search over these offsets, or
+ * directly when it follows the previous copy, which is the case of the
+ * segments sent in order. An acknowledgement only moves the head offset
+ * into the first chunk: the chunks are dropped once fully acknowledged and
+ * never fragmented.
  */
 class TcpTxBuffer : public Object
 {
@@ -128,13 +136,27 @@ public:
   void DiscardUpTo (const SequenceNumber32& seq);
 
 private:
+  /// A packet of the application, with the stream offset of its first byte
+  struct Chunk
+  {
+    uint64_t offset;  //!< Bytes added to the buffer before this chunk
+    Ptr<Packet> data; //!< The packet
+  };
   /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  typedef std::deque<Chunk> ChunkRing;
+
+  /**
+   * \param offset a stream offset, in [m_headOffset, m_headOffset + m_size)
+   * \return the index of the chunk holding the byte at the offset
+   */
+  uint32_t FindChunk (uint64_t offset);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint64_t m_headOffset;                        //!< Stream offset of the first byte in data
+  ChunkRing m_data;                             //!< Corresponding data, in stream order
+  uint32_t m_cursor;                            //!< Chunk where the last copy ended
 };
 
 } // namepsace ns3
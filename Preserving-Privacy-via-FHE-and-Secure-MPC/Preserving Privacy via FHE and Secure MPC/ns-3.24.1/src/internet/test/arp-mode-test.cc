@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/enum.h"
+#include "ns3/node.h"
+
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/arp-cache.h"
+#include "ns3/arp-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/ipv4-static-routing.h"
+
+#include <limits>
+
+namespace ns3 {
+
+static void
+AddInternetStack (Ptr<Node> node)
+{
+  //ARP
+  Ptr<ArpL3Protocol> arp = CreateObject<ArpL3Protocol> ();
+  node->AggregateObject (arp);
+  //IPV4
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  //Routing for Ipv4
+  Ptr<Ipv4StaticRouting> ipv4Routing = CreateObject<Ipv4StaticRouting> ();
+  ipv4->SetRoutingProtocol (ipv4Routing);
+  node->AggregateObject (ipv4);
+  node->AggregateObject (ipv4Routing);
+  //ICMP
+  Ptr<Icmpv4L4Protocol> icmp = CreateObject<Icmpv4L4Protocol> ();
+  node->AggregateObject (icmp);
+  //UDP
+  Ptr<UdpL4Protocol> udp = CreateObject<UdpL4Protocol> ();
+  node->AggregateObject (udp);
+}
+
+/**
+ * \brief Check the requests sent and the entries created by each mode of
+ * ArpL3Protocol, for packets sent from a node to its neighbour
+ */
+class ArpModeTestCase : public TestCase
+{
+public:
+  /**
+   * \param mode the mode of the sender
+   */
+  ArpModeTestCase (ArpL3Protocol::Mode mode);
+private:
+  virtual void DoRun (void);
+  /// \return a node with one interface on the channel
+  Ptr<Node> CreateNode (Ptr<SimpleChannel> channel, Ipv4Address address);
+  void SendData (Ptr<Socket> socket);
+  void ReceivePkt (Ptr<Socket> socket);
+  void ReceiveArp (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                   const Address &from, const Address &to, NetDevice::PacketType packetType);
+  /// The resolve callback of the sender, which knows the receiver
+  Address Resolve (Ipv4Address address);
+
+  ArpL3Protocol::Mode m_mode;
+  Ptr<NetDevice> m_rxDevice;
+  uint32_t m_received;         //!< data packets received
+  uint32_t m_broadcastRequests; //!< ARP requests received, broadcast
+  uint32_t m_unicastRequests;   //!< ARP requests received, sent to the MAC address of the receiver
+};
+
+ArpModeTestCase::ArpModeTestCase (ArpL3Protocol::Mode mode)
+  : TestCase ("Check the ARP requests of a mode"),
+    m_mode (mode),
+    m_received (0),
+    m_broadcastRequests (0),
+    m_unicastRequests (0)
+{
+}
+
+Ptr<Node>
+ArpModeTestCase::CreateNode (Ptr<SimpleChannel> channel, Ipv4Address address)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  AddInternetStack (node);
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  device->SetChannel (channel);
+  node->AddDevice (device);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  uint32_t netdev_idx = ipv4->AddInterface (device);
+  ipv4->AddAddress (netdev_idx, Ipv4InterfaceAddress (address, Ipv4Mask (0xffffff00U)));
+  ipv4->SetUp (netdev_idx);
+  return node;
+}
+
+void
+ArpModeTestCase::SendData (Ptr<Socket> socket)
+{
+  socket->SendTo (Create<Packet> (123), 0, InetSocketAddress (Ipv4Address ("10.0.0.2"), 1234));
+}
+
+void
+ArpModeTestCase::ReceivePkt (Ptr<Socket> socket)
+{
+  while (socket->Recv (std::numeric_limits<uint32_t>::max (), 0))
+    {
+      m_received++;
+    }
+}
+
+void
+ArpModeTestCase::ReceiveArp (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                             const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  ArpHeader arp;
+  p->Copy ()->RemoveHeader (arp);
+  if (!arp.IsRequest ())
+    {
+      return;
+    }
+  if (packetType == NetDevice::PACKET_BROADCAST)
+    {
+      m_broadcastRequests++;
+    }
+  else if (packetType == NetDevice::PACKET_HOST)
+    {
+      m_unicastRequests++;
+    }
+}
+
+Address
+ArpModeTestCase::Resolve (Ipv4Address address)
+{
+  if (address == Ipv4Address ("10.0.0.2"))
+    {
+      return m_rxDevice->GetAddress ();
+    }
+  return Address ();
+}
+
+void
+ArpModeTestCase::DoRun (void)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  Ptr<Node> txNode = CreateNode (channel, Ipv4Address ("10.0.0.1"));
+  Ptr<Node> rxNode = CreateNode (channel, Ipv4Address ("10.0.0.2"));
+  m_rxDevice = rxNode->GetDevice (1); // device 0 is the loopback
+  rxNode->RegisterProtocolHandler (MakeCallback (&ArpModeTestCase::ReceiveArp, this),
+                                   ArpL3Protocol::PROT_NUMBER, m_rxDevice, true);
+
+  Ptr<ArpL3Protocol> arp = txNode->GetObject<ArpL3Protocol> ();
+  arp->SetAttribute ("Mode", EnumValue (m_mode));
+  arp->SetResolveCallback (MakeCallback (&ArpModeTestCase::Resolve, this));
+  Ptr<ArpCache> cache = txNode->GetObject<Ipv4L3Protocol> ()->GetInterface (1)->GetArpCache ();
+  cache->SetAliveTimeout (Seconds (5));
+
+  Ptr<Socket> rxSocket = rxNode->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  rxSocket->Bind (InetSocketAddress (Ipv4Address ("10.0.0.2"), 1234));
+  rxSocket->SetRecvCallback (MakeCallback (&ArpModeTestCase::ReceivePkt, this));
+  Ptr<Socket> txSocket = txNode->GetObject<UdpSocketFactory> ()->CreateSocket ();
+
+  // A first packet, then another once an alive entry has expired
+  Simulator::Schedule (Seconds (1), &ArpModeTestCase::SendData, this, txSocket);
+  Simulator::Run ();
+  if (m_mode == ArpL3Protocol::PREINSTALLED)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received, 0, "No entry installed, the packet should be dropped");
+      cache->AddPermanent (Ipv4Address ("10.0.0.2"), m_rxDevice->GetAddress ());
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received, 1, "The first packet should be received");
+    }
+  Simulator::Schedule (Seconds (10), &ArpModeTestCase::SendData, this, txSocket);
+  Simulator::Run ();
+  uint32_t expected = (m_mode == ArpL3Protocol::PREINSTALLED) ? 1 : 2;
+  NS_TEST_ASSERT_MSG_EQ (m_received, expected, "The second packet should be received");
+
+  ArpCache::Entry *entry = cache->Lookup (Ipv4Address ("10.0.0.2"));
+  NS_TEST_ASSERT_MSG_NE (entry, 0, "The receiver should have an entry");
+  switch (m_mode)
+    {
+    case ArpL3Protocol::NORMAL:
+      NS_TEST_EXPECT_MSG_EQ (m_broadcastRequests, 2, "A broadcast request per packet expected");
+      NS_TEST_EXPECT_MSG_EQ (entry->IsAlive (), true, "Alive entry expected");
+      break;
+    case ArpL3Protocol::CREATION_ONLY:
+      NS_TEST_EXPECT_MSG_EQ (m_broadcastRequests, 1, "The permanent entry should not be refreshed");
+      NS_TEST_EXPECT_MSG_EQ (entry->IsPermanent (), true, "Permanent entry expected");
+      break;
+    case ArpL3Protocol::MAINTENANCE_ONLY:
+      NS_TEST_EXPECT_MSG_EQ (m_broadcastRequests, 0, "The resolve callback should be used");
+      NS_TEST_EXPECT_MSG_EQ (m_unicastRequests, 1, "The expired entry should be refreshed by unicast");
+      NS_TEST_EXPECT_MSG_EQ (entry->IsAlive (), true, "Alive entry expected");
+      break;
+    case ArpL3Protocol::PREINSTALLED:
+      NS_TEST_EXPECT_MSG_EQ (m_broadcastRequests + m_unicastRequests, 0, "No request expected");
+      NS_TEST_EXPECT_MSG_EQ (entry->IsPermanent (), true, "Permanent entry expected");
+      break;
+    }
+  NS_TEST_EXPECT_MSG_EQ (entry->GetMacAddress (), m_rxDevice->GetAddress (), "Wrong MAC address");
+
+  Simulator::Destroy ();
+}
+
+static class ArpModeTestSuite : public TestSuite
+{
+public:
+  ArpModeTestSuite ()
+    : TestSuite ("arp-mode", UNIT)
+  {
+    AddTestCase (new ArpModeTestCase (ArpL3Protocol::NORMAL), TestCase::QUICK);
+    AddTestCase (new ArpModeTestCase (ArpL3Protocol::CREATION_ONLY), TestCase::QUICK);
+    AddTestCase (new ArpModeTestCase (ArpL3Protocol::MAINTENANCE_ONLY), TestCase::QUICK);
+    AddTestCase (new ArpModeTestCase (ArpL3Protocol::PREINSTALLED), TestCase::QUICK);
+  }
+
+} g_arpModeTestSuite;
+
+} // namespace ns3
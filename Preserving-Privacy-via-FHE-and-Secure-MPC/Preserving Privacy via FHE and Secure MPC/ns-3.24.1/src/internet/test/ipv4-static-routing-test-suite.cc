@@ -35,6 +35,9 @@
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/socket-factory.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
 
 using namespace ns3;
 
@@ -179,6 +182,99 @@ Ipv4StaticRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Check that the routes found in the lookup tables are the routes
+ * found by scanning the network routes, with random routes of various
+ * prefix lengths and metrics, some removed.
+ */
+class Ipv4StaticRoutingLookupTablesTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingLookupTablesTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// Compare the two lookups for random destinations
+  void CheckLookups (Ptr<Ipv4> ipv4, Ptr<Ipv4StaticRouting> routing, Ptr<UniformRandomVariable> x);
+};
+
+Ipv4StaticRoutingLookupTablesTestCase::Ipv4StaticRoutingLookupTablesTestCase ()
+  : TestCase ("Lookup tables choose the same routes as the scan")
+{
+}
+
+void
+Ipv4StaticRoutingLookupTablesTestCase::CheckLookups (Ptr<Ipv4> ipv4, Ptr<Ipv4StaticRouting> routing, Ptr<UniformRandomVariable> x)
+{
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Ipv4Header header;
+      header.SetDestination (Ipv4Address (0x0a000000 | x->GetInteger (0, 3) << 16 | x->GetInteger (0, 3) << 8 | x->GetInteger (0, 7)));
+      Ptr<NetDevice> oif = 0;
+      if (x->GetInteger (0, 3) == 0)
+        {
+          oif = ipv4->GetNetDevice (x->GetInteger (1, 3));
+        }
+      Socket::SocketErrno sockerr;
+      routing->SetAttribute ("UseLookupTables", BooleanValue (false));
+      Ptr<Ipv4Route> scanned = routing->RouteOutput (Create<Packet> (), header, oif, sockerr);
+      routing->SetAttribute ("UseLookupTables", BooleanValue (true));
+      Ptr<Ipv4Route> looked = routing->RouteOutput (Create<Packet> (), header, oif, sockerr);
+      NS_TEST_ASSERT_MSG_EQ ((scanned == 0), (looked == 0), "Route found by one lookup only, to " << header.GetDestination ());
+      if (scanned != 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (looked->GetGateway (), scanned->GetGateway (), "Wrong gateway to " << header.GetDestination ());
+          NS_TEST_ASSERT_MSG_EQ (looked->GetOutputDevice (), scanned->GetOutputDevice (), "Wrong device to " << header.GetDestination ());
+        }
+    }
+}
+
+void
+Ipv4StaticRoutingLookupTablesTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  for (uint32_t i = 1; i <= 3; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t ifIndex = ipv4->AddInterface (device);
+      ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 | i << 8), Ipv4Mask ("/24")));
+      ipv4->SetUp (ifIndex);
+    }
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> routing = ipv4RoutingHelper.GetStaticRouting (ipv4);
+
+  // Routes to 10.0-3.0-3.0-7, several to the same networks
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetStream (1);
+  uint16_t lengths[] = { 0, 8, 14, 16, 22, 24, 29, 30, 32 };
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      Ipv4Address network (0x0a000000 | x->GetInteger (0, 3) << 16 | x->GetInteger (0, 3) << 8 | x->GetInteger (0, 7));
+      uint16_t length = lengths[x->GetInteger (0, 8)];
+      Ipv4Mask mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+      routing->AddNetworkRouteTo (network, mask, Ipv4Address (0xc0a80000 | x->GetInteger (1, 3) << 8 | x->GetInteger (2, 9)),
+                                  x->GetInteger (1, 3), x->GetInteger (0, 2));
+    }
+  CheckLookups (ipv4, routing, x);
+
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      routing->RemoveRoute (x->GetInteger (0, routing->GetNRoutes () - 1));
+    }
+  CheckLookups (ipv4, routing, x);
+
+  // A mask which is not a prefix: the lookups scan the routes
+  routing->AddNetworkRouteTo (Ipv4Address ("10.0.0.0"), Ipv4Mask ("255.0.255.0"), Ipv4Address ("192.168.1.2"), 1, 0);
+  CheckLookups (ipv4, routing, x);
+
+  Simulator::Destroy ();
+}
+
 class Ipv4StaticRoutingTestSuite : public TestSuite
 {
 public:
@@ -189,6 +285,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite ()
   : TestSuite ("ipv4-static-routing", UNIT)
 {
   AddTestCase (new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4StaticRoutingLookupTablesTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+
+namespace ns3 {
+
+/// \return a packet holding the bytes [begin, begin + size) of the stream
+static Ptr<Packet>
+StreamPacket (const std::vector<uint8_t> &stream, uint32_t begin, uint32_t size)
+{
+  return Create<Packet> (&stream[begin], size);
+}
+
+/// \return true if the packet holds the bytes [begin, begin + size) of the stream
+static bool
+HoldsStream (Ptr<Packet> p, const std::vector<uint8_t> &stream, uint32_t begin, uint32_t size)
+{
+  if (p->GetSize () != size)
+    {
+      return false;
+    }
+  std::vector<uint8_t> data (size + 1);
+  p->CopyData (&data[0], size);
+  return std::equal (data.begin (), data.begin () + size, stream.begin () + begin);
+}
+
+/**
+ * \brief Check the segments copied from TcpTxBuffer, sent in order and
+ * retransmitted, against the stream written by the application
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Check the segments copied from the Tx buffer")
+{
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetStream (1);
+  std::vector<uint8_t> stream (200000);
+  for (uint32_t i = 0; i < stream.size (); i++)
+    {
+      stream[i] = x->GetInteger (0, 255);
+    }
+
+  SequenceNumber32 isn (0xfffff000); // the sequence numbers wrap
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> ();
+  buffer->SetHeadSequence (isn);
+  buffer->SetMaxBufferSize (20000);
+  uint32_t written = 0;
+  uint32_t acked = 0;
+  uint32_t sent = 0;
+  while (acked < stream.size ())
+    {
+      // The application writes packets of various sizes
+      while (written < stream.size ())
+        {
+          uint32_t size = std::min<uint32_t> (x->GetInteger (1, 6000), stream.size () - written);
+          if (!buffer->Add (StreamPacket (stream, written, size)))
+            {
+              break;
+            }
+          written += size;
+        }
+      // Segments are sent in order, some are retransmitted
+      uint32_t segmentSize = x->GetInteger (1, 1500);
+      if (sent < written)
+        {
+          Ptr<Packet> p = buffer->CopyFromSequence (segmentSize, isn + SequenceNumber32 (sent));
+          uint32_t size = std::min (segmentSize, written - sent);
+          bool holds = HoldsStream (p, stream, sent, size);
+          NS_TEST_ASSERT_MSG_EQ (holds, true, "Wrong segment at " << sent);
+          sent += size;
+        }
+      if (sent > acked && x->GetInteger (0, 3) == 0)
+        {
+          uint32_t begin = x->GetInteger (acked, sent - 1);
+          Ptr<Packet> p = buffer->CopyFromSequence (segmentSize, isn + SequenceNumber32 (begin));
+          uint32_t size = std::min (segmentSize, written - begin);
+          bool holds = HoldsStream (p, stream, begin, size);
+          NS_TEST_ASSERT_MSG_EQ (holds, true, "Wrong retransmission at " << begin);
+        }
+      // Acks come in any amount
+      if (sent > acked && x->GetInteger (0, 1) == 0)
+        {
+          acked = x->GetInteger (acked + 1, sent);
+          buffer->DiscardUpTo (isn + SequenceNumber32 (acked));
+          NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), isn + SequenceNumber32 (acked), "Wrong head");
+          NS_TEST_ASSERT_MSG_EQ (buffer->Size (), written - acked, "Wrong size");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "The buffer should be empty");
+}
+
+/**
+ * \brief Check the data reassembled by TcpRxBuffer from segments received
+ * out of order, duplicated and overlapping
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("Check the data reassembled by the Rx buffer")
+{
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetStream (2);
+  std::vector<uint8_t> stream (200000);
+  for (uint32_t i = 0; i < stream.size (); i++)
+    {
+      stream[i] = x->GetInteger (0, 255);
+    }
+
+  SequenceNumber32 isn (0xfffff000); // the sequence numbers wrap
+  Ptr<TcpRxBuffer> buffer = CreateObject<TcpRxBuffer> ();
+  buffer->SetNextRxSequence (isn);
+  buffer->SetMaxBufferSize (30000);
+  uint32_t read = 0;
+  while (read < stream.size ())
+    {
+      // Segments anywhere in the window, which may overlap the data read
+      // or buffered and go beyond the window
+      uint32_t begin = x->GetInteger (read > 1000 ? read - 1000 : 0, read + 30000);
+      if (begin < stream.size ())
+        {
+          uint32_t size = std::min<uint32_t> (x->GetInteger (1, 3000), stream.size () - begin);
+          TcpHeader header;
+          header.SetSequenceNumber (isn + SequenceNumber32 (begin));
+          buffer->Add (StreamPacket (stream, begin, size), header);
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer->NextRxSequence (), isn + SequenceNumber32 (read + buffer->Available ()),
+                             "Wrong next sequence");
+      if (buffer->Available () > 0 && x->GetInteger (0, 3) == 0)
+        {
+          uint32_t size = x->GetInteger (1, 5000);
+          Ptr<Packet> p = buffer->Extract (size);
+          NS_TEST_ASSERT_MSG_NE (p, 0, "Data available but nothing extracted");
+          uint32_t extracted = p->GetSize ();
+          bool holds = HoldsStream (p, stream, read, extracted);
+          NS_TEST_ASSERT_MSG_EQ (holds, true, "Wrong data extracted at " << read);
+          read += extracted;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "The buffer should be empty");
+
+  // Holes are kept as separate blocks, and merged once filled
+  Ptr<TcpRxBuffer> holes = CreateObject<TcpRxBuffer> ();
+  holes->SetNextRxSequence (isn);
+  TcpHeader header;
+  header.SetSequenceNumber (isn + SequenceNumber32 (1000));
+  holes->Add (StreamPacket (stream, 1000, 500), header);
+  header.SetSequenceNumber (isn + SequenceNumber32 (2000));
+  holes->Add (StreamPacket (stream, 2000, 500), header);
+  NS_TEST_ASSERT_MSG_EQ (holes->GetBlockCount (), 2, "Two blocks expected");
+  NS_TEST_ASSERT_MSG_EQ (holes->Available (), 0, "Nothing available yet");
+  header.SetSequenceNumber (isn + SequenceNumber32 (0));
+  holes->Add (StreamPacket (stream, 0, 2200), header);
+  NS_TEST_ASSERT_MSG_EQ (holes->GetBlockCount (), 1, "The blocks should be merged");
+  NS_TEST_ASSERT_MSG_EQ (holes->Available (), 2500, "All the data should be available");
+  NS_TEST_ASSERT_MSG_EQ (holes->Size (), 2500, "Overlapping bytes should be stored once");
+  bool holds = HoldsStream (holes->Extract (3000), stream, 0, 2500);
+  NS_TEST_ASSERT_MSG_EQ (holds, true, "Wrong data extracted");
+}
+
+static class TcpBufferTestSuite : public TestSuite
+{
+public:
+  TcpBufferTestSuite ()
+    : TestSuite ("tcp-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase (), TestCase::QUICK);
+    AddTestCase (new TcpRxBufferTestCase (), TestCase::QUICK);
+  }
+
+} g_tcpBufferTestSuite;
+
+} // namespace ns3
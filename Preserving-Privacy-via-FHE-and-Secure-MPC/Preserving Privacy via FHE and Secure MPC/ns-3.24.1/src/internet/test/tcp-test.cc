@@ -36,6 +36,9 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/error-model.h"
 #include "ns3/log.h"
 
 #include "ns3/arp-l3-protocol.h"
@@ -45,6 +48,7 @@
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
 
 #include <string>
 
@@ -422,6 +426,207 @@ TcpTestCase::AddSimpleNetDevice6 (Ptr<Node> node, Ipv6Address ipaddr, Ipv6Prefix
   return dev;
 }
 
+/**
+ * \brief Check the PeaRto option of TcpSocketBase
+ *
+ * The path to the server is broken at 1s, when the source sends a segment,
+ * and the path error is reported at 1.5s. The RTO is 2s. A repair of the
+ * path to another node is notified at 3.5s, then the path to the server is
+ * repaired.
+ *
+ * With PeaRto, the first timeout, at 3s, freezes the RTO for one more
+ * timeout. If the path is repaired within it, at 4s, the segment must be
+ * retransmitted at the repair and the RTO must not back off. If it is not,
+ * the RTO backs off again from the second timeout, at 5s, and the segment
+ * is received at the third one, at 9s. Without PeaRto, the RTO doubles at
+ * every timeout and the segment is received at the third one, after 7s.
+ */
+class TcpPeaRtoTestCase : public TestCase
+{
+public:
+  /**
+   * \param peaRto whether PeaRto is enabled
+   * \param repair the time of the repair of the path to the server
+   */
+  TcpPeaRtoTestCase (bool peaRto, Time repair);
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  Ptr<SimpleNetDevice> CreateInternetNode (const char* ipaddr, Ptr<SimpleChannel> channel);
+  bool PathError (Time begin, Time end);
+  void BreakPath (void);
+  void RepairPath (Mac48Address destination);
+  void RtoChange (Time oldValue, Time newValue);
+  void ServerHandleConnectionCreated (Ptr<Socket> s, const Address & addr);
+  void ServerHandleRecv (Ptr<Socket> sock);
+
+  bool m_peaRto;
+  Time m_repair;
+  Mac48Address m_serverAddress;
+  Ptr<Socket> m_source;
+  Ptr<TcpL4Protocol> m_sourceTcp;
+  Ptr<RateErrorModel> m_serverErrors;
+  Time m_perrTime;
+  uint32_t m_backoffs;
+  Time m_rxTime;
+};
+
+TcpPeaRtoTestCase::TcpPeaRtoTestCase (bool peaRto, Time repair)
+  : TestCase (!peaRto ? "Check that the RTO backs off without PeaRto"
+              : repair < Seconds (5) ? "Check that a path error freezes the RTO (PeaRto)"
+              : "Check that the RTO backs off after one frozen RTO (PeaRto)"),
+    m_peaRto (peaRto),
+    m_repair (repair)
+{
+}
+
+void
+TcpPeaRtoTestCase::DoRun (void)
+{
+  const char* ipaddr0 = "192.168.1.1";
+  const char* ipaddr1 = "192.168.1.2";
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  Ptr<SimpleNetDevice> dev0 = CreateInternetNode (ipaddr0, channel);
+  Ptr<SimpleNetDevice> dev1 = CreateInternetNode (ipaddr1, channel);
+  Ptr<Node> node0 = dev0->GetNode ();
+  Ptr<Node> node1 = dev1->GetNode ();
+
+  m_serverAddress = Mac48Address::ConvertFrom (dev0->GetAddress ());
+  m_serverErrors = CreateObject<RateErrorModel> ();
+  m_serverErrors->SetAttribute ("ErrorRate", DoubleValue (1.0));
+  m_serverErrors->SetUnit (RateErrorModel::ERROR_UNIT_PACKET);
+  m_serverErrors->Disable ();
+  dev0->SetReceiveErrorModel (m_serverErrors);
+
+  m_sourceTcp = node1->GetObject<TcpL4Protocol> ();
+  m_sourceTcp->SetPathErrorCallback (MakeCallback (&TcpPeaRtoTestCase::PathError, this));
+
+  uint16_t port = 50000;
+  Ptr<Socket> server = node0->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr< Socket >, const Address &> (),
+                             MakeCallback (&TcpPeaRtoTestCase::ServerHandleConnectionCreated, this));
+
+  m_source = node1->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  m_source->SetAttribute ("PeaRto", BooleanValue (m_peaRto));
+  m_source->TraceConnectWithoutContext ("RTO", MakeCallback (&TcpPeaRtoTestCase::RtoChange, this));
+  m_source->Connect (InetSocketAddress (Ipv4Address (ipaddr0), port));
+
+  m_backoffs = 0;
+  m_rxTime = Seconds (0);
+  m_perrTime = Seconds (1.5);
+  Simulator::Schedule (Seconds (1), &TcpPeaRtoTestCase::BreakPath, this);
+  Simulator::Schedule (Seconds (3.5), &TcpPeaRtoTestCase::RepairPath, this,
+                       Mac48Address::ConvertFrom (Mac48Address::Allocate ()));
+  Simulator::Schedule (m_repair, &TcpPeaRtoTestCase::RepairPath, this, m_serverAddress);
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+
+  if (m_peaRto && m_repair < Seconds (5))
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_backoffs, 0, "The RTO should not back off after a path error");
+      NS_TEST_EXPECT_MSG_EQ (m_rxTime, m_repair, "The segment should be retransmitted at the repair of its path");
+    }
+  else if (m_peaRto)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_backoffs, 2, "The RTO should back off from the second timeout");
+      NS_TEST_EXPECT_MSG_GT (m_rxTime, Seconds (9), "The segment should be retransmitted at the third timeout");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_backoffs, 2, "The RTO should back off at every timeout");
+      NS_TEST_EXPECT_MSG_GT (m_rxTime, Seconds (7), "The segment should be retransmitted at the third timeout");
+    }
+}
+
+void
+TcpPeaRtoTestCase::DoTeardown (void)
+{
+  m_source = 0;
+  m_sourceTcp = 0;
+  m_serverErrors = 0;
+  Simulator::Destroy ();
+}
+
+Ptr<SimpleNetDevice>
+TcpPeaRtoTestCase::CreateInternetNode (const char* ipaddr, Ptr<SimpleChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<ArpL3Protocol> arp = CreateObject<ArpL3Protocol> ();
+  node->AggregateObject (arp);
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  Ptr<Ipv4ListRouting> ipv4Routing = CreateObject<Ipv4ListRouting> ();
+  ipv4->SetRoutingProtocol (ipv4Routing);
+  Ptr<Ipv4StaticRouting> ipv4staticRouting = CreateObject<Ipv4StaticRouting> ();
+  ipv4Routing->AddRoutingProtocol (ipv4staticRouting, 0);
+  node->AggregateObject (ipv4);
+  Ptr<Icmpv4L4Protocol> icmp = CreateObject<Icmpv4L4Protocol> ();
+  node->AggregateObject (icmp);
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+  node->AggregateObject (tcp);
+
+  Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+  dev->SetAddress (Mac48Address::ConvertFrom (Mac48Address::Allocate ()));
+  dev->SetChannel (channel);
+  node->AddDevice (dev);
+  uint32_t ndid = ipv4->AddInterface (dev);
+  ipv4->AddAddress (ndid, Ipv4InterfaceAddress (Ipv4Address (ipaddr), Ipv4Mask ("255.255.255.0")));
+  ipv4->SetUp (ndid);
+  return dev;
+}
+
+bool
+TcpPeaRtoTestCase::PathError (Time begin, Time end)
+{
+  return m_perrTime >= begin && m_perrTime <= end;
+}
+
+void
+TcpPeaRtoTestCase::BreakPath (void)
+{
+  m_serverErrors->Enable ();
+  m_source->Send (Create<Packet> (500));
+}
+
+void
+TcpPeaRtoTestCase::RepairPath (Mac48Address destination)
+{
+  if (destination == m_serverAddress)
+    {
+      m_serverErrors->Disable ();
+    }
+  m_sourceTcp->NotifyPathRepaired (destination);
+}
+
+void
+TcpPeaRtoTestCase::RtoChange (Time oldValue, Time newValue)
+{
+  if (Simulator::Now () > m_perrTime && newValue > oldValue)
+    {
+      m_backoffs++;
+    }
+}
+
+void
+TcpPeaRtoTestCase::ServerHandleConnectionCreated (Ptr<Socket> s, const Address & addr)
+{
+  s->SetRecvCallback (MakeCallback (&TcpPeaRtoTestCase::ServerHandleRecv, this));
+}
+
+void
+TcpPeaRtoTestCase::ServerHandleRecv (Ptr<Socket> sock)
+{
+  while (sock->Recv ())
+    {
+      if (m_rxTime.IsZero ())
+        {
+          m_rxTime = Simulator::Now ();
+        }
+    }
+}
+
 static class TcpTestSuite : public TestSuite
 {
 public:
@@ -439,6 +644,10 @@ public:
     AddTestCase (new TcpTestCase (13, 200, 200, 200, 200, true), TestCase::QUICK);
     AddTestCase (new TcpTestCase (13, 1, 1, 1, 1, true), TestCase::QUICK);
     AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20, true), TestCase::QUICK);
+
+    AddTestCase (new TcpPeaRtoTestCase (true, Seconds (4)), TestCase::QUICK);
+    AddTestCase (new TcpPeaRtoTestCase (true, Seconds (5.5)), TestCase::QUICK);
+    AddTestCase (new TcpPeaRtoTestCase (false, Seconds (5.5)), TestCase::QUICK);
   }
 
 } g_tcpTestSuite;
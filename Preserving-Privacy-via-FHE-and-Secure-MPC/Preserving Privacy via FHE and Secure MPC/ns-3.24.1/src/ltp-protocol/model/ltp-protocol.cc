@@ -279,8 +279,20 @@ uint32_t LtpProtocol::StartTransmission ( uint64_t sourceId,
                                           uint16_t fragmentSize,
                                           uint8_t operationType, uint32_t seqnum)
 {
+  return StartTransmission (sourceId, dstClientService, dstLtpEngine,
+                            CreateBlockPacket (data), fragmentSize,
+                            operationType, seqnum);
+}
+
+uint32_t LtpProtocol::StartTransmission ( uint64_t sourceId, 
+                                          uint64_t dstClientService,
+                                          uint64_t dstLtpEngine, 
+                                          Ptr<const Packet> data, 
+                                          uint16_t fragmentSize,
+                                          uint8_t operationType, uint32_t seqnum)
+{
 
-  NS_LOG_FUNCTION (this << dstClientService << dstLtpEngine << data.size() << seqnum );
+  NS_LOG_FUNCTION (this << dstClientService << dstLtpEngine << data->GetSize () << seqnum );
 
 
   Ptr<SenderSessionStateRecord> ssr = CreateObject<SenderSessionStateRecord> (m_localEngineId, sourceId, dstClientService, dstLtpEngine,m_randomSession,m_randomSerial);
@@ -1025,18 +1037,18 @@ void LtpProtocol::RetransmitSegment (SessionId id, RedSegmentInfo info)
 
   if (m_cpRtxLimit  > ssr->GetCpRtxNumber ())
     {
-      std::vector<uint8_t> rdData = ssr->GetBlockData ();
+      Ptr<Packet> rdData = CreateBlockPacket (ssr->GetBlockData ());
       uint32_t claimSz = 1;
 
       for (std::set<LtpContentHeader::ReceptionClaim>::iterator it = info.claims.begin (); it != info.claims.end (); ++it)
         {
           if (claimSz++ < info.claims.size ())
             {
-              EncapsulateBlockData (ssr->GetDestination (), ssr, rdData, rdData.size (), it->offset, it->length);
+              EncapsulateBlockData (ssr->GetDestination (), ssr, rdData, rdData->GetSize (), it->offset, it->length);
             }
           else
             {
-              EncapsulateBlockData (ssr->GetDestination (), ssr, rdData, rdData.size (), it->offset, it->length, info.RpserialNum);
+              EncapsulateBlockData (ssr->GetDestination (), ssr, rdData, rdData->GetSize (), it->offset, it->length, info.RpserialNum);
             }
         }
 
@@ -1156,7 +1168,7 @@ LtpProtocol::EnableLinkStateCues (Ptr<LtpConvergenceLayerAdapter> link)
 }
 
 Ptr<Packet> LtpProtocol::EncapsulateSegment (uint64_t dstClientService,  
-        SessionId id, std::vector<uint8_t> data, uint64_t offset, 
+        SessionId id, Ptr<const Packet> data, uint64_t offset, 
         uint64_t length, SegmentType type, uint32_t cpSerialNum, 
         uint32_t rpSerialNum, u_int8_t fragmentType, uint8_t fragmentID, 
         uint16_t fragmentSize, uint32_t seqNum){
@@ -1174,19 +1186,17 @@ Ptr<Packet> LtpProtocol::EncapsulateSegment (uint64_t dstClientService,
   NS_LOG_INFO("Fragment Type: " << uint32_t(fragmentType));
   NS_LOG_INFO("Fragment ID: " << uint32_t(fragmentID));
   NS_LOG_INFO("Fragment Size: " << uint32_t(fragmentSize));
-  NS_LOG_INFO("Real Data Size: " << data.size());
+  NS_LOG_INFO("Real Data Size: " << data->GetSize ());
   
   header.SetSmartMeterID(meterID);
   header.SetFragmentType(fragmentType);
   header.SetFragmentID(fragmentID);
   header.SetFragmentSize(fragmentSize);
 
-  /* Create packet of MTU size */
-  std::vector<uint8_t>::const_iterator start = data.begin(); //data.begin () + offset;
-  std::vector<uint8_t>::const_iterator end = data.end();//(offset + length > data.size ()) ? data.end () : data.begin () + offset + length;
-  std::vector<uint8_t> segmentData (start,end);
-
-  Ptr<Packet> packet = Create<Packet> ((uint8_t *) segmentData.data (),(uint32_t) segmentData.size ());
+  /* Create packet of MTU size, with a uid of its own, from the fragment
+     of the block: a zero-filled payload stays unallocated */
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddAtEnd (data);
   packet->AddHeader (seqTs);
   packet->AddHeader (header);
   
@@ -1197,7 +1207,7 @@ Ptr<Packet> LtpProtocol::EncapsulateSegment (uint64_t dstClientService,
 
 
 void
-LtpProtocol::EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRecord> ssr, std::vector<uint8_t> data, uint16_t frgSize, uint64_t claimOffset, uint64_t claimLength, uint32_t claimSerialNum, uint32_t seqNum)
+LtpProtocol::EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRecord> ssr, Ptr<const Packet> data, uint16_t frgSize, uint64_t claimOffset, uint64_t claimLength, uint32_t claimSerialNum, uint32_t seqNum)
 {
   NS_LOG_FUNCTION (this << dstClientService << ssr << frgSize << claimOffset << claimLength << claimSerialNum << seqNum);
 
@@ -1221,12 +1231,10 @@ LtpProtocol::EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRe
 //  
 ////////////////////////////////////////////////////////////////////////////////
   
-  std::vector<std::vector <uint8_t> > dataFragments;
-  
   SegmentType sType = SINGLE;
   uint8_t headersSize = 18;
   uint16_t pureFragmentSize = (uint16_t)(frgSize-(uint16_t)headersSize);   // 536 - 18 = 518 bytes
-  uint64_t dataSize = data.size();
+  uint64_t dataSize = data->GetSize ();
   uint16_t fragmentSize; 
   
   NS_LOG_INFO("Data size: " << dataSize);
@@ -1243,9 +1251,6 @@ LtpProtocol::EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRe
   if(numOfFragments > 1)
       sType = MULTIPLE;
   
-  for(uint8_t i=0; i<numOfFragments; i++)
-      dataFragments.push_back( std::vector < uint8_t > () );
-  
   //NS_LOG_INFO("# of Fragments: " << uint32_t(numOfFragments));
   
   int dataPosition = 0;
@@ -1253,12 +1258,12 @@ LtpProtocol::EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRe
   
   for(uint8_t i=0; i<numOfFragments; i++){
       if(numOfFragments == 1){
-          fragmentSize = data.size();
+          fragmentSize = data->GetSize ();
           blockSize = fragmentSize;
       }
       else{
           if(i == 0){
-              fragmentSize = data.size() + (numOfFragments*headersSize) - headersSize;
+              fragmentSize = data->GetSize () + (numOfFragments*headersSize) - headersSize;
               blockSize = pureFragmentSize;
           }
           else if(i == numOfFragments-1){
@@ -1280,15 +1285,13 @@ LtpProtocol::EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRe
 
       //////////////////////////////////////////////////////////////////////////
 
-      for(uint64_t j=0; j<blockSize; j++){
-          dataFragments[i].push_back(data[dataPosition]);
-          dataPosition++;
-      }
+      Ptr<Packet> fragment = data->CreateFragment (dataPosition, blockSize);
+      dataPosition += blockSize;
       
       //////////////////////////////////////////////////////////////////////////
       
       /* Create packet of MTU size */
-      Ptr<Packet> packet = EncapsulateSegment (dstClientService, id, dataFragments[i], 
+      Ptr<Packet> packet = EncapsulateSegment (dstClientService, id, fragment, 
                                                offset, length, sType, cpSerialNum, 
                                                rpSerialNum, sType, i, fragmentSize, 
                                                seqNum);
@@ -1300,6 +1303,19 @@ LtpProtocol::EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRe
 }
 
 
+Ptr<Packet>
+LtpProtocol::CreateBlockPacket (const std::vector<uint8_t> &data)
+{
+  for (std::vector<uint8_t>::const_iterator i = data.begin (); i != data.end (); ++i)
+    {
+      if (*i != 0)
+        {
+          return Create<Packet> (&data[0], data.size ());
+        }
+    }
+  return Create<Packet> (data.size ());
+}
+
 void
 LtpProtocol::SetEndOfBlockTransmission (SessionId id)
 {
@@ -209,6 +209,24 @@ public:
                                std::vector<uint8_t> data, uint16_t rdSize, 
                                uint8_t operationType, uint32_t seqnum);
 
+  /*
+   * \brief Request the transmission of a block of client service data
+   * held in a packet. The segments are fragments of the packet, so a
+   * zero-filled payload created with Create<Packet> (size) is never
+   * allocated. A block of zero bytes given as a vector to the method
+   * above is turned into such a payload.
+   * \param sourceClientService Source client service id.
+   * \param dstClientService Destination client service id.
+   * \param dstLtpEngine Destination LTP engine id.
+   * \param data Block of client service data to transmit
+   * \param rdSize Size of red part (data that needs to be sent in a reliable manner).
+   * \return Number of generated segments.
+   */
+  uint32_t StartTransmission ( uint64_t sourceClientService, 
+                               uint64_t dstClientService,uint64_t dstLtpEngine, 
+                               Ptr<const Packet> data, uint16_t rdSize, 
+                               uint8_t operationType, uint32_t seqnum);
+
   /*
    * \brief Requests the cancellation of a session.
    * As defined in RFC-5326 Section 4.2.
@@ -357,9 +375,16 @@ private:
    * \param rdSize Size of red part (data that needs to be sent in a reliable manner).
    * \param rtx called for a retransmission ( this flags is used internally).
    */
-  void EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRecord> ssr, std::vector<uint8_t> data, uint16_t rdSize, uint64_t claimOffset = 0, uint64_t claimLength = 0, uint32_t claimSerialNum = 0, uint32_t seqNum = 0);
+  void EncapsulateBlockData (uint64_t dstClientService, Ptr<SessionStateRecord> ssr, Ptr<const Packet> data, uint16_t rdSize, uint64_t claimOffset = 0, uint64_t claimLength = 0, uint32_t claimSerialNum = 0, uint32_t seqNum = 0);
   
-  Ptr<Packet> EncapsulateSegment (uint64_t dstClientService,  SessionId id, std::vector<uint8_t> data, uint64_t offset, uint64_t length, SegmentType type, uint32_t cpSerialNum, uint32_t rpSerialNum, u_int8_t fragmentType, uint8_t fragmentID, uint16_t fragmentSize, uint32_t seqNum);
+  Ptr<Packet> EncapsulateSegment (uint64_t dstClientService,  SessionId id, Ptr<const Packet> data, uint64_t offset, uint64_t length, SegmentType type, uint32_t cpSerialNum, uint32_t rpSerialNum, u_int8_t fragmentType, uint8_t fragmentID, uint16_t fragmentSize, uint32_t seqNum);
+
+  /*
+   * \param data a block of client service data
+   * \return a packet holding the block, with a zero-filled payload
+   * which is not allocated if the bytes of the block are all zero.
+   */
+  static Ptr<Packet> CreateBlockPacket (const std::vector<uint8_t> &data);
 
   /*
    * \brief Generate and enqueue a Report segment in response to a CP.
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Wall-clock time of the trace hookups of a mesh, with a Config::Connect
+// per node and trace source, and with one Config::Batch.
+//
+// Every mesh point of a grid gets the PHY and MAC trace sources of its
+// interfaces connected through "/NodeList/<i>/DeviceList/*/..." paths, as
+// the tracing code of the scenarios does. The mesh is built again for
+// each mode, and only the hookups are timed. The number of trace sources
+// connected is reported with the wall-clock time of each mode.
+//
+// ./waf --run "config-batch-benchmark --x-size=20 --y-size=20"
+
+#include <iostream>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+#include "ns3/mesh-helper.h"
+
+using namespace ns3;
+
+/// The trace sources connected on each node, under its WifiNetDevices
+static const char *SOURCES[] = {
+  "Phy/PhyTxBegin",
+  "Phy/PhyTxEnd",
+  "Phy/PhyRxBegin",
+  "Phy/PhyRxEnd",
+  "Phy/PhyRxDrop",
+  "Mac/MacTx",
+  "Mac/MacRx"
+};
+
+static uint32_t g_traced = 0;
+
+static void
+Trace (std::string context, Ptr<const Packet> p)
+{
+  g_traced++;
+}
+
+/// Create a grid of mesh points
+static NodeContainer
+CreateMesh (uint32_t xSize, uint32_t ySize, double step)
+{
+  NodeContainer nodes;
+  nodes.Create (xSize * ySize);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.Install (wifiPhy, nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (step),
+                                 "DeltaY", DoubleValue (step),
+                                 "GridWidth", UintegerValue (xSize),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  return nodes;
+}
+
+/// \return the path of a trace source of the interfaces of a node
+static std::string
+GetPath (Ptr<Node> node, uint32_t source)
+{
+  std::ostringstream oss;
+  oss << "/NodeList/" << node->GetId () << "/DeviceList/*/$ns3::WifiNetDevice/" << SOURCES[source];
+  return oss.str ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t xSize = 10;
+  uint32_t ySize = 10;
+  double step = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("x-size", "Number of mesh points in a row of the grid", xSize);
+  cmd.AddValue ("y-size", "Number of rows of the grid", ySize);
+  cmd.AddValue ("step", "Distance between the mesh points, meters", step);
+  cmd.Parse (argc, argv);
+
+  uint32_t nSources = sizeof (SOURCES) / sizeof (SOURCES[0]);
+  std::cout << "grid=" << xSize << "x" << ySize << " sources-per-node=" << nSources << std::endl;
+
+  // A Config::Connect per node and trace source
+  NodeContainer nodes = CreateMesh (xSize, ySize, step);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      for (uint32_t s = 0; s < nSources; s++)
+        {
+          Config::Connect (GetPath (nodes.Get (i), s), MakeCallback (&Trace));
+        }
+    }
+  int64_t single = clock.End ();
+  uint32_t connected = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      for (uint32_t s = 0; s < nSources; s++)
+        {
+          std::string path = GetPath (nodes.Get (i), s);
+          connected += Config::LookupMatches (path.substr (0, path.find_last_of ("/"))).GetN ();
+        }
+    }
+  Simulator::Destroy ();
+
+  // The same hookups in one Config::Batch
+  nodes = CreateMesh (xSize, ySize, step);
+  clock.Start ();
+  Config::Batch batch;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      for (uint32_t s = 0; s < nSources; s++)
+        {
+          batch.Connect (GetPath (nodes.Get (i), s), MakeCallback (&Trace));
+        }
+    }
+  uint32_t batched = batch.Apply ();
+  int64_t batchTime = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << "connect sources=" << connected << " wall-clock(ms)=" << single << std::endl
+            << "batch sources=" << batched << " wall-clock(ms)=" << batchTime << std::endl;
+  return connected != batched;
+}
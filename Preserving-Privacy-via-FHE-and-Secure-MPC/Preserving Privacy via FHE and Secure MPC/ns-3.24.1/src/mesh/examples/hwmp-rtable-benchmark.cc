@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Micro-benchmark of the table lookups HWMP does for every forwarded data
+// frame: the route to the destination in HwmpRtable and the last sequence
+// number of the source (HwmpProtocol::DropDataFrame). The sequence number
+// lookups are run both with Mac48AddressMap and with the std::map it
+// replaced.
+//
+// ./waf --run "hwmp-rtable-benchmark --Destinations=1000 --Frames=10000000"
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include "ns3/hwmp-rtable.h"
+#include "ns3/mac48-address-map.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/command-line.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+
+using namespace ns3;
+using namespace dot11s;
+
+/// \return the rate of an operation, per second
+static uint64_t
+Rate (uint64_t count, int64_t elapsed)
+{
+  return elapsed > 0 ? count * 1000 / elapsed : 0;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nDestinations = 1000;
+  uint32_t nFrames = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("Destinations", "The number of destinations in the tables", nDestinations);
+  cmd.AddValue ("Frames", "The number of forwarded frames", nFrames);
+  cmd.Parse (argc, argv);
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < nDestinations; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+    }
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<uint32_t> pattern;
+  for (uint32_t i = 0; i < 4096; i++)
+    {
+      pattern.push_back (random->GetInteger (0, nDestinations - 1));
+    }
+
+  Ptr<HwmpRtable> table = CreateObject<HwmpRtable> ();
+  for (uint32_t i = 0; i < nDestinations; i++)
+    {
+      table->AddReactivePath (addresses[i], addresses[(i + 1) % nDestinations], 1, 10, Seconds (1000), 1);
+      table->AddPrecursor (addresses[i], 1, addresses[(i + 2) % nDestinations], Seconds (1000));
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t found = 0;
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      found += table->LookupReactive (addresses[pattern[i % pattern.size ()]]).IsValid ();
+    }
+  int64_t routeElapsed = clock.End ();
+
+  Mac48AddressMap<uint32_t> seqnos;
+  clock.Start ();
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      uint32_t &seqno = seqnos[addresses[pattern[i % pattern.size ()]]];
+      seqno++;
+    }
+  int64_t hashElapsed = clock.End ();
+
+  std::map<Mac48Address, uint32_t> treeSeqnos;
+  clock.Start ();
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      treeSeqnos[addresses[pattern[i % pattern.size ()]]]++;
+    }
+  int64_t treeElapsed = clock.End ();
+
+  table->Dispose ();
+  Simulator::Destroy ();
+
+  std::cout << "destinations=" << nDestinations << " frames=" << nFrames << " routes-found=" << found << std::endl;
+  std::cout << "route lookups: wall-clock(ms)=" << routeElapsed
+            << " lookups/s=" << Rate (nFrames, routeElapsed) << std::endl;
+  std::cout << "seqno lookups (Mac48AddressMap): wall-clock(ms)=" << hashElapsed
+            << " lookups/s=" << Rate (nFrames, hashElapsed) << std::endl;
+  std::cout << "seqno lookups (std::map): wall-clock(ms)=" << treeElapsed
+            << " lookups/s=" << Rate (nFrames, treeElapsed) << std::endl;
+  return 0;
+}
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Latency of the first round of a mesh with each mode of ArpL3Protocol.
+//
+// The mesh points of a grid form a tree: the parent of each one is its left
+// neighbour, or its upper neighbour on the first column. Once the peer links
+// are up, every mesh point sends one packet to its parent within a few
+// milliseconds, so the ARP resolution (broadcast requests flooded through the mesh, unless
+// the mode avoids them) and the HWMP path discovery of all the tree edges
+// happen together, as in the first round of an aggregation.
+//
+// ./waf --run "mesh-arp-benchmark --x-size=6 --y-size=6"
+
+#include <iostream>
+#include <map>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+
+using namespace ns3;
+
+/// MAC address of the mesh point of each IP address
+static std::map<Ipv4Address, Address> g_meshAddresses;
+/// Time each mesh point sent its packet, by IP address
+static std::map<Ipv4Address, Time> g_sendTimes;
+static uint32_t g_received;
+static Time g_maxLatency;
+static Time g_totalLatency;
+static uint32_t g_arpFrames;
+
+static Address
+Resolve (Ipv4Address address)
+{
+  std::map<Ipv4Address, Address>::const_iterator it = g_meshAddresses.find (address);
+  return it == g_meshAddresses.end () ? Address () : it->second;
+}
+
+static void
+ReceiveArp (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+            const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  g_arpFrames++;
+}
+
+static void
+ReceivePkt (Ptr<Socket> socket)
+{
+  Address from;
+  while (socket->RecvFrom (from))
+    {
+      Time latency = Simulator::Now () - g_sendTimes[InetSocketAddress::ConvertFrom (from).GetIpv4 ()];
+      g_received++;
+      g_totalLatency += latency;
+      g_maxLatency = std::max (g_maxLatency, latency);
+    }
+}
+
+static void
+SendPkt (Ptr<Socket> socket, Ipv4Address to)
+{
+  socket->SendTo (Create<Packet> (100), 0, InetSocketAddress (to, 9));
+}
+
+static void
+InstallPermanent (Ipv4InterfaceContainer &interfaces, NetDeviceContainer &devices, uint32_t a, uint32_t b)
+{
+  std::pair<Ptr<Ipv4>, uint32_t> local = interfaces.Get (a);
+  Ptr<ArpCache> cache = local.first->GetObject<Ipv4L3Protocol> ()->GetInterface (local.second)->GetArpCache ();
+  cache->AddPermanent (interfaces.GetAddress (b), devices.Get (b)->GetAddress ());
+}
+
+static void
+RunMode (ArpL3Protocol::Mode mode, uint32_t xSize, uint32_t ySize, double step, Time start)
+{
+  // the same start jitter for every mode
+  Ptr<UniformRandomVariable> jitter = CreateObject<UniformRandomVariable> ();
+  jitter->SetStream (1);
+  jitter->SetAttribute ("Max", DoubleValue (0.01));
+
+  NodeContainer nodes;
+  nodes.Create (xSize * ySize);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)));
+  NetDeviceContainer meshDevices = mesh.Install (wifiPhy, nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (step),
+                                 "DeltaY", DoubleValue (step),
+                                 "GridWidth", UintegerValue (xSize),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  InternetStackHelper internetStack;
+  internetStack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (meshDevices);
+
+  g_meshAddresses.clear ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      g_meshAddresses[interfaces.GetAddress (i)] = meshDevices.Get (i)->GetAddress ();
+      Ptr<ArpL3Protocol> arp = nodes.Get (i)->GetObject<ArpL3Protocol> ();
+      arp->SetAttribute ("Mode", EnumValue (mode));
+      arp->SetResolveCallback (MakeCallback (&Resolve));
+      nodes.Get (i)->RegisterProtocolHandler (MakeCallback (&ReceiveArp), ArpL3Protocol::PROT_NUMBER, 0);
+    }
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Socket> rxSocket = Socket::CreateSocket (nodes.Get (i), UdpSocketFactory::GetTypeId ());
+      rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+      rxSocket->SetRecvCallback (MakeCallback (&ReceivePkt));
+      if (i == 0)
+        {
+          continue;
+        }
+      uint32_t parent = (i % xSize == 0) ? i - xSize : i - 1;
+      if (mode == ArpL3Protocol::PREINSTALLED)
+        {
+          InstallPermanent (interfaces, meshDevices, i, parent);
+          InstallPermanent (interfaces, meshDevices, parent, i);
+        }
+      Ptr<Socket> txSocket = Socket::CreateSocket (nodes.Get (i), UdpSocketFactory::GetTypeId ());
+      Time sendTime = start + Seconds (jitter->GetValue ());
+      g_sendTimes[interfaces.GetAddress (i)] = sendTime;
+      Simulator::Schedule (sendTime, &SendPkt, txSocket, interfaces.GetAddress (parent));
+    }
+
+  g_received = 0;
+  g_maxLatency = Seconds (0);
+  g_totalLatency = Seconds (0);
+  g_arpFrames = 0;
+  Simulator::Stop (start + Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t xSize = 5;
+  uint32_t ySize = 5;
+  double step = 100;
+  double start = 10;
+
+  CommandLine cmd;
+  cmd.AddValue ("x-size", "Number of mesh points in a row of the grid", xSize);
+  cmd.AddValue ("y-size", "Number of rows of the grid", ySize);
+  cmd.AddValue ("step", "Distance between the mesh points, meters", step);
+  cmd.AddValue ("start", "Time the packets are sent, once the peer links are up, seconds", start);
+  cmd.Parse (argc, argv);
+
+  const char *names[] = { "", "Normal", "CreationOnly", "MaintenanceOnly", "Preinstalled" };
+  std::cout << "grid=" << xSize << "x" << ySize << " packets=" << xSize * ySize - 1 << std::endl;
+  for (int mode = ArpL3Protocol::NORMAL; mode <= ArpL3Protocol::PREINSTALLED; mode++)
+    {
+      RunMode ((ArpL3Protocol::Mode) mode, xSize, ySize, step, Seconds (start));
+      std::cout << names[mode] << ": received=" << g_received
+                << " max-latency(ms)=" << g_maxLatency.GetMilliSeconds ()
+                << " mean-latency(ms)=" << (g_received > 0 ? g_totalLatency.GetMilliSeconds () / g_received : 0)
+                << " arp-frames-received=" << g_arpFrames << std::endl;
+    }
+  return 0;
+}
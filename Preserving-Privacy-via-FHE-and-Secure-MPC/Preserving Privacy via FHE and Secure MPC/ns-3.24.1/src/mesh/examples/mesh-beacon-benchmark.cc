@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Frames and simulation time of an idle static mesh, with the fixed and
+// the adaptive beacon interval of MeshWifiInterfaceMac.
+//
+// The mesh points of a grid only beacon and keep their peer links up. The
+// frames sent and received by the PHYs, the peer links at the end and the
+// wall-clock time of the simulation are reported for each mode.
+//
+// ./waf --run "mesh-beacon-benchmark --x-size=10 --y-size=10 --time=600"
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/peer-management-protocol.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+static uint64_t g_txFrames;
+static uint64_t g_rxFrames;
+
+static void
+PhyTx (Ptr<const Packet> p)
+{
+  g_txFrames++;
+}
+
+static void
+PhyRx (Ptr<const Packet> p)
+{
+  g_rxFrames++;
+}
+
+static void
+RunMode (bool adaptive, uint32_t xSize, uint32_t ySize, double step, Time maxInterval, Time duration)
+{
+  g_txFrames = 0;
+  g_rxFrames = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+
+  NodeContainer nodes;
+  nodes.Create (xSize * ySize);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)),
+                   "AdaptiveBeaconing", BooleanValue (adaptive),
+                   "MaxBeaconInterval", TimeValue (maxInterval));
+  NetDeviceContainer meshDevices = mesh.Install (wifiPhy, nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (step),
+                                 "DeltaY", DoubleValue (step),
+                                 "GridWidth", UintegerValue (xSize),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxBegin", MakeCallback (&PhyTx));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEnd", MakeCallback (&PhyRx));
+
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  uint32_t links = 0;
+  for (uint32_t i = 0; i < meshDevices.GetN (); i++)
+    {
+      links += meshDevices.Get (i)->GetObject<dot11s::PeerManagementProtocol> ()->GetNumberOfLinks ();
+    }
+  Simulator::Destroy ();
+  int64_t elapsed = clock.End ();
+
+  std::cout << (adaptive ? "adaptive" : "fixed") << ": tx-frames=" << g_txFrames
+            << " rx-frames=" << g_rxFrames << " peer-links=" << links / 2
+            << " wall-clock(ms)=" << elapsed << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t xSize = 6;
+  uint32_t ySize = 6;
+  double step = 100;
+  double maxInterval = 4;
+  double duration = 300;
+
+  CommandLine cmd;
+  cmd.AddValue ("x-size", "Number of mesh points in a row of the grid", xSize);
+  cmd.AddValue ("y-size", "Number of rows of the grid", ySize);
+  cmd.AddValue ("step", "Distance between the mesh points, meters", step);
+  cmd.AddValue ("max-beacon", "Longest beacon interval when adaptive, seconds", maxInterval);
+  cmd.AddValue ("time", "Simulation time, seconds", duration);
+  cmd.Parse (argc, argv);
+
+  std::cout << "grid=" << xSize << "x" << ySize << " time=" << duration << "s" << std::endl;
+  RunMode (false, xSize, ySize, step, Seconds (maxInterval), Seconds (duration));
+  RunMode (true, xSize, ySize, step, Seconds (maxInterval), Seconds (duration));
+  return 0;
+}
@@ -0,0 +1,310 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Validation of the abstract mode of MeshLinkModel against the full 802.11s
+// mesh, on the round completion times of a hop-by-hop aggregation.
+//
+// The mesh points of a grid form a tree: the parent of each one is its left
+// neighbour, or its upper neighbour on the first column. In every round,
+// each mesh point sends a frame to its parent once it has received the
+// frames of all its children; the round is complete when the root has
+// them. The rounds of three runs of the same topology are compared:
+//   1. full mesh, calibrating the link model,
+//   2. full mesh, another seed, the reference,
+//   3. abstract mode of the link model calibrated by run 1.
+// The quantiles of the completion times of runs 2 and 3 are printed, with
+// the two-sample Kolmogorov-Smirnov distance between them and its critical
+// value at the 5% level.
+//
+// ./waf --run "mesh-link-model-validation --x-size=5 --y-size=5 --rounds=100"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/mesh-link-model.h"
+
+using namespace ns3;
+
+/// Protocol number of the aggregation frames
+static const uint16_t PROTOCOL = 0x88b5;
+
+/// One run of the aggregation rounds on the grid
+class AggregationRun
+{
+public:
+  AggregationRun (uint32_t xSize, uint32_t ySize, double step, uint32_t rounds, Time interval,
+                  uint32_t size);
+  /**
+   * \param model the link model to install, if any
+   * \param beacons whether the interfaces send beacons
+   * \return the wall-clock time of the run, in ms
+   */
+  int64_t Run (Ptr<MeshLinkModel> model, bool beacons);
+  /// \return the completion times of the completed rounds, sorted
+  std::vector<double> GetCompletionTimes () const;
+
+private:
+  void StartRound (uint32_t round);
+  void Send (uint32_t node, uint32_t round);
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  uint32_t m_xSize;
+  uint32_t m_ySize;
+  double m_step;
+  uint32_t m_rounds;
+  Time m_interval;
+  uint32_t m_size;
+  NetDeviceContainer m_devices;
+  std::map<Ptr<NetDevice>, uint32_t> m_nodeIndexes;
+  std::vector<uint32_t> m_parents;
+  std::vector<uint32_t> m_children;
+  std::vector<std::vector<uint32_t> > m_receivedChildren; //!< by round and node
+  std::vector<Time> m_startTimes;
+  std::vector<double> m_completionTimes;
+  Ptr<UniformRandomVariable> m_jitter;
+};
+
+AggregationRun::AggregationRun (uint32_t xSize, uint32_t ySize, double step, uint32_t rounds,
+                                Time interval, uint32_t size)
+  : m_xSize (xSize),
+    m_ySize (ySize),
+    m_step (step),
+    m_rounds (rounds),
+    m_interval (interval),
+    m_size (size)
+{
+  uint32_t n = xSize * ySize;
+  m_parents.resize (n, 0);
+  m_children.resize (n, 0);
+  for (uint32_t i = 1; i < n; i++)
+    {
+      m_parents[i] = (i % xSize == 0) ? i - xSize : i - 1;
+      m_children[m_parents[i]]++;
+    }
+}
+
+void
+AggregationRun::StartRound (uint32_t round)
+{
+  m_startTimes[round] = Simulator::Now ();
+  for (uint32_t i = 1; i < m_parents.size (); i++)
+    {
+      if (m_children[i] == 0)
+        {
+          Simulator::Schedule (Seconds (m_jitter->GetValue ()), &AggregationRun::Send, this, i, round);
+        }
+    }
+}
+
+void
+AggregationRun::Send (uint32_t node, uint32_t round)
+{
+  std::vector<uint8_t> payload (std::max<uint32_t> (m_size, sizeof (round)), 0);
+  std::copy ((uint8_t *) &round, (uint8_t *) &round + sizeof (round), payload.begin ());
+  m_devices.Get (node)->Send (Create<Packet> (&payload[0], payload.size ()),
+                              m_devices.Get (m_parents[node])->GetAddress (), PROTOCOL);
+}
+
+void
+AggregationRun::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                         const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  uint32_t round;
+  p->CopyData ((uint8_t *) &round, sizeof (round));
+  uint32_t node = m_nodeIndexes[device];
+  if (++m_receivedChildren[round][node] < m_children[node])
+    {
+      return;
+    }
+  if (node == 0)
+    {
+      m_completionTimes.push_back ((Simulator::Now () - m_startTimes[round]).GetSeconds ());
+    }
+  else
+    {
+      Send (node, round);
+    }
+}
+
+int64_t
+AggregationRun::Run (Ptr<MeshLinkModel> model, bool beacons)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  m_completionTimes.clear ();
+  m_receivedChildren.assign (m_rounds, std::vector<uint32_t> (m_parents.size (), 0));
+  m_startTimes.assign (m_rounds, Seconds (0));
+  m_jitter = CreateObject<UniformRandomVariable> ();
+  m_jitter->SetAttribute ("Max", DoubleValue (0.01));
+
+  NodeContainer nodes;
+  nodes.Create (m_xSize * m_ySize);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)),
+                   "BeaconGeneration", BooleanValue (beacons));
+  m_devices = mesh.Install (wifiPhy, nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (m_step),
+                                 "DeltaY", DoubleValue (m_step),
+                                 "GridWidth", UintegerValue (m_xSize),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  m_nodeIndexes.clear ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      m_nodeIndexes[m_devices.Get (i)] = i;
+      nodes.Get (i)->RegisterProtocolHandler (MakeCallback (&AggregationRun::Receive, this),
+                                              PROTOCOL, m_devices.Get (i));
+    }
+  if (model != 0)
+    {
+      model->Install (m_devices);
+    }
+
+  // The first round once the peer links are up
+  for (uint32_t r = 0; r < m_rounds; r++)
+    {
+      Simulator::Schedule (Seconds (5) + m_interval * static_cast<int64_t> (r), &AggregationRun::StartRound, this, r);
+    }
+  Simulator::Stop (Seconds (5) + m_interval * static_cast<int64_t> (m_rounds));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_devices = NetDeviceContainer ();
+  m_nodeIndexes.clear ();
+  return clock.End ();
+}
+
+std::vector<double>
+AggregationRun::GetCompletionTimes () const
+{
+  std::vector<double> times = m_completionTimes;
+  std::sort (times.begin (), times.end ());
+  return times;
+}
+
+/// \return the q-quantile of sorted values
+static double
+Quantile (const std::vector<double> &sorted, double q)
+{
+  if (sorted.empty ())
+    {
+      return 0;
+    }
+  return sorted[std::min<size_t> (sorted.size () - 1, (size_t) (q * sorted.size ()))];
+}
+
+/// \return the largest distance between the empirical distributions of two sorted samples
+static double
+KolmogorovSmirnov (const std::vector<double> &a, const std::vector<double> &b)
+{
+  double d = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.size () && j < b.size ())
+    {
+      double x = std::min (a[i], b[j]);
+      while (i < a.size () && a[i] <= x)
+        {
+          i++;
+        }
+      while (j < b.size () && b[j] <= x)
+        {
+          j++;
+        }
+      d = std::max (d, std::fabs ((double) i / a.size () - (double) j / b.size ()));
+    }
+  return d;
+}
+
+static void
+Print (std::string name, const std::vector<double> &times, uint32_t rounds, int64_t elapsed)
+{
+  std::cout << name << ": completed=" << times.size () << "/" << rounds
+            << " p10(ms)=" << Quantile (times, 0.1) * 1000
+            << " p50(ms)=" << Quantile (times, 0.5) * 1000
+            << " p90(ms)=" << Quantile (times, 0.9) * 1000
+            << " max(ms)=" << Quantile (times, 1) * 1000
+            << " wall-clock(ms)=" << elapsed << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t xSize = 5;
+  uint32_t ySize = 5;
+  double step = 100;
+  uint32_t rounds = 100;
+  double interval = 5;
+  uint32_t size = 1000;
+  std::string save;
+
+  CommandLine cmd;
+  cmd.AddValue ("x-size", "Number of mesh points in a row of the grid", xSize);
+  cmd.AddValue ("y-size", "Number of rows of the grid", ySize);
+  cmd.AddValue ("step", "Distance between the mesh points, meters", step);
+  cmd.AddValue ("rounds", "Number of aggregation rounds of each run", rounds);
+  cmd.AddValue ("interval", "Interval between the rounds, seconds", interval);
+  cmd.AddValue ("size", "Size of the aggregation frames, bytes", size);
+  cmd.AddValue ("save", "File to save the calibrated link model to", save);
+  cmd.Parse (argc, argv);
+
+  AggregationRun run (xSize, ySize, step, rounds, Seconds (interval), size);
+  Ptr<MeshLinkModel> model = CreateObject<MeshLinkModel> ();
+  model->AssignStreams (0);
+
+  RngSeedManager::SetRun (1);
+  int64_t calibration = run.Run (model, true);
+  if (!save.empty ())
+    {
+      std::ofstream os (save.c_str ());
+      model->Save (os);
+    }
+
+  RngSeedManager::SetRun (2);
+  int64_t full = run.Run (0, true);
+  std::vector<double> fullTimes = run.GetCompletionTimes ();
+
+  RngSeedManager::SetRun (3);
+  model->SetAttribute ("Mode", EnumValue (MeshLinkModel::ABSTRACT));
+  int64_t abstract = run.Run (model, false);
+  std::vector<double> abstractTimes = run.GetCompletionTimes ();
+
+  std::cout << "grid=" << xSize << "x" << ySize << " rounds=" << rounds << " interval=" << interval << "s"
+            << " calibrated-pairs=" << model->GetNLinks () << " calibration wall-clock(ms)=" << calibration
+            << std::endl;
+  Print ("full", fullTimes, rounds, full);
+  Print ("abstract", abstractTimes, rounds, abstract);
+  double n = fullTimes.size ();
+  double m = abstractTimes.size ();
+  std::cout << "KS distance=" << KolmogorovSmirnov (fullTimes, abstractTimes)
+            << " critical(5%)=" << (n > 0 && m > 0 ? 1.36 * std::sqrt ((n + m) / (n * m)) : 0) << std::endl;
+  return 0;
+}
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Report latency of TCP over lossy MST paths, with and without the PeaRto
+// option of TcpSocketBase.
+//
+// The mesh points of a grid form a tree: the parent of each one is its left
+// neighbour, or its upper neighbour on the first column. The HWMP paths of
+// the tree are installed at start, and HwmpTcpInterface forwards the path
+// errors and repairs of HWMP to TCP. Every mesh point sends a report to the
+// root over TCP at each interval. The links are lossy: at each outage
+// interval a random mesh point leaves the grid for the outage duration,
+// which breaks the paths through it until HWMP repairs them. The same
+// outages happen in both runs.
+//
+// ./waf --run "mesh-pearto-benchmark --x-size=5 --y-size=5"
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/hwmp-protocol.h"
+#include "ns3/hwmp-tcp-interface.h"
+#include "ns3/tcp-l4-protocol.h"
+
+using namespace ns3;
+
+static const uint16_t PORT = 9;
+
+/// Reports of a mesh point
+struct Flow
+{
+  std::vector<Time> sendTimes; ///< time each report was sent
+  uint32_t rxBytes;            ///< bytes received by the root
+};
+
+static std::vector<Flow> g_flows;
+/// Flow of each socket accepted by the root
+static std::map<Ptr<Socket>, uint32_t> g_accepted;
+/// Flow of each IP address
+static std::map<Ipv4Address, uint32_t> g_flowOf;
+static uint32_t g_reportSize;
+static uint32_t g_received;
+static Time g_totalLatency;
+static Time g_maxLatency;
+static uint32_t g_rtoIncreases;
+
+static void
+ReceiveReport (Ptr<Socket> socket)
+{
+  Flow &flow = g_flows[g_accepted[socket]];
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      uint32_t before = flow.rxBytes / g_reportSize;
+      flow.rxBytes += packet->GetSize ();
+      for (uint32_t k = before; k < flow.rxBytes / g_reportSize; k++)
+        {
+          Time latency = Simulator::Now () - flow.sendTimes[k];
+          g_received++;
+          g_totalLatency += latency;
+          g_maxLatency = std::max (g_maxLatency, latency);
+        }
+    }
+}
+
+static void
+Accept (Ptr<Socket> socket, const Address &from)
+{
+  g_accepted[socket] = g_flowOf[InetSocketAddress::ConvertFrom (from).GetIpv4 ()];
+  socket->SetRecvCallback (MakeCallback (&ReceiveReport));
+}
+
+static void
+SendReport (Ptr<Socket> socket, uint32_t flow, Time interval)
+{
+  g_flows[flow].sendTimes.push_back (Simulator::Now ());
+  socket->Send (Create<Packet> (g_reportSize));
+  Simulator::Schedule (interval, &SendReport, socket, flow, interval);
+}
+
+static void
+RtoChange (Time oldValue, Time newValue)
+{
+  if (newValue > oldValue)
+    {
+      g_rtoIncreases++;
+    }
+}
+
+static void
+Connected (Ptr<Socket> socket)
+{
+  socket->TraceConnectWithoutContext ("RTO", MakeCallback (&RtoChange));
+}
+
+static void
+Connect (Ptr<Socket> socket, Address address)
+{
+  socket->Connect (address);
+}
+
+static void
+Move (Ptr<MobilityModel> mobility, Vector position)
+{
+  mobility->SetPosition (position);
+}
+
+static uint32_t
+RunMode (bool peaRto, uint32_t xSize, uint32_t ySize, double step, Time start, Time stop,
+         Time interval, Time outageInterval, Time outage)
+{
+  Config::SetDefault ("ns3::TcpSocketBase::PeaRto", BooleanValue (peaRto));
+  // the same outages and send times in both runs
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  NodeContainer nodes;
+  nodes.Create (xSize * ySize);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)));
+  NetDeviceContainer meshDevices = mesh.Install (wifiPhy, nodes);
+  mesh.AssignStreams (meshDevices, 2);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (step),
+                                 "DeltaY", DoubleValue (step),
+                                 "GridWidth", UintegerValue (xSize),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  InternetStackHelper internetStack;
+  internetStack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (meshDevices);
+
+  std::map<uint32_t, uint32_t> parents;
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+    {
+      parents[i] = (i % xSize == 0) ? i - xSize : i - 1;
+    }
+  Dot11sStack::InstallTreePaths (meshDevices, parents, stop + Seconds (20));
+
+  std::vector<Ptr<HwmpTcpInterface> > htis;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<HwmpTcpInterface> hti = CreateObject<HwmpTcpInterface> ();
+      nodes.Get (i)->AggregateObject (hti);
+      Ptr<dot11s::HwmpProtocol> hwmp = meshDevices.Get (i)->GetObject<dot11s::HwmpProtocol> ();
+      hwmp->SetReportHwmpTcpInterfaceCallback (MakeCallback (&HwmpTcpInterface::ReceivedPerrInfoFromHwmp, PeekPointer (hti)));
+      hwmp->SetReportPathResolvedCallback (MakeCallback (&HwmpTcpInterface::ReceivedPathResolvedFromHwmp, PeekPointer (hti)));
+      Ptr<TcpL4Protocol> tcp = nodes.Get (i)->GetObject<TcpL4Protocol> ();
+      tcp->SetPathErrorCallback (MakeCallback (&HwmpTcpInterface::CheckHwmpForPerrInfo, PeekPointer (hti)));
+      hti->SetPathRepairedCallback (MakeCallback (&TcpL4Protocol::NotifyPathRepaired, PeekPointer (tcp)));
+      htis.push_back (hti);
+    }
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), PORT));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (), MakeCallback (&Accept));
+  g_flows.assign (nodes.GetN (), Flow ());
+  g_flowOf.clear ();
+  g_accepted.clear ();
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+    {
+      g_flows[i].rxBytes = 0;
+      g_flowOf[interfaces.GetAddress (i)] = i;
+      Ptr<Socket> socket = Socket::CreateSocket (nodes.Get (i), TcpSocketFactory::GetTypeId ());
+      socket->SetConnectCallback (MakeCallback (&Connected), MakeNullCallback<void, Ptr<Socket> > ());
+      // once the peer links are up, for the ARP request to be flooded
+      Simulator::Schedule (start, &Connect, socket, InetSocketAddress (interfaces.GetAddress (0), PORT));
+      Time first = start + Seconds (1 + random->GetValue (0, interval.GetSeconds ()));
+      Simulator::Schedule (first, &SendReport, socket, i, interval);
+    }
+
+  for (Time t = start + outageInterval; t + outage < stop; t += outageInterval)
+    {
+      uint32_t i = 1 + random->GetInteger (0, nodes.GetN () - 2);
+      Ptr<MobilityModel> model = nodes.Get (i)->GetObject<MobilityModel> ();
+      Vector position = model->GetPosition ();
+      Simulator::Schedule (t, &Move, model, Vector (position.x + 100 * step, position.y, 0));
+      Simulator::Schedule (t + outage, &Move, model, position);
+    }
+
+  g_received = 0;
+  g_totalLatency = Seconds (0);
+  g_maxLatency = Seconds (0);
+  g_rtoIncreases = 0;
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  uint32_t frozen = 0;
+  for (uint32_t i = 0; i < htis.size (); i++)
+    {
+      frozen += htis[i]->GetReportRto ();
+    }
+  Simulator::Destroy ();
+  return frozen;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t xSize = 5;
+  uint32_t ySize = 5;
+  double step = 100;
+  double start = 10;
+  double stop = 300;
+  double interval = 2;
+  double outageInterval = 10;
+  double outage = 4;
+  g_reportSize = 200;
+
+  CommandLine cmd;
+  cmd.AddValue ("x-size", "Number of mesh points in a row of the grid", xSize);
+  cmd.AddValue ("y-size", "Number of rows of the grid", ySize);
+  cmd.AddValue ("step", "Distance between the mesh points, meters", step);
+  cmd.AddValue ("start", "Time of the connections, once the peer links are up, seconds", start);
+  cmd.AddValue ("stop", "Duration of the simulation, seconds", stop);
+  cmd.AddValue ("interval", "Interval between the reports of a mesh point, seconds", interval);
+  cmd.AddValue ("report-size", "Size of a report, bytes", g_reportSize);
+  cmd.AddValue ("outage-interval", "Interval between the outages, seconds", outageInterval);
+  cmd.AddValue ("outage", "Duration of an outage, seconds", outage);
+  cmd.Parse (argc, argv);
+
+  std::cout << "grid=" << xSize << "x" << ySize << " duration(s)=" << stop
+            << " outage(s)=" << outage << "/" << outageInterval << std::endl;
+  for (int peaRto = 0; peaRto < 2; peaRto++)
+    {
+      uint32_t frozen = RunMode (peaRto, xSize, ySize, step, Seconds (start), Seconds (stop),
+                                 Seconds (interval), Seconds (outageInterval), Seconds (outage));
+      std::cout << (peaRto ? "PeaRto" : "No PeaRto") << ": reports=" << g_received
+                << " mean-latency(ms)=" << (g_received > 0 ? g_totalLatency.GetMilliSeconds () / g_received : 0)
+                << " max-latency(ms)=" << g_maxLatency.GetMilliSeconds ()
+                << " rto-increases=" << g_rtoIncreases
+                << " frozen-rto=" << frozen << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Wall-clock time of a sweep of frame sizes over a warmed-up mesh, with
+// and without a SimulatorSweep forked from the end of the warm-up.
+//
+// The mesh points of a grid establish their peer links during the
+// warm-up. In each variant, every mesh point then sends frames of the
+// variant size to the first one. The sweep either simulates the warm-up
+// again for every variant, or once, forking every variant from its end. The frames delivered and their mean delay are
+// reported for each variant, with the wall-clock time of each sweep. The
+// meshes of the full sweep draw from other random streams than the one
+// forked, so their results differ within the noise.
+//
+// ./waf --run "mesh-sweep-benchmark --x-size=5 --y-size=5 --warmup=30 --sizes=100,500,1000,1500"
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/simulator-sweep.h"
+
+using namespace ns3;
+
+/// Protocol number of the frames of the variants
+static const uint16_t PROTOCOL = 0x88b5;
+
+/// The mesh of the sweep and the frames of a variant
+class MeshSweep
+{
+public:
+  MeshSweep (uint32_t xSize, uint32_t ySize, double step, Time interval, Time duration);
+  /// Create the mesh, from time zero
+  void Setup (void);
+  /// Send frames of a size from now on, up to the end of the variant
+  void RunVariant (uint32_t size);
+  /// Destroy the mesh
+  void Teardown (void);
+
+private:
+  void Send (uint32_t node, uint32_t size, uint32_t seq);
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  uint32_t m_xSize;
+  uint32_t m_ySize;
+  double m_step;
+  Time m_interval;
+  Time m_duration;
+  NetDeviceContainer m_devices;
+  Ptr<UniformRandomVariable> m_jitter;
+  std::vector<Time> m_sendTimes; //!< by sequence number
+  uint32_t m_sent;
+  uint32_t m_delivered;
+  Time m_totalDelay;
+};
+
+MeshSweep::MeshSweep (uint32_t xSize, uint32_t ySize, double step, Time interval, Time duration)
+  : m_xSize (xSize),
+    m_ySize (ySize),
+    m_step (step),
+    m_interval (interval),
+    m_duration (duration),
+    m_sent (0),
+    m_delivered (0)
+{
+}
+
+void
+MeshSweep::Setup (void)
+{
+  m_jitter = CreateObject<UniformRandomVariable> ();
+  m_jitter->SetAttribute ("Max", DoubleValue (m_interval.GetSeconds ()));
+  NodeContainer nodes;
+  nodes.Create (m_xSize * m_ySize);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)));
+  m_devices = mesh.Install (wifiPhy, nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (m_step),
+                                 "DeltaY", DoubleValue (m_step),
+                                 "GridWidth", UintegerValue (m_xSize),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  nodes.Get (0)->RegisterProtocolHandler (MakeCallback (&MeshSweep::Receive, this),
+                                          PROTOCOL, m_devices.Get (0));
+}
+
+void
+MeshSweep::Send (uint32_t node, uint32_t size, uint32_t seq)
+{
+  std::vector<uint8_t> payload (std::max<uint32_t> (size, sizeof (seq)), 0);
+  std::copy ((uint8_t *) &seq, (uint8_t *) &seq + sizeof (seq), payload.begin ());
+  m_sendTimes[seq] = Simulator::Now ();
+  m_sent++;
+  m_devices.Get (node)->Send (Create<Packet> (&payload[0], payload.size ()),
+                              m_devices.Get (0)->GetAddress (), PROTOCOL);
+}
+
+void
+MeshSweep::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                        const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  uint32_t seq;
+  p->CopyData ((uint8_t *) &seq, sizeof (seq));
+  m_delivered++;
+  m_totalDelay += Simulator::Now () - m_sendTimes[seq];
+}
+
+void
+MeshSweep::RunVariant (uint32_t size)
+{
+  m_sent = 0;
+  m_delivered = 0;
+  m_totalDelay = Seconds (0);
+  uint32_t rounds = m_duration.GetSeconds () / m_interval.GetSeconds ();
+  m_sendTimes.assign (rounds * m_devices.GetN (), Seconds (0));
+  for (uint32_t r = 0; r < rounds; r++)
+    {
+      for (uint32_t i = 1; i < m_devices.GetN (); i++)
+        {
+          Time at = m_interval * static_cast<int64_t> (r) + Seconds (m_jitter->GetValue ());
+          Simulator::Schedule (at, &MeshSweep::Send, this, i, size, r * m_devices.GetN () + i);
+        }
+    }
+  // The frames in flight at the end are lost
+  Simulator::Stop (m_duration + Seconds (1));
+  Simulator::Run ();
+  std::cout << "  size=" << size << " delivered=" << m_delivered << "/" << m_sent
+            << " mean-delay(ms)=" << (m_delivered > 0 ? m_totalDelay.GetSeconds () * 1000 / m_delivered : 0)
+            << std::endl;
+}
+
+void
+MeshSweep::Teardown (void)
+{
+  Simulator::Destroy ();
+  m_devices = NetDeviceContainer ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t xSize = 5;
+  uint32_t ySize = 5;
+  double step = 100;
+  double warmup = 30;
+  double interval = 1;
+  double duration = 10;
+  std::string sizeList = "100,500,1000,1500";
+
+  CommandLine cmd;
+  cmd.AddValue ("x-size", "Number of mesh points in a row of the grid", xSize);
+  cmd.AddValue ("y-size", "Number of rows of the grid", ySize);
+  cmd.AddValue ("step", "Distance between the mesh points, meters", step);
+  cmd.AddValue ("warmup", "Simulation time of the warm-up, seconds", warmup);
+  cmd.AddValue ("interval", "Interval between the frames of a mesh point, seconds", interval);
+  cmd.AddValue ("time", "Simulation time of each variant after the warm-up, seconds", duration);
+  cmd.AddValue ("sizes", "Comma separated frame sizes of the variants, bytes", sizeList);
+  cmd.Parse (argc, argv);
+
+  std::vector<uint32_t> sizes;
+  std::istringstream is (sizeList);
+  std::string size;
+  while (std::getline (is, size, ','))
+    {
+      sizes.push_back (std::atoi (size.c_str ()));
+    }
+  MeshSweep sweep (xSize, ySize, step, Seconds (interval), Seconds (duration));
+  std::cout << "grid=" << xSize << "x" << ySize << " warmup=" << warmup << "s time=" << duration
+            << "s variants=" << sizes.size () << std::endl;
+
+  // The warm-up simulated for each variant
+  std::cout << "full:" << std::endl;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t v = 0; v < sizes.size (); v++)
+    {
+      sweep.Setup ();
+      Simulator::Stop (Seconds (warmup));
+      Simulator::Run ();
+      sweep.RunVariant (sizes[v]);
+      sweep.Teardown ();
+    }
+  int64_t full = clock.End ();
+
+  // The warm-up simulated once, each variant in a copy forked from its end
+  std::cout << "forked:" << std::endl;
+  clock.Start ();
+  sweep.Setup ();
+  SimulatorSweep forks;
+  forks.RunWarmup (Seconds (warmup));
+  uint32_t failed = 0;
+  for (uint32_t v = 0; v < sizes.size (); v++)
+    {
+      if (forks.Fork ())
+        {
+          sweep.RunVariant (sizes[v]);
+          sweep.Teardown ();
+          std::exit (0);
+        }
+      std::vector<std::string> results;
+      failed += forks.Wait (results);
+    }
+  sweep.Teardown ();
+  int64_t forked = clock.End ();
+
+  std::cout << "full wall-clock(ms)=" << full << " forked wall-clock(ms)=" << forked
+            << " failed=" << failed << std::endl;
+  return failed > 0;
+}
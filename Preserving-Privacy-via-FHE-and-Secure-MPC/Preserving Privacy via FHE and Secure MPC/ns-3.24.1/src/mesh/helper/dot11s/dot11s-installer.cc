@@ -124,4 +124,54 @@ Dot11sStack::ResetStats (const Ptr<MeshPointDevice> mp)
   NS_ASSERT (pmp != 0);
   pmp->ResetStats ();
 }
+bool
+Dot11sStack::InstallTreePaths (NetDeviceContainer devices, const std::map<uint32_t, uint32_t> &parents,
+                               Time lifetime)
+{
+  //A walk up the tree longer than the number of parents goes round a cycle
+  for (std::map<uint32_t, uint32_t>::const_iterator i = parents.begin (); i != parents.end (); ++i)
+    {
+      uint32_t steps = 0;
+      for (std::map<uint32_t, uint32_t>::const_iterator up = i; up != parents.end (); up = parents.find (up->second))
+        {
+          if (++steps > parents.size ())
+            {
+              return false;
+            }
+        }
+    }
+  for (std::map<uint32_t, uint32_t>::const_iterator i = parents.begin (); i != parents.end (); ++i)
+    {
+      std::vector<uint32_t> hops;
+      hops.push_back (i->first);
+      for (std::map<uint32_t, uint32_t>::const_iterator up = i; up != parents.end (); up = parents.find (up->second))
+        {
+          hops.push_back (up->second);
+          InstallTreePath (devices, hops, lifetime);
+          InstallTreePath (devices, std::vector<uint32_t> (hops.rbegin (), hops.rend ()), lifetime);
+        }
+    }
+  return true;
+}
+void
+Dot11sStack::InstallTreePath (NetDeviceContainer devices, const std::vector<uint32_t> &hops, Time lifetime)
+{
+  Mac48Address destination = Mac48Address::ConvertFrom (devices.Get (hops.back ())->GetAddress ());
+  for (uint32_t j = 0; j + 1 < hops.size (); j++)
+    {
+      Ptr<MeshPointDevice> mp = devices.Get (hops[j])->GetObject<MeshPointDevice> ();
+      NS_ASSERT (mp != 0);
+      Ptr<HwmpProtocol> hwmp = mp->GetObject<HwmpProtocol> ();
+      NS_ASSERT (hwmp != 0);
+      //The tree links are between neighbours on the first interface
+      uint32_t interface = mp->GetInterfaces ()[0]->GetIfIndex ();
+      Mac48Address next = Mac48Address::ConvertFrom (devices.Get (hops[j + 1])->GetAddress ());
+      hwmp->InstallPath (destination, next, interface, hops.size () - 1 - j, lifetime);
+      if (j > 0)
+        {
+          Mac48Address previous = Mac48Address::ConvertFrom (devices.Get (hops[j - 1])->GetAddress ());
+          hwmp->InstallPrecursor (destination, previous, interface, lifetime);
+        }
+    }
+}
 } // namespace ns3
@@ -22,6 +22,9 @@
 #define DOT11S_STACK_INSTALLER_H
 
 #include "ns3/mesh-stack-installer.h"
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include <map>
 
 namespace ns3 {
 
@@ -66,7 +69,27 @@ public:
    * \brief Reset the statistics on the referenced devices and protocols.
    */
   void ResetStats (const Ptr<MeshPointDevice> mp);
+
+  /**
+   * \brief Install the HWMP paths of a tree, e.g. an aggregation tree known
+   * before the simulation starts.
+   *
+   * Every mesh point gets a path to each of its ancestors and each ancestor
+   * a path back to it, along the tree links on the first interface, with
+   * the intermediate mesh points as precursors. The metric of a path is its
+   * number of hops.
+   *
+   * \param devices the mesh point devices
+   * \param parents the index in devices of the parent of every mesh point
+   *        of the tree but the root, by the index of the mesh point
+   * \param lifetime the lifetime of the paths
+   * \return false, and no path is installed, if the tree has a cycle
+   */
+  static bool InstallTreePaths (NetDeviceContainer devices, const std::map<uint32_t, uint32_t> &parents,
+                                Time lifetime);
 private:
+  /// Install the path from the first to the last of the hops
+  static void InstallTreePath (NetDeviceContainer devices, const std::vector<uint32_t> &hops, Time lifetime);
   Mac48Address m_root;
 };
 
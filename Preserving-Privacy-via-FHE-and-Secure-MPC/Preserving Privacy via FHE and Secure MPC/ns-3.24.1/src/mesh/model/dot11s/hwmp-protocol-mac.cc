@@ -247,6 +247,11 @@ HwmpProtocolMac::SendPreq (std::vector<IePreq> preq)
     {
       hdr.SetAddr1 (*i);
       m_stats.txPreq++;
+      HwmpProtocol::Overhead *overhead = m_protocol->GetCurrentOverhead ();
+      if (overhead != 0)
+        {
+          overhead->txPreq++;
+        }
       m_stats.txMgt++;
       m_stats.txMgtBytes += packet->GetSize ();
       m_parent->SendManagementFrame (packet, hdr);
@@ -314,6 +319,11 @@ HwmpProtocolMac::SendPrep (IePrep prep, Mac48Address receiver)
   hdr.SetAddr3 (m_protocol->GetAddress ());
   //Send Management frame
   m_stats.txPrep++;
+  HwmpProtocol::Overhead *overhead = m_protocol->GetCurrentOverhead ();
+  if (overhead != 0)
+    {
+      overhead->txPrep++;
+    }
   m_stats.txMgt++;
   m_stats.txMgtBytes += packet->GetSize ();
   m_parent->SendManagementFrame (packet, hdr);
@@ -367,6 +377,11 @@ HwmpProtocolMac::ForwardPerr (std::vector<HwmpProtocol::FailedDestination> faile
       Mac48Address address = *i;
       hdr.SetAddr1 (address);
       m_stats.txPerr++;
+      HwmpProtocol::Overhead *overhead = m_protocol->GetCurrentOverhead ();
+      if (overhead != 0)
+        {
+          overhead->txPerr++;
+        }
       m_stats.txMgt++;
       m_stats.txMgtBytes += packet->GetSize ();
       m_parent->SendManagementFrame (packet, hdr);
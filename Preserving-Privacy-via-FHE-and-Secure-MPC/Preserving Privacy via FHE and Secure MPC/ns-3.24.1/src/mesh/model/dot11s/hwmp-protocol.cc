@@ -162,6 +162,14 @@ HwmpProtocol::GetTypeId ()
                       &HwmpProtocol::m_rfFlag),
                     MakeBooleanChecker ()
                     )
+    .AddAttribute ( "OverheadBucket",
+                    "Length of the buckets of time in which the path discovery overhead "
+                    "(PREQ/PREP/PERR frames, discoveries, queue drops) is counted, 0 to disable",
+                    TimeValue (Seconds (0)),
+                    MakeTimeAccessor (
+                      &HwmpProtocol::m_overheadBucket),
+                    MakeTimeChecker ()
+                    )
     .AddTraceSource ( "RouteDiscoveryTime",
                       "The time of route discovery procedure",
                       MakeTraceSourceAccessor (
@@ -225,8 +233,8 @@ HwmpProtocol::DoDispose ()
     }
   m_proactivePreqTimer.Cancel ();
   m_preqTimeouts.clear ();
-  m_lastDataSeqno.clear ();
-  m_hwmpSeqnoMetricDatabase.clear ();
+  m_lastDataSeqno.Clear ();
+  m_hwmpSeqnoMetricDatabase.Clear ();
   m_interfaces.clear ();
   m_rqueue.clear ();
   m_rtable = 0;
@@ -402,6 +410,11 @@ HwmpProtocol::ForwardUnicast (uint32_t  sourceIface, const Mac48Address source,
   else
     {
       m_stats.totalDropped++;
+      Overhead *overhead = GetCurrentOverhead ();
+      if (overhead != 0)
+        {
+          overhead->queueDrops++;
+        }
       return false;
     }
 }
@@ -410,19 +423,18 @@ HwmpProtocol::ReceivePreq (IePreq preq, Mac48Address from, uint32_t interface, M
 {
   preq.IncrementMetric (metric);
   //acceptance cretirea:
-  std::map<Mac48Address, std::pair<uint32_t, uint32_t> >::const_iterator i = m_hwmpSeqnoMetricDatabase.find (
-      preq.GetOriginatorAddress ());
+  const std::pair<uint32_t, uint32_t> *i = m_hwmpSeqnoMetricDatabase.Find (preq.GetOriginatorAddress ());
   bool freshInfo (true);
-  if (i != m_hwmpSeqnoMetricDatabase.end ())
+  if (i != 0)
     {
-      if ((int32_t)(i->second.first - preq.GetOriginatorSeqNumber ())  > 0)
+      if ((int32_t)(i->first - preq.GetOriginatorSeqNumber ())  > 0)
         {
           return;
         }
-      if (i->second.first == preq.GetOriginatorSeqNumber ())
+      if (i->first == preq.GetOriginatorSeqNumber ())
         {
           freshInfo = false;
-          if (i->second.second <= preq.GetMetric ())
+          if (i->second <= preq.GetMetric ())
             {
               return;
             }
@@ -573,17 +585,16 @@ HwmpProtocol::ReceivePrep (IePrep prep, Mac48Address from, uint32_t interface, M
 {
   prep.IncrementMetric (metric);
   //acceptance cretirea:
-  std::map<Mac48Address, std::pair<uint32_t, uint32_t> >::const_iterator i = m_hwmpSeqnoMetricDatabase.find (
-      prep.GetOriginatorAddress ());
+  const std::pair<uint32_t, uint32_t> *i = m_hwmpSeqnoMetricDatabase.Find (prep.GetOriginatorAddress ());
   bool freshInfo (true);
   uint32_t sequence = prep.GetDestinationSeqNumber ();
-  if (i != m_hwmpSeqnoMetricDatabase.end ())
+  if (i != 0)
     {
-      if ((int32_t)(i->second.first - sequence) > 0)
+      if ((int32_t)(i->first - sequence) > 0)
         {
           return;
         }
-      if (i->second.first == sequence)
+      if (i->first == sequence)
         {
           freshInfo = false;
         }
@@ -761,18 +772,18 @@ HwmpProtocol::DropDataFrame (uint32_t seqno, Mac48Address source)
     {
       return true;
     }
-  std::map<Mac48Address, uint32_t,std::less<Mac48Address> >::const_iterator i = m_lastDataSeqno.find (source);
-  if (i == m_lastDataSeqno.end ())
+  uint32_t *last = m_lastDataSeqno.Find (source);
+  if (last == 0)
     {
       m_lastDataSeqno[source] = seqno;
     }
   else
     {
-      if ((int32_t)(i->second - seqno)  >= 0)
+      if ((int32_t)(*last - seqno)  >= 0)
         {
           return true;
         }
-      m_lastDataSeqno[source] = seqno;
+      *last = seqno;
     }
   return false;
 }
@@ -944,7 +955,11 @@ HwmpProtocol::ReactivePathResolved (Mac48Address dst)
   std::map<Mac48Address, PreqEvent>::iterator i = m_preqTimeouts.find (dst);
   if (i != m_preqTimeouts.end ())
     {
-      m_routeDiscoveryTimeCallback (Simulator::Now () - i->second.whenScheduled);
+      RouteDiscoveryDone (Simulator::Now () - i->second.whenScheduled);
+      if (!m_reportPathResolvedCallback.IsNull ())
+        {
+          m_reportPathResolvedCallback (dst);
+        }
     }
 
   HwmpRtable::LookupResult result = m_rtable->LookupReactive (dst);
@@ -1023,15 +1038,20 @@ HwmpProtocol::RetryPathDiscovery (Mac48Address dst, uint8_t numOfRetry)
     {
       QueuedPacket packet = DequeueFirstPacketByDst (dst);
       //purge queue and delete entry from retryDatabase
+      Overhead *overhead = GetCurrentOverhead ();
       while (packet.pkt != 0)
         {
           m_stats.totalDropped++;
+          if (overhead != 0)
+            {
+              overhead->queueDrops++;
+            }
           packet.reply (false, packet.pkt, packet.src, packet.dst, packet.protocol, HwmpRtable::MAX_METRIC);
           packet = DequeueFirstPacketByDst (dst);
         }
       std::map<Mac48Address, PreqEvent>::iterator i = m_preqTimeouts.find (dst);
       NS_ASSERT (i != m_preqTimeouts.end ());
-      m_routeDiscoveryTimeCallback (Simulator::Now () - i->second.whenScheduled);
+      RouteDiscoveryDone (Simulator::Now () - i->second.whenScheduled);
       m_preqTimeouts.erase (i);
       return;
     }
@@ -1059,6 +1079,25 @@ HwmpProtocol::UnsetRoot ()
   m_proactivePreqTimer.Cancel ();
 }
 void
+HwmpProtocol::InstallPath (Mac48Address destination, Mac48Address retransmitter, uint32_t interface,
+                           uint32_t metric, Time lifetime)
+{
+  NS_LOG_FUNCTION (this << destination << retransmitter << interface << metric << lifetime);
+  //The sequence number is not known, any PREQ or PREP of the destination is fresher
+  m_rtable->AddReactivePath (destination, retransmitter, interface, metric, lifetime, 0);
+}
+void
+HwmpProtocol::InstallPrecursor (Mac48Address destination, Mac48Address precursor, uint32_t interface, Time lifetime)
+{
+  NS_LOG_FUNCTION (this << destination << precursor << interface << lifetime);
+  m_rtable->AddPrecursor (destination, interface, precursor, lifetime);
+}
+Ptr<HwmpRtable>
+HwmpProtocol::GetRoutingTable () const
+{
+  return m_rtable;
+}
+void
 HwmpProtocol::SendProactivePreq ()
 {
   IePreq preq;
@@ -1216,10 +1255,50 @@ uint16_t HwmpProtocol::Statistics::GetPathErrorInfoPath () {
   return iPerrPath;
 }
 
+void
+HwmpProtocol::RouteDiscoveryDone (Time duration)
+{
+  m_routeDiscoveryTimeCallback (duration);
+  Overhead *overhead = GetCurrentOverhead ();
+  if (overhead != 0)
+    {
+      overhead->discoveries++;
+      overhead->discoveryTime += duration;
+    }
+}
+HwmpProtocol::Overhead *
+HwmpProtocol::GetCurrentOverhead ()
+{
+  if (!m_overheadBucket.IsStrictlyPositive ())
+    {
+      return 0;
+    }
+  uint32_t bucket = Simulator::Now ().GetTimeStep () / m_overheadBucket.GetTimeStep ();
+  if (bucket >= m_overhead.size ())
+    {
+      m_overhead.resize (bucket + 1);
+    }
+  return &m_overhead[bucket];
+}
+const std::vector<HwmpProtocol::Overhead> &
+HwmpProtocol::GetOverhead () const
+{
+  return m_overhead;
+}
+HwmpProtocol::Overhead::Overhead () :
+  txPreq (0),
+  txPrep (0),
+  txPerr (0),
+  discoveries (0),
+  discoveryTime (Seconds (0)),
+  queueDrops (0)
+{
+}
 void
 HwmpProtocol::ResetStats ()
 {
   m_stats = Statistics ();
+  m_overhead.clear ();
   for (HwmpProtocolMacMap::const_iterator plugin = m_interfaces.begin (); plugin != m_interfaces.end (); plugin++)
     {
       plugin->second->ResetStats ();
@@ -1247,5 +1326,11 @@ HwmpProtocol::SetReportHwmpTcpInterfaceCallback (Callback<void,uint32_t,Time> cb
    m_reportHwmpTcpInterfaceCallback = cb;
 }
 
+void
+HwmpProtocol::SetReportPathResolvedCallback (Callback<void, Mac48Address> cb)
+{
+  m_reportPathResolvedCallback = cb;
+}
+
 } // namespace dot11s
 } // namespace ns3
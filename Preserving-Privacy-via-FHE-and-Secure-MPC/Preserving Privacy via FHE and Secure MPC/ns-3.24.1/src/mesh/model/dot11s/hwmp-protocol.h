@@ -25,6 +25,7 @@
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/traced-value.h"
+#include "ns3/mac48-address-map.h"
 #include <vector>
 #include <map>
 
@@ -83,9 +84,57 @@ public:
   void SetRoot ();
   void UnsetRoot ();
   ///\}
+  ///\name Paths installed before any discovery, e.g. along a known tree:
+  ///\{
+  /**
+   * \brief Install a path as if it had been found by a PREQ/PREP exchange
+   *
+   * The frames to the destination are forwarded at once, without a path
+   * discovery. The path is repaired like a discovered one: a broken link
+   * sends a PERR to the precursors, which removes the path, and the next
+   * frame starts a reactive discovery.
+   *
+   * \param destination the destination of the path
+   * \param retransmitter the next hop, which must be a peer of this mesh point
+   * \param interface the interface of the next hop
+   * \param metric the metric of the path
+   * \param lifetime the lifetime of the path
+   */
+  void InstallPath (Mac48Address destination, Mac48Address retransmitter, uint32_t interface,
+                    uint32_t metric, Time lifetime);
+  /**
+   * \brief Add a precursor to an installed path, it receives the PERR when the path breaks
+   *
+   * \param destination the destination of the path
+   * \param precursor the previous hop of the frames to the destination
+   * \param interface the interface of the precursor
+   * \param lifetime the lifetime of the precursor
+   */
+  void InstallPrecursor (Mac48Address destination, Mac48Address precursor, uint32_t interface, Time lifetime);
+  /// \return the routing table, e.g. to check the installed paths
+  Ptr<HwmpRtable> GetRoutingTable () const;
+  ///\}
   ///\brief Statistics:
   void Report (std::ostream &) const;
   void ResetStats ();
+
+  /// Path discovery overhead during a bucket of time, see the OverheadBucket attribute
+  struct Overhead
+  {
+    uint32_t txPreq;      ///< PREQ frames sent
+    uint32_t txPrep;      ///< PREP frames sent
+    uint32_t txPerr;      ///< PERR frames sent
+    uint32_t discoveries; ///< path discoveries which ended, resolved or not
+    Time discoveryTime;   ///< total time of these discoveries
+    uint32_t queueDrops;  ///< packets dropped while waiting for a path
+
+    Overhead ();
+  };
+  /**
+   * \return the path discovery overhead per bucket of time: the bucket i
+   *         starts at i * OverheadBucket. Empty if OverheadBucket is 0.
+   */
+  const std::vector<Overhead> & GetOverhead () const;
   
   uint16_t ReportPathError (); // 11/07/2014 by nico
   uint16_t ReportPathErrorLink (); // 11/07/2014 by nico
@@ -103,6 +152,11 @@ public:
   int64_t AssignStreams (int64_t stream);
   
   void SetReportHwmpTcpInterfaceCallback(Callback<void,uint32_t,Time> cb);
+  /**
+   * \brief Set the callback notified when a path discovery to a destination
+   * succeeds, e.g. once a broken path is repaired
+   */
+  void SetReportPathResolvedCallback (Callback<void, Mac48Address> cb);
 
 private:
   friend class HwmpProtocolMac;
@@ -184,6 +238,10 @@ private:
   //\}
   /// Route discovery time:
   TracedCallback<Time> m_routeDiscoveryTimeCallback;
+  /// Notify the end of a path discovery, resolved or not
+  void RouteDiscoveryDone (Time duration);
+  /// \return the overhead bucket of the current time, 0 if the buckets are disabled
+  Overhead * GetCurrentOverhead ();
   ///\name Methods related to Queue/Dequeue procedures
   ///\{
   bool QueuePacket (QueuedPacket packet);
@@ -250,6 +308,10 @@ private:
     Statistics ();
   };
   Statistics m_stats;
+  /// Length of the overhead buckets, 0 to disable them
+  Time m_overheadBucket;
+  /// Path discovery overhead per bucket
+  std::vector<Overhead> m_overhead;
   ///\}
   HwmpProtocolMacMap m_interfaces;
   Mac48Address m_address;
@@ -259,9 +321,9 @@ private:
   ///\name Sequence number filters
   ///\{
   /// Data sequence number database
-  std::map<Mac48Address, uint32_t> m_lastDataSeqno;
+  Mac48AddressMap<uint32_t> m_lastDataSeqno;
   /// keeps HWMP seqno (first in pair) and HWMP metric (second in pair) for each address
-  std::map<Mac48Address, std::pair<uint32_t, uint32_t> > m_hwmpSeqnoMetricDatabase;
+  Mac48AddressMap<std::pair<uint32_t, uint32_t> > m_hwmpSeqnoMetricDatabase;
   ///\}
 
   /// Routing table
@@ -306,6 +368,7 @@ private:
   Ptr<UniformRandomVariable> m_coefficient;
   Callback <std::vector<Mac48Address>, uint32_t> m_neighboursCallback;
   Callback <void, uint32_t, Time> m_reportHwmpTcpInterfaceCallback;
+  Callback <void, Mac48Address> m_reportPathResolvedCallback;
 };
 } // namespace dot11s
 } // namespace ns3
@@ -18,6 +18,7 @@
  * Author: Kirill Andreev <andreev@iitp.ru>
  */
 
+#include <algorithm>
 #include "ns3/object.h"
 #include "ns3/assert.h"
 #include "ns3/simulator.h"
@@ -40,10 +41,19 @@ HwmpRtable::GetTypeId ()
   static TypeId tid = TypeId ("ns3::dot11s::HwmpRtable")
     .SetParent<Object> ()
     .SetGroupName ("Mesh")
-    .AddConstructor<HwmpRtable> ();
+    .AddConstructor<HwmpRtable> ()
+    .AddAttribute ("ExpiredRouteRetention",
+                   "Time an expired reactive route is kept before it is removed from the table, "
+                   "0 to keep it until it is deleted. The expired routes are still used to "
+                   "build the PREQ and PERR of the destination.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&HwmpRtable::m_retention),
+                   MakeTimeChecker ());
   return tid;
 }
-HwmpRtable::HwmpRtable ()
+HwmpRtable::HwmpRtable () :
+  m_wheel (WHEEL_SIZE),
+  m_wheelTick (0)
 {
   DeleteProactivePath ();
 }
@@ -53,25 +63,24 @@ HwmpRtable::~HwmpRtable ()
 void
 HwmpRtable::DoDispose ()
 {
-  m_routes.clear ();
+  m_routes.Clear ();
+  m_wheel.clear ();
 }
 void
 HwmpRtable::AddReactivePath (Mac48Address destination, Mac48Address retransmitter, uint32_t interface,
                              uint32_t metric, Time lifetime, uint32_t seqnum)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i == m_routes.end ())
+  AdvanceWheel ();
+  ReactiveRoute &route = m_routes[destination];
+  route.retransmitter = retransmitter;
+  route.interface = interface;
+  route.metric = metric;
+  route.whenExpire = Simulator::Now () + lifetime;
+  route.seqnum = seqnum;
+  if (m_retention.IsStrictlyPositive ())
     {
-      ReactiveRoute newroute;
-      m_routes[destination] = newroute;
+      ScheduleExpiry (destination, route.whenExpire + m_retention);
     }
-  i = m_routes.find (destination);
-  NS_ASSERT (i != m_routes.end ());
-  i->second.retransmitter = retransmitter;
-  i->second.interface = interface;
-  i->second.metric = metric;
-  i->second.whenExpire = Simulator::Now () + lifetime;
-  i->second.seqnum = seqnum;
 }
 void
 HwmpRtable::AddProactivePath (uint32_t metric, Mac48Address root, Mac48Address retransmitter,
@@ -92,31 +101,18 @@ HwmpRtable::AddPrecursor (Mac48Address destination, uint32_t precursorInterface,
   precursor.interface = precursorInterface;
   precursor.address = precursorAddress;
   precursor.whenExpire = Simulator::Now () + lifetime;
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i != m_routes.end ())
+  AdvanceWheel ();
+  ReactiveRoute *route = m_routes.Find (destination);
+  if (route != 0)
     {
-      bool should_add = true;
-      for (unsigned int j = 0; j < i->second.precursors.size (); j++)
-        {
-          //NB: Only one active route may exist, so do not check
-          //interface ID, just address
-          if (i->second.precursors[j].address == precursorAddress)
-            {
-              should_add = false;
-              i->second.precursors[j].whenExpire = precursor.whenExpire;
-              break;
-            }
-        }
-      if (should_add)
-        {
-          i->second.precursors.push_back (precursor);
-        }
+      route->precursors.Add (precursor);
+      ScheduleExpiry (destination, precursor.whenExpire);
     }
 }
 void
 HwmpRtable::DeleteProactivePath ()
 {
-  m_root.precursors.clear ();
+  m_root.precursors.Clear ();
   m_root.interface = INTERFACE_ANY;
   m_root.metric = MAX_METRIC;
   m_root.retransmitter = Mac48Address::GetBroadcast ();
@@ -134,37 +130,34 @@ HwmpRtable::DeleteProactivePath (Mac48Address root)
 void
 HwmpRtable::DeleteReactivePath (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i != m_routes.end ())
-    {
-      m_routes.erase (i);
-    }
+  m_routes.Erase (destination);
 }
 HwmpRtable::LookupResult
 HwmpRtable::LookupReactive (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i == m_routes.end ())
+  const ReactiveRoute *route = m_routes.Find (destination);
+  if (route == 0)
     {
       return LookupResult ();
     }
-  if ((i->second.whenExpire < Simulator::Now ()) && (i->second.whenExpire != Seconds (0)))
+  if ((route->whenExpire < Simulator::Now ()) && (route->whenExpire != Seconds (0)))
     {
       NS_LOG_DEBUG ("Reactive route has expired, sorry.");
       return LookupResult ();
     }
-  return LookupReactiveExpired (destination);
+  return LookupResult (route->retransmitter, route->interface, route->metric, route->seqnum,
+                       route->whenExpire - Simulator::Now ());
 }
 HwmpRtable::LookupResult
 HwmpRtable::LookupReactiveExpired (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i == m_routes.end ())
+  const ReactiveRoute *route = m_routes.Find (destination);
+  if (route == 0)
     {
       return LookupResult ();
     }
-  return LookupResult (i->second.retransmitter, i->second.interface, i->second.metric, i->second.seqnum,
-                       i->second.whenExpire - Simulator::Now ());
+  return LookupResult (route->retransmitter, route->interface, route->metric, route->seqnum,
+                       route->whenExpire - Simulator::Now ());
 }
 HwmpRtable::LookupResult
 HwmpRtable::LookupProactive ()
@@ -187,16 +180,19 @@ HwmpRtable::GetUnreachableDestinations (Mac48Address peerAddress)
 {
   HwmpProtocol::FailedDestination dst;
   std::vector<HwmpProtocol::FailedDestination> retval;
-  for (std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.begin (); i != m_routes.end (); i++)
+  for (uint32_t i = 0; i < m_routes.GetCapacity (); i++)
     {
-      if (i->second.retransmitter == peerAddress)
+      if (m_routes.IsUsed (i) && m_routes.GetValue (i).retransmitter == peerAddress)
         {
-          dst.destination = i->first;
-          i->second.seqnum++;
-          dst.seqnum = i->second.seqnum;
+          ReactiveRoute &route = m_routes.GetValue (i);
+          dst.destination = m_routes.GetKey (i);
+          route.seqnum++;
+          dst.seqnum = route.seqnum;
           retval.push_back (dst);
         }
     }
+  //Keep the destinations of the PERR in address order
+  std::sort (retval.begin (), retval.end (), &HwmpRtable::CompareDestination);
   //Lookup a path to root
   if (m_root.retransmitter == peerAddress)
     {
@@ -211,21 +207,163 @@ HwmpRtable::GetPrecursors (Mac48Address destination)
 {
   //We suppose that no duplicates here can be
   PrecursorList retval;
-  std::map<Mac48Address, ReactiveRoute>::iterator route = m_routes.find (destination);
-  if (route != m_routes.end ())
+  ReactiveRoute *route = m_routes.Find (destination);
+  if (route != 0)
     {
-      for (std::vector<Precursor>::const_iterator i = route->second.precursors.begin ();
-           i != route->second.precursors.end (); i++)
+      for (uint32_t i = 0; i < route->precursors.GetSize (); i++)
         {
-          if (i->whenExpire > Simulator::Now ())
+          const Precursor &precursor = route->precursors.Get (i);
+          if (precursor.whenExpire > Simulator::Now ())
             {
-              retval.push_back (std::make_pair (i->interface, i->address));
+              retval.push_back (std::make_pair (precursor.interface, precursor.address));
             }
         }
     }
   return retval;
 }
 bool
+HwmpRtable::CompareDestination (const HwmpProtocol::FailedDestination & a,
+                                const HwmpProtocol::FailedDestination & b)
+{
+  return a.destination < b.destination;
+}
+Time
+HwmpRtable::GetWheelGranularity ()
+{
+  return MilliSeconds (100);
+}
+int64_t
+HwmpRtable::GetTick (Time when)
+{
+  //Round up: the entry is visited once it has expired
+  int64_t granularity = GetWheelGranularity ().GetTimeStep ();
+  return (when.GetTimeStep () + granularity - 1) / granularity;
+}
+void
+HwmpRtable::ScheduleExpiry (Mac48Address destination, Time when)
+{
+  WheelEntry entry;
+  entry.destination = destination;
+  entry.tick = std::max (GetTick (when), m_wheelTick + 1);
+  m_wheel[entry.tick % WHEEL_SIZE].push_back (entry);
+}
+void
+HwmpRtable::AdvanceWheel ()
+{
+  //Last tick which is over
+  int64_t now = Simulator::Now ().GetTimeStep () / GetWheelGranularity ().GetTimeStep ();
+  //Each bucket is visited once, even if the wheel has not been advanced for several turns
+  int64_t last = std::min (now, m_wheelTick + (int64_t) WHEEL_SIZE);
+  for (int64_t tick = m_wheelTick + 1; tick <= last; tick++)
+    {
+      std::vector<WheelEntry> bucket;
+      bucket.swap (m_wheel[tick % WHEEL_SIZE]);
+      for (std::vector<WheelEntry>::const_iterator i = bucket.begin (); i != bucket.end (); i++)
+        {
+          if (i->tick > now)
+            {
+              //Beyond the horizon of the wheel, wait for the next turn
+              m_wheel[tick % WHEEL_SIZE].push_back (*i);
+            }
+          else
+            {
+              PurgeExpired (i->destination);
+            }
+        }
+    }
+  m_wheelTick = std::max (m_wheelTick, now);
+}
+void
+HwmpRtable::PurgeExpired (Mac48Address destination)
+{
+  ReactiveRoute *route = m_routes.Find (destination);
+  if (route == 0)
+    {
+      return;
+    }
+  Time now = Simulator::Now ();
+  if (m_retention.IsStrictlyPositive () && route->whenExpire + m_retention <= now)
+    {
+      NS_LOG_DEBUG ("Removing the route to " << destination << ", expired at " << route->whenExpire);
+      m_routes.Erase (destination);
+      return;
+    }
+  route->precursors.RemoveExpired (now);
+}
+HwmpRtable::PrecursorSet::PrecursorSet () :
+  m_size (0)
+{
+}
+uint32_t
+HwmpRtable::PrecursorSet::GetSize () const
+{
+  return m_size;
+}
+HwmpRtable::Precursor &
+HwmpRtable::PrecursorSet::Get (uint32_t i)
+{
+  NS_ASSERT (i < m_size);
+  if (i < INLINE_PRECURSORS)
+    {
+      return m_inline[i];
+    }
+  return m_overflow[i - INLINE_PRECURSORS];
+}
+void
+HwmpRtable::PrecursorSet::Add (const Precursor & precursor)
+{
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      //NB: Only one active route may exist, so do not check
+      //interface ID, just address
+      if (Get (i).address == precursor.address)
+        {
+          Get (i).whenExpire = precursor.whenExpire;
+          return;
+        }
+    }
+  if (m_size < INLINE_PRECURSORS)
+    {
+      m_inline[m_size] = precursor;
+    }
+  else
+    {
+      m_overflow.push_back (precursor);
+    }
+  m_size++;
+}
+void
+HwmpRtable::PrecursorSet::RemoveExpired (Time now)
+{
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      if (Get (i).whenExpire > now)
+        {
+          if (kept != i)
+            {
+              Get (kept) = Get (i);
+            }
+          kept++;
+        }
+    }
+  if (kept > INLINE_PRECURSORS)
+    {
+      m_overflow.resize (kept - INLINE_PRECURSORS);
+    }
+  else
+    {
+      m_overflow.clear ();
+    }
+  m_size = kept;
+}
+void
+HwmpRtable::PrecursorSet::Clear ()
+{
+  m_overflow.clear ();
+  m_size = 0;
+}
+bool
 HwmpRtable::LookupResult::operator== (const HwmpRtable::LookupResult & o) const
 {
   return (retransmitter == o.retransmitter && ifIndex == o.ifIndex && metric == o.metric && seqnum
@@ -21,16 +21,24 @@
 #ifndef HWMP_RTABLE_H
 #define HWMP_RTABLE_H
 
-#include <map>
+#include <vector>
 #include "ns3/nstime.h"
 #include "ns3/mac48-address.h"
 #include "ns3/hwmp-protocol.h"
+#include "ns3/mac48-address-map.h"
 namespace ns3 {
 namespace dot11s {
 /**
  * \ingroup dot11s
  *
  * \brief Routing table for HWMP -- 802.11s routing protocol
+ *
+ * The reactive routes are kept in a hash table keyed by the destination,
+ * which is looked up for every forwarded frame. The expiry of the
+ * precursors (and of the routes, see the ExpiredRouteRetention attribute)
+ * is tracked by a timer wheel, which is advanced when a path or a
+ * precursor is added: the expired entries are removed in bulk, without
+ * scanning the table.
  */
 class HwmpRtable : public Object
 {
@@ -115,6 +123,27 @@ private:
     uint32_t interface;
     Time whenExpire;
   };
+  /**
+   * Precursors of a route, in the order they were added. The first ones are
+   * stored inline, most routes have only a few precursors.
+   */
+  class PrecursorSet
+  {
+public:
+    PrecursorSet ();
+    uint32_t GetSize () const;
+    Precursor & Get (uint32_t i);
+    /// Add the precursor, or refresh its expiry time if its address is known
+    void Add (const Precursor & precursor);
+    /// Remove the precursors which expired at or before now, keep the order
+    void RemoveExpired (Time now);
+    void Clear ();
+private:
+    static const uint32_t INLINE_PRECURSORS = 4;
+    Precursor m_inline[INLINE_PRECURSORS];
+    std::vector<Precursor> m_overflow;
+    uint32_t m_size;
+  };
   struct ReactiveRoute
   {
     Mac48Address retransmitter;
@@ -122,7 +151,7 @@ private:
     uint32_t metric;
     Time whenExpire;
     uint32_t seqnum;
-    std::vector<Precursor> precursors;
+    PrecursorSet precursors;
   };
   /// Route fond in proactive mode
   struct ProactiveRoute
@@ -133,13 +162,41 @@ private:
     uint32_t metric;
     Time whenExpire;
     uint32_t seqnum;
-    std::vector<Precursor> precursors;
+    PrecursorSet precursors;
+  };
+  /// Order the unreachable destinations by address
+  static bool CompareDestination (const HwmpProtocol::FailedDestination & a,
+                                  const HwmpProtocol::FailedDestination & b);
+  /// Destination to visit when the timer wheel reaches a tick
+  struct WheelEntry
+  {
+    Mac48Address destination;
+    int64_t tick;
   };
 
+  /// Number of buckets of the timer wheel
+  static const uint32_t WHEEL_SIZE = 256;
+  /// Span of a bucket of the timer wheel
+  static Time GetWheelGranularity ();
+  /// \return the tick of the timer wheel at which an expiry time is handled
+  static int64_t GetTick (Time when);
+  /// Visit the destination when the timer wheel reaches the given time
+  void ScheduleExpiry (Mac48Address destination, Time when);
+  /// Remove the entries which expired since the last call
+  void AdvanceWheel ();
+  /// Remove the expired precursors of a route, and the route itself if it is expired for longer than the retention
+  void PurgeExpired (Mac48Address destination);
+
   /// List of routes
-  std::map<Mac48Address, ReactiveRoute>  m_routes;
+  Mac48AddressMap<ReactiveRoute> m_routes;
   /// Path to proactive tree root MP
   ProactiveRoute  m_root;
+  /// Time an expired reactive route is kept, 0 to keep it until it is deleted
+  Time m_retention;
+  /// Buckets of the timer wheel
+  std::vector<std::vector<WheelEntry> > m_wheel;
+  /// Last tick handled by the timer wheel
+  int64_t m_wheelTick;
 };
 } // namespace dot11s
 } // namespace ns3
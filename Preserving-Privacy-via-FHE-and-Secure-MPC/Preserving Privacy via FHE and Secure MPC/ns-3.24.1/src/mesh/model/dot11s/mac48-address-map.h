@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MAC48_ADDRESS_MAP_H
+#define MAC48_ADDRESS_MAP_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/assert.h"
+#include "ns3/mac48-address.h"
+
+namespace ns3 {
+namespace dot11s {
+
+/**
+ * \ingroup dot11s
+ *
+ * \brief Hash table keyed by a MAC address
+ *
+ * The tables of HWMP are looked up for every forwarded frame. This table
+ * stores its entries in a single array, with open addressing and linear
+ * probing, instead of a tree of nodes: a lookup hashes the 48 bits of the
+ * address and usually reads one or two contiguous slots.
+ *
+ * The capacity is a power of two and is doubled when the table is half
+ * full. Erase shifts the following entries of the probe sequence back, so
+ * that no tombstone is left behind.
+ *
+ * The entries are visited by slot: for (i = 0; i < GetCapacity (); i++)
+ * if (IsUsed (i)) ... The order of the visit depends on the hash, not on
+ * the order of the addresses. Pointers and references to the values are
+ * invalidated by the insertion of a new address and by Erase.
+ */
+template <typename T>
+class Mac48AddressMap
+{
+public:
+  Mac48AddressMap ()
+    : m_size (0)
+  {
+  }
+
+  /**
+   * \param address the key
+   * \return the value of the key, or 0 if the key is not in the table
+   */
+  T * Find (Mac48Address address)
+  {
+    uint32_t slot;
+    if (!Probe (ToKey (address), slot))
+      {
+        return 0;
+      }
+    return &m_slots[slot].value;
+  }
+  /**
+   * \param address the key
+   * \return the value of the key, or 0 if the key is not in the table
+   */
+  const T * Find (Mac48Address address) const
+  {
+    uint32_t slot;
+    if (!Probe (ToKey (address), slot))
+      {
+        return 0;
+      }
+    return &m_slots[slot].value;
+  }
+  /**
+   * \param address the key
+   * \return the value of the key, inserted with its default value if the
+   *         key was not in the table
+   */
+  T & operator[] (Mac48Address address)
+  {
+    uint64_t key = ToKey (address);
+    uint32_t slot;
+    if (Probe (key, slot))
+      {
+        return m_slots[slot].value;
+      }
+    if (2 * (m_size + 1) > m_slots.size ())
+      {
+        Grow ();
+        Probe (key, slot);
+      }
+    m_slots[slot].used = true;
+    m_slots[slot].key = key;
+    m_slots[slot].value = T ();
+    m_size++;
+    return m_slots[slot].value;
+  }
+  /**
+   * \param address the key
+   * \return true if the key was in the table
+   */
+  bool Erase (Mac48Address address)
+  {
+    uint32_t slot;
+    if (!Probe (ToKey (address), slot))
+      {
+        return false;
+      }
+    EraseSlot (slot);
+    return true;
+  }
+  /// Remove all the entries, the capacity is released
+  void Clear ()
+  {
+    m_slots.clear ();
+    m_size = 0;
+  }
+  /// \return the number of entries
+  uint32_t GetSize () const
+  {
+    return m_size;
+  }
+  /// \return the number of slots
+  uint32_t GetCapacity () const
+  {
+    return m_slots.size ();
+  }
+  /// \return true if the slot holds an entry
+  bool IsUsed (uint32_t slot) const
+  {
+    return m_slots[slot].used;
+  }
+  /// \return the key of a used slot
+  Mac48Address GetKey (uint32_t slot) const
+  {
+    NS_ASSERT (m_slots[slot].used);
+    uint8_t buffer[6];
+    uint64_t key = m_slots[slot].key;
+    for (int i = 5; i >= 0; i--)
+      {
+        buffer[i] = key & 0xff;
+        key >>= 8;
+      }
+    Mac48Address address;
+    address.CopyFrom (buffer);
+    return address;
+  }
+  /// \return the value of a used slot
+  T & GetValue (uint32_t slot)
+  {
+    NS_ASSERT (m_slots[slot].used);
+    return m_slots[slot].value;
+  }
+
+private:
+  struct Slot
+  {
+    Slot ()
+      : key (0),
+        used (false)
+    {
+    }
+    uint64_t key;
+    bool used;
+    T value;
+  };
+
+  static uint64_t ToKey (Mac48Address address)
+  {
+    uint8_t buffer[6];
+    address.CopyTo (buffer);
+    uint64_t key = 0;
+    for (uint32_t i = 0; i < 6; i++)
+      {
+        key = (key << 8) | buffer[i];
+      }
+    return key;
+  }
+  /// \return the first slot of the probe sequence of the key
+  uint32_t Home (uint64_t key) const
+  {
+    // Fibonacci hashing: the vendor part of the addresses is often shared,
+    // the multiplication spreads the low bits over the whole word.
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (m_slots.size () - 1);
+  }
+  /**
+   * \param key the key
+   * \param slot the slot of the key if found, else the free slot where it
+   *        would be inserted (undefined if the table has no slot)
+   * \return true if the key was found
+   */
+  bool Probe (uint64_t key, uint32_t &slot) const
+  {
+    if (m_slots.empty ())
+      {
+        return false;
+      }
+    uint32_t mask = m_slots.size () - 1;
+    for (slot = Home (key); m_slots[slot].used; slot = (slot + 1) & mask)
+      {
+        if (m_slots[slot].key == key)
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+  void Grow ()
+  {
+    std::vector<Slot> old;
+    old.swap (m_slots);
+    m_slots.resize (old.empty () ? 16 : 2 * old.size ());
+    for (typename std::vector<Slot>::const_iterator i = old.begin (); i != old.end (); i++)
+      {
+        if (i->used)
+          {
+            uint32_t slot;
+            Probe (i->key, slot);
+            m_slots[slot] = *i;
+          }
+      }
+  }
+  void EraseSlot (uint32_t hole)
+  {
+    uint32_t mask = m_slots.size () - 1;
+    for (uint32_t slot = (hole + 1) & mask; m_slots[slot].used; slot = (slot + 1) & mask)
+      {
+        // The entry can fill the hole if the hole lies between its home
+        // slot and its slot, cyclically.
+        uint32_t home = Home (m_slots[slot].key);
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+          {
+            m_slots[hole] = m_slots[slot];
+            hole = slot;
+          }
+      }
+    m_slots[hole] = Slot ();
+    m_size--;
+  }
+
+  std::vector<Slot> m_slots; //!< The slots, the size is 0 or a power of two
+  uint32_t m_size;           //!< The number of used slots
+};
+
+} // namespace dot11s
+} // namespace ns3
+
+#endif /* MAC48_ADDRESS_MAP_H */
@@ -321,6 +321,11 @@ PeerManagementProtocolMac::SetBeaconShift (Time shift)
     }
   m_parent->ShiftTbtt (shift);
 }
+void
+PeerManagementProtocolMac::NotifyPeerLinkChange ()
+{
+  m_parent->ResetBeaconInterval ();
+}
 PeerManagementProtocolMac::Statistics::Statistics () :
   txOpen (0), txConfirm (0), txClose (0), rxOpen (0), rxConfirm (0), rxClose (0), dropped (0), brokenMgt (0),
   txMgt (0), txMgtBytes (0), rxMgt (0), rxMgtBytes (0), beaconShift (0)
@@ -88,6 +88,8 @@ private:
   void TxOk (WifiMacHeader const &hdr);
   /// BCA functionality
   void SetBeaconShift (Time shift);
+  /// Adaptive beaconing: a peer link opened or closed on this interface
+  void NotifyPeerLinkChange ();
   void SetPeerManagerProtcol (Ptr<PeerManagementProtocol> protocol);
   void SendPeerLinkManagementFrame (
     Mac48Address peerAddress,
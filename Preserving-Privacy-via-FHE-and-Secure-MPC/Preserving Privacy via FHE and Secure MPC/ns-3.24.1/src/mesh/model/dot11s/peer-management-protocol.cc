@@ -504,10 +504,12 @@ PeerManagementProtocol::PeerLinkStatus (uint32_t interface, Mac48Address peerAdd
   if ((nstate == PeerLink::ESTAB) && (ostate != PeerLink::ESTAB))
     {
       NotifyLinkOpen (peerMeshPointAddress, peerAddress, plugin->second->GetAddress (), interface);
+      plugin->second->NotifyPeerLinkChange ();
     }
   if ((ostate == PeerLink::ESTAB) && (nstate != PeerLink::ESTAB))
     {
       NotifyLinkClose (peerMeshPointAddress, peerAddress, plugin->second->GetAddress (), interface);
+      plugin->second->NotifyPeerLinkChange ();
     }
   if (nstate == PeerLink::IDLE)
     {
@@ -0,0 +1,326 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/mesh-link-model.h"
+#include "ns3/mesh-point-device.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MeshLinkModel");
+
+NS_OBJECT_ENSURE_REGISTERED (MeshLinkModel);
+
+TypeId
+MeshLinkModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MeshLinkModel")
+    .SetParent<Object> ()
+    .SetGroupName ("Mesh")
+    .AddConstructor<MeshLinkModel> ()
+    .AddAttribute ("Mode",
+                   "Record the frames of the mesh points, or replace the mesh by the recorded delays and losses.",
+                   EnumValue (CALIBRATE),
+                   MakeEnumAccessor (&MeshLinkModel::m_mode),
+                   MakeEnumChecker (CALIBRATE, "Calibrate",
+                                    ABSTRACT, "Abstract"))
+    .AddAttribute ("MaxSamples",
+                   "Number of delays kept per pair of mesh points, a uniform sample of the recorded ones.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&MeshLinkModel::m_maxSamples),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("DefaultDelay",
+                   "Delay of the frames in the Abstract mode when nothing was recorded.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&MeshLinkModel::m_defaultDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("InFlightTimeout",
+                   "Calibrate mode: time after which a frame sent and not received is forgotten. "
+                   "It is counted as lost, and is not delivered if received later.",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&MeshLinkModel::m_inFlightTimeout),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+MeshLinkModel::Link::Link ()
+  : sent (0),
+    delivered (0),
+    recorded (0)
+{
+}
+
+MeshLinkModel::MeshLinkModel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_random = CreateObject<UniformRandomVariable> ();
+}
+
+MeshLinkModel::~MeshLinkModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MeshLinkModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_meshPoints.clear ();
+  m_indexes.clear ();
+  m_inFlight.clear ();
+  m_sendOrder.clear ();
+  m_lastArrivals.clear ();
+  Object::DoDispose ();
+}
+
+void
+MeshLinkModel::Install (NetDeviceContainer devices)
+{
+  NS_LOG_FUNCTION (this);
+  m_meshPoints.clear ();
+  m_indexes.clear ();
+  m_inFlight.clear ();
+  m_sendOrder.clear ();
+  m_lastArrivals.clear ();
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (i));
+      NS_ASSERT_MSG (mp != 0, "The link model is installed on mesh points");
+      m_indexes[Mac48Address::ConvertFrom (mp->GetAddress ())] = i;
+      m_meshPoints.push_back (mp);
+      mp->SetLinkModel (this);
+    }
+}
+
+MeshLinkModel::Mode
+MeshLinkModel::GetMode (void) const
+{
+  return m_mode;
+}
+
+int32_t
+MeshLinkModel::GetIndex (Mac48Address address) const
+{
+  std::map<Mac48Address, uint32_t>::const_iterator i = m_indexes.find (address);
+  return i == m_indexes.end () ? -1 : (int32_t) i->second;
+}
+
+void
+MeshLinkModel::AddDelay (Link &link, Time delay)
+{
+  link.recorded++;
+  if (link.delays.size () < m_maxSamples)
+    {
+      link.delays.push_back (delay);
+      return;
+    }
+  uint32_t j = m_random->GetInteger (0, link.recorded - 1);
+  if (j < link.delays.size ())
+    {
+      link.delays[j] = delay;
+    }
+}
+
+void
+MeshLinkModel::ExpireInFlight (void)
+{
+  Time oldest = Simulator::Now () - m_inFlightTimeout;
+  while (!m_sendOrder.empty () && m_sendOrder.front ().first < oldest)
+    {
+      // already erased if it was received, or sent again since
+      std::map<uint64_t, std::pair<LinkId, Time> >::iterator i = m_inFlight.find (m_sendOrder.front ().second);
+      if (i != m_inFlight.end () && i->second.second == m_sendOrder.front ().first)
+        {
+          m_inFlight.erase (i);
+        }
+      m_sendOrder.pop_front ();
+    }
+}
+
+void
+MeshLinkModel::NotifySent (Mac48Address src, Mac48Address dst, Ptr<const Packet> packet)
+{
+  if (m_mode != CALIBRATE)
+    {
+      return;
+    }
+  int32_t from = GetIndex (src);
+  int32_t to = GetIndex (dst);
+  if (from < 0 || to < 0)
+    {
+      return;
+    }
+  ExpireInFlight ();
+  LinkId id (from, to);
+  m_links[id].sent++;
+  m_pooled.sent++;
+  m_inFlight[packet->GetUid ()] = std::make_pair (id, Simulator::Now ());
+  m_sendOrder.push_back (std::make_pair (Simulator::Now (), packet->GetUid ()));
+}
+
+void
+MeshLinkModel::NotifyReceived (Ptr<const Packet> packet)
+{
+  if (m_mode != CALIBRATE)
+    {
+      return;
+    }
+  ExpireInFlight ();
+  std::map<uint64_t, std::pair<LinkId, Time> >::iterator i = m_inFlight.find (packet->GetUid ());
+  if (i == m_inFlight.end ())
+    {
+      return;
+    }
+  Time delay = Simulator::Now () - i->second.second;
+  Link &link = m_links[i->second.first];
+  link.delivered++;
+  AddDelay (link, delay);
+  m_pooled.delivered++;
+  AddDelay (m_pooled, delay);
+  m_inFlight.erase (i);
+}
+
+bool
+MeshLinkModel::Sample (uint32_t src, uint32_t dst, bool pooled, Time &delay)
+{
+  const Link *link = &m_pooled;
+  std::map<LinkId, Link>::const_iterator i = m_links.find (LinkId (src, dst));
+  if (!pooled && i != m_links.end () && i->second.sent > 0)
+    {
+      link = &i->second;
+    }
+  if (link->sent == 0)
+    {
+      delay = m_defaultDelay;
+      return true;
+    }
+  if (m_random->GetValue () * link->sent >= link->delivered)
+    {
+      return false;
+    }
+  delay = link->delays[m_random->GetInteger (0, link->delays.size () - 1)];
+  return true;
+}
+
+void
+MeshLinkModel::Transmit (Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol)
+{
+  NS_LOG_FUNCTION (this << packet << src << dst << protocol);
+  int32_t from = GetIndex (src);
+  for (uint32_t to = 0; to < m_meshPoints.size (); to++)
+    {
+      if ((int32_t) to == from || !(dst.IsGroup () || m_meshPoints[to]->GetAddress () == dst))
+        {
+          continue;
+        }
+      Time delay;
+      // the pairs only record unicast frames
+      if (!Sample (from, to, dst.IsGroup (), delay))
+        {
+          NS_LOG_DEBUG ("Frame " << packet->GetUid () << " from " << src << " to " << dst << " lost");
+          continue;
+        }
+      Time &last = m_lastArrivals[LinkId (from, to)];
+      last = std::max (last, Simulator::Now () + delay);
+      Ptr<MeshPointDevice> mp = m_meshPoints[to];
+      Simulator::ScheduleWithContext (mp->GetNode ()->GetId (), last - Simulator::Now (),
+                                      &MeshPointDevice::ReceiveFromLinkModel, mp,
+                                      dst.IsGroup () ? packet->Copy () : packet, src, dst, protocol);
+    }
+}
+
+uint32_t
+MeshLinkModel::GetNLinks (void) const
+{
+  uint32_t n = 0;
+  for (std::map<LinkId, Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      n += i->second.sent > 0;
+    }
+  return n;
+}
+
+uint32_t
+MeshLinkModel::GetNInFlight (void) const
+{
+  return m_inFlight.size ();
+}
+
+double
+MeshLinkModel::GetDeliveryRatio (Mac48Address src, Mac48Address dst) const
+{
+  std::map<LinkId, Link>::const_iterator i = m_links.find (LinkId (GetIndex (src), GetIndex (dst)));
+  if (i == m_links.end () || i->second.sent == 0)
+    {
+      return 0;
+    }
+  return (double) i->second.delivered / i->second.sent;
+}
+
+void
+MeshLinkModel::Save (std::ostream &os) const
+{
+  // One pair per line: source, destination, frames sent and delivered,
+  // number of delays kept and the delays in nanoseconds
+  for (std::map<LinkId, Link>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      const Link &link = i->second;
+      os << i->first.first << " " << i->first.second << " " << link.sent << " " << link.delivered
+         << " " << link.delays.size ();
+      for (std::vector<Time>::const_iterator d = link.delays.begin (); d != link.delays.end (); ++d)
+        {
+          os << " " << d->GetNanoSeconds ();
+        }
+      os << std::endl;
+    }
+}
+
+void
+MeshLinkModel::Load (std::istream &is)
+{
+  uint32_t src, dst, sent, delivered, n;
+  while (is >> src >> dst >> sent >> delivered >> n)
+    {
+      Link &link = m_links[LinkId (src, dst)];
+      link.sent += sent;
+      link.delivered += delivered;
+      m_pooled.sent += sent;
+      m_pooled.delivered += delivered;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          int64_t ns;
+          is >> ns;
+          AddDelay (link, NanoSeconds (ns));
+          AddDelay (m_pooled, NanoSeconds (ns));
+        }
+    }
+}
+
+int64_t
+MeshLinkModel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_random->SetStream (stream);
+  return 1;
+}
+
+} // namespace ns3
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MESH_LINK_MODEL_H
+#define MESH_LINK_MODEL_H
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <iostream>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/mac48-address.h"
+#include "ns3/packet.h"
+#include "ns3/net-device-container.h"
+
+namespace ns3 {
+
+class MeshPointDevice;
+class UniformRandomVariable;
+
+/**
+ * \ingroup mesh
+ *
+ * \brief Calibrated abstract link layer for the mesh points of a topology
+ *
+ * From the point of view of IP, a mesh is one link between its mesh points.
+ * In the Calibrate mode, the mesh points installed on the model report the
+ * unicast frames they send and receive, and the model records, for each
+ * pair of mesh points, the number of frames sent and delivered and the
+ * delays of the delivered ones. In the Abstract mode, the mesh points hand
+ * the frames to the model instead of the mesh routing protocol and the
+ * interfaces: a frame is lost with the loss rate of its pair, or delivered
+ * to the destination mesh point after a delay drawn from the delays of the
+ * pair, without any beacon, backoff slot, ACK or path discovery event.
+ *
+ * The delays are those of the calibration runs, from MeshPointDevice::Send
+ * at the source to the reception at the destination, so they include the
+ * path discovery, the queues and the retransmissions of the mesh. The
+ * frames of a pair are delivered in order. The pairs only record unicast
+ * frames: the broadcasts, and the unicast frames of the pairs without
+ * samples, use the samples of all the pairs.
+ *
+ * The pairs are identified by the position of their mesh points in the
+ * devices given to Install, so that a model calibrated on a topology can be
+ * saved, loaded and used for another run of the same topology. The
+ * interfaces of abstract mesh points should not send beacons (see the
+ * BeaconGeneration attribute of MeshWifiInterfaceMac).
+ */
+class MeshLinkModel : public Object
+{
+public:
+  /// The modes of the model
+  enum Mode
+  {
+    CALIBRATE,
+    ABSTRACT
+  };
+
+  static TypeId GetTypeId (void);
+  MeshLinkModel ();
+  virtual ~MeshLinkModel ();
+
+  /**
+   * \brief Install the model on the mesh points of a topology, replacing
+   * the ones of a previous run
+   * \param devices the MeshPointDevices, in the same order for every run
+   */
+  void Install (NetDeviceContainer devices);
+  /// \return the current mode
+  Mode GetMode (void) const;
+
+  ///\name Calibrate mode, used by MeshPointDevice
+  // \{
+  /// A unicast frame is sent from a mesh point
+  void NotifySent (Mac48Address src, Mac48Address dst, Ptr<const Packet> packet);
+  /// A frame is received by its destination
+  void NotifyReceived (Ptr<const Packet> packet);
+  // \}
+
+  /**
+   * \brief Abstract mode: deliver a frame to its destination, or to all the
+   * other mesh points when it is a broadcast, unless it is lost. The loss
+   * and the delay of a broadcast are drawn from the samples of all the pairs.
+   */
+  void Transmit (Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol);
+
+  ///\name Calibration data
+  // \{
+  /// \return the number of pairs of mesh points with frames sent
+  uint32_t GetNLinks (void) const;
+  /// \return the number of frames sent and not yet delivered nor expired
+  uint32_t GetNInFlight (void) const;
+  /// \return the fraction of the frames sent from src to dst which were delivered
+  double GetDeliveryRatio (Mac48Address src, Mac48Address dst) const;
+  /// Write the frames sent and delivered and the delays of each pair
+  void Save (std::ostream &os) const;
+  /// Read pairs written by Save, adding them to the current ones
+  void Load (std::istream &is);
+  // \}
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  virtual void DoDispose (void);
+
+  /// Samples of a pair of mesh points
+  struct Link
+  {
+    Link ();
+    uint32_t sent;
+    uint32_t delivered;
+    uint32_t recorded; ///< delays recorded, of which at most MaxSamples are kept
+    std::vector<Time> delays;
+  };
+  /// A pair of mesh points, by position in the installed devices
+  typedef std::pair<uint32_t, uint32_t> LinkId;
+
+  /// Keep a delay of the link, a uniform sample of them once MaxSamples are kept
+  void AddDelay (Link &link, Time delay);
+  /**
+   * Draw the delay of a frame, or return false if the frame is lost
+   * \param src the position of the source
+   * \param dst the position of the destination
+   * \param pooled use the samples of all the pairs, e.g. for a broadcast
+   * \param delay the delay drawn
+   */
+  bool Sample (uint32_t src, uint32_t dst, bool pooled, Time &delay);
+  /// Forget the frames in flight for longer than InFlightTimeout, as lost
+  void ExpireInFlight (void);
+  /// \return the position of the mesh point, or -1 if not installed
+  int32_t GetIndex (Mac48Address address) const;
+
+  Mode m_mode;
+  uint32_t m_maxSamples;
+  Time m_defaultDelay;
+  Time m_inFlightTimeout;
+  /// The installed mesh points
+  std::vector<Ptr<MeshPointDevice> > m_meshPoints;
+  std::map<Mac48Address, uint32_t> m_indexes;
+  std::map<LinkId, Link> m_links;
+  /// All the pairs, used for the pairs without samples
+  Link m_pooled;
+  /// The pair and the send time of the frames in flight, by packet UID
+  std::map<uint64_t, std::pair<LinkId, Time> > m_inFlight;
+  /// The send time and the UID of the frames in flight, in send order
+  std::deque<std::pair<Time, uint64_t> > m_sendOrder;
+  /// Abstract mode: the last delivery time of each pair, to keep the frames in order
+  std::map<LinkId, Time> m_lastArrivals;
+  Ptr<UniformRandomVariable> m_random;
+};
+
+} // namespace ns3
+
+#endif /* MESH_LINK_MODEL_H */
@@ -26,6 +26,7 @@
 #include "ns3/mesh-point-device.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/mesh-wifi-interface-mac.h"
+#include "ns3/mesh-link-model.h"
 
 namespace ns3 {
 
@@ -82,6 +83,7 @@ MeshPointDevice::DoDispose ()
   m_node = 0;
   m_channel = 0;
   m_routingProtocol = 0;
+  m_linkModel = 0;
   NetDevice::DoDispose ();
 
 }
@@ -122,6 +124,10 @@ MeshPointDevice::ReceiveFromDevice (Ptr<NetDevice> incomingPort, Ptr<const Packe
       Ptr<Packet> packet_copy = packet->Copy ();
       if (m_routingProtocol->RemoveRoutingStuff (incomingPort->GetIfIndex (), src48, dst48, packet_copy, realProtocol))
         {
+          if (m_linkModel != 0)
+            {
+              m_linkModel->NotifyReceived (packet);
+            }
           m_rxCallback (this, packet_copy, realProtocol, src);
           m_rxStats.unicastData++;
           m_rxStats.unicastDataBytes += packet->GetSize ();
@@ -255,6 +261,10 @@ MeshPointDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protoco
 {
   NS_LOG_FUNCTION (this);
   const Mac48Address dst48 = Mac48Address::ConvertFrom (dest);
+  if (SendToLinkModel (packet, m_address, dst48, protocolNumber))
+    {
+      return true;
+    }
   return m_routingProtocol->RequestRoute (m_ifIndex, m_address, dst48, packet, protocolNumber, MakeCallback (
                                             &MeshPointDevice::DoSend, this));
 }
@@ -266,6 +276,10 @@ MeshPointDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address
   NS_LOG_FUNCTION (this);
   const Mac48Address src48 = Mac48Address::ConvertFrom (src);
   const Mac48Address dst48 = Mac48Address::ConvertFrom (dest);
+  if (SendToLinkModel (packet, src48, dst48, protocolNumber))
+    {
+      return true;
+    }
   return m_routingProtocol->RequestRoute (m_ifIndex, src48, dst48, packet, protocolNumber, MakeCallback (
                                             &MeshPointDevice::DoSend, this));
 }
@@ -446,6 +460,73 @@ MeshPointDevice::DoSend (bool success, Ptr<Packet> packet, Mac48Address src, Mac
         }
     }
 }
+bool
+MeshPointDevice::SendToLinkModel (Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol)
+{
+  if (m_linkModel == 0)
+    {
+      return false;
+    }
+  if (m_linkModel->GetMode () == MeshLinkModel::CALIBRATE)
+    {
+      if (!dst.IsGroup ())
+        {
+          m_linkModel->NotifySent (src, dst, packet);
+        }
+      return false;
+    }
+  Statistics * stats = ((src == m_address) ? &m_txStats : &m_fwdStats);
+  if (dst.IsBroadcast ())
+    {
+      stats->broadcastData++;
+      stats->broadcastDataBytes += packet->GetSize ();
+    }
+  else
+    {
+      stats->unicastData++;
+      stats->unicastDataBytes += packet->GetSize ();
+    }
+  m_linkModel->Transmit (packet, src, dst, protocol);
+  return true;
+}
+
+void
+MeshPointDevice::SetLinkModel (Ptr<MeshLinkModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_linkModel = model;
+}
+
+void
+MeshPointDevice::ReceiveFromLinkModel (Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol)
+{
+  NS_LOG_FUNCTION (this << packet << src << dst << protocol);
+  PacketType packetType = PACKET_HOST;
+  if (dst.IsBroadcast ())
+    {
+      packetType = PACKET_BROADCAST;
+    }
+  else if (dst.IsGroup ())
+    {
+      packetType = PACKET_MULTICAST;
+    }
+  if (!m_promiscRxCallback.IsNull ())
+    {
+      m_promiscRxCallback (this, packet, protocol, src, dst, packetType);
+    }
+  m_rxCallback (this, packet, protocol, src);
+  if (dst.IsGroup ())
+    {
+      m_rxStats.broadcastData++;
+      m_rxStats.broadcastDataBytes += packet->GetSize ();
+    }
+  else
+    {
+      m_rxStats.unicastData++;
+      m_rxStats.unicastDataBytes += packet->GetSize ();
+    }
+}
+
 MeshPointDevice::Statistics::Statistics () :
   unicastData (0), unicastDataBytes (0), broadcastData (0), broadcastDataBytes (0)
 {
@@ -30,6 +30,7 @@
 namespace ns3 {
 
 class Node;
+class MeshLinkModel;
 /**
  * \ingroup mesh
  *
@@ -85,6 +86,10 @@ public:
   void SetRoutingProtocol (Ptr<MeshL2RoutingProtocol> protocol);
   /// Access current routing protocol
   Ptr<MeshL2RoutingProtocol> GetRoutingProtocol () const;
+  /// Register the link model which records the frames, or replaces the mesh in its Abstract mode
+  void SetLinkModel (Ptr<MeshLinkModel> model);
+  /// Receive a frame delivered by the link model in its Abstract mode
+  void ReceiveFromLinkModel (Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol);
   //\}
 
   // Inherited from NetDevice
@@ -144,6 +149,11 @@ private:
   void
   DoSend (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol,
           uint32_t iface);
+  /**
+   * \brief Report a frame to the link model, or hand it over in the Abstract mode
+   * \return true if the frame was handed over, instead of the routing protocol
+   */
+  bool SendToLinkModel (Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol);
 
 private:
   /// Receive action
@@ -164,6 +174,8 @@ private:
   Ptr<BridgeChannel> m_channel;
   /// Current routing protocol, used mainly by GetRoutingProtocol
   Ptr<MeshL2RoutingProtocol> m_routingProtocol;
+  /// Link model, if any
+  Ptr<MeshLinkModel> m_linkModel;
 
   ///\name Device statistics counters
   ///\{
@@ -33,6 +33,7 @@
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/pointer.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/qos-tag.h"
 
@@ -57,6 +58,34 @@ MeshWifiInterfaceMac::GetTypeId ()
                       &MeshWifiInterfaceMac::m_beaconInterval),
                     MakeTimeChecker ()
                     )
+    .AddAttribute ( "AdaptiveBeaconing",
+                    "Double the beacon interval while the peer links are stable, up to MaxBeaconInterval, "
+                    "and go back to BeaconInterval when a peer link opens or closes. Trade-off: the peers "
+                    "detect the loss of this mesh point after ns3::dot11s::PeerLink::MaxBeaconLoss times "
+                    "the current interval, e.g. 8 s instead of 1 s with the default values, so a broken "
+                    "link is kept longer while the interval is long.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (
+                      &MeshWifiInterfaceMac::m_adaptiveBeaconing),
+                    MakeBooleanChecker ()
+                    )
+    .AddAttribute ( "MaxBeaconInterval",
+                    "Longest beacon interval when beaconing is adaptive. It bounds the time the peers "
+                    "take to detect a beacon loss, MaxBeaconLoss times this interval, so keep it short "
+                    "when the links break often. The beacon frame holds at most 65535 TU.",
+                    TimeValue (Seconds (4)),
+                    MakeTimeAccessor (
+                      &MeshWifiInterfaceMac::m_maxBeaconInterval),
+                    MakeTimeChecker ()
+                    )
+    .AddAttribute ( "StableBeacons",
+                    "Number of beacons sent without peer link change before the beacon interval doubles, "
+                    "when beaconing is adaptive.",
+                    UintegerValue (10),
+                    MakeUintegerAccessor (
+                      &MeshWifiInterfaceMac::m_stableBeaconCount),
+                    MakeUintegerChecker<uint32_t> (1)
+                    )
     .AddAttribute ( "RandomStart",
                     "Window when beacon generating starts (uniform random) in seconds",
                     TimeValue (Seconds (0.5)),
@@ -75,7 +104,9 @@ MeshWifiInterfaceMac::GetTypeId ()
   return tid;
 }
 MeshWifiInterfaceMac::MeshWifiInterfaceMac ()
-  : m_standard (WIFI_PHY_STANDARD_80211a)
+  : m_stableBeacons (0),
+    m_beaconIntervalFactor (1),
+    m_standard (WIFI_PHY_STANDARD_80211a)
 {
   NS_LOG_FUNCTION (this);
 
@@ -360,7 +391,40 @@ MeshWifiInterfaceMac::SetBeaconInterval (Time interval)
 Time
 MeshWifiInterfaceMac::GetBeaconInterval () const
 {
-  return m_beaconInterval;
+  return m_beaconInterval * static_cast<int64_t> (m_beaconIntervalFactor);
+}
+void
+MeshWifiInterfaceMac::UpdateBeaconInterval ()
+{
+  if (!m_adaptiveBeaconing || ++m_stableBeacons < m_stableBeaconCount)
+    {
+      return;
+    }
+  m_stableBeacons = 0;
+  if (GetBeaconInterval () * 2 <= m_maxBeaconInterval)
+    {
+      m_beaconIntervalFactor *= 2;
+      NS_LOG_DEBUG (GetAddress () << " beacon interval is now " << GetBeaconInterval ());
+    }
+}
+void
+MeshWifiInterfaceMac::ResetBeaconInterval ()
+{
+  NS_LOG_FUNCTION (this);
+  m_stableBeacons = 0;
+  if (m_beaconIntervalFactor == 1)
+    {
+      return;
+    }
+  m_beaconIntervalFactor = 1;
+  NS_LOG_DEBUG (GetAddress () << " beacon interval is now " << GetBeaconInterval ());
+  // Do not wait for the end of the long interval announced in the last beacon
+  if (m_beaconSendEvent.IsRunning () && (m_tbtt > Simulator::Now () + m_beaconInterval))
+    {
+      m_tbtt = Simulator::Now () + m_beaconInterval;
+      m_beaconSendEvent.Cancel ();
+      m_beaconSendEvent = Simulator::Schedule (m_beaconInterval, &MeshWifiInterfaceMac::SendBeacon, this);
+    }
 }
 void
 MeshWifiInterfaceMac::SetBeaconGeneration (bool enable)
@@ -404,8 +468,13 @@ MeshWifiInterfaceMac::SendBeacon ()
 
   NS_ASSERT (!m_beaconSendEvent.IsRunning ());
 
+  // The beacon announces the interval until the next one
+  UpdateBeaconInterval ();
+  m_stats.sentBeacons++;
+  m_stats.savedBeacons += m_beaconIntervalFactor - 1;
+
   // Form & send beacon
-  MeshWifiBeacon beacon (GetSsid (), GetSupportedRates (), m_beaconInterval.GetMicroSeconds ());
+  MeshWifiBeacon beacon (GetSsid (), GetSupportedRates (), GetBeaconInterval ().GetMicroSeconds ());
 
   // Ask all plugins to add their specific information elements to beacon
   for (PluginList::const_iterator i = m_plugins.begin (); i != m_plugins.end (); ++i)
@@ -510,6 +579,8 @@ MeshWifiInterfaceMac::GetMeshPointAddress () const
 //Statistics:
 MeshWifiInterfaceMac::Statistics::Statistics ()
   : recvBeacons (0),
+    sentBeacons (0),
+    savedBeacons (0),
     sentFrames (0),
     sentBytes (0),
     recvFrames (0),
@@ -520,7 +591,8 @@ void
 MeshWifiInterfaceMac::Statistics::Print (std::ostream & os) const
 {
   os << "<Statistics "
-    /// \todo txBeacons
+    "txBeacons=\"" << sentBeacons << "\" "
+    "savedBeacons=\"" << savedBeacons << "\" "
     "rxBeacons=\"" << recvBeacons << "\" "
     "txFrames=\"" << sentFrames << "\" "
     "txBytes=\"" << sentBytes << "\" "
@@ -77,8 +77,19 @@ public:
   void SetRandomStartDelay (Time interval);
   /// Set interval between two successive beacons
   void SetBeaconInterval (Time interval);
-  /// \return interval between two beacons
+  /// \return interval between two beacons, the current one when adaptive
   Time GetBeaconInterval () const;
+  /**
+   * \brief Go back to the short beacon interval (BeaconInterval attribute)
+   *
+   * When beaconing is adaptive (AdaptiveBeaconing attribute), the interval
+   * doubles after StableBeacons beacons, up to MaxBeaconInterval. This is
+   * supposed to be used by the peer management protocol, when a peer link
+   * opens or closes, so that the peers can find each other quickly. While
+   * the interval is long, the peers also take longer to detect a beacon
+   * loss, MaxBeaconLoss times the interval announced in the last beacon.
+   */
+  void ResetBeaconInterval ();
   /**
    * \brief Next beacon frame time
    *
@@ -153,6 +164,8 @@ private:
   void SendBeacon ();
   /// Schedule next beacon
   void ScheduleNextBeacon ();
+  /// Double the beacon interval when adaptive and stable for long enough
+  void UpdateBeaconInterval ();
   /// Get current beaconing status
   bool GetBeaconGeneration () const;
   /// Real d-tor
@@ -169,6 +182,16 @@ private:
   bool m_beaconEnable;
   /// Beaconing interval.
   Time m_beaconInterval;
+  /// whether the beacon interval grows while the peer links are stable
+  bool m_adaptiveBeaconing;
+  /// Longest beacon interval when adaptive
+  Time m_maxBeaconInterval;
+  /// Number of beacons without peer link change before the interval doubles
+  uint32_t m_stableBeaconCount;
+  /// Beacons sent at the current interval, since the last peer link change
+  uint32_t m_stableBeacons;
+  /// Current beacon interval, in multiples of m_beaconInterval
+  uint32_t m_beaconIntervalFactor;
   /// Maximum delay before first beacon
   Time m_randomStart;
   /// Time for the next frame
@@ -188,6 +211,8 @@ private:
   struct Statistics
   {
     uint16_t recvBeacons;
+    uint32_t sentBeacons;
+    uint32_t savedBeacons; ///< beacons not sent, compared to the short interval
     uint32_t sentFrames;
     uint32_t sentBytes;
     uint32_t recvFrames;
@@ -17,14 +17,30 @@
  *
  * Author: Pavel Boyko <boyko@iitp.ru>
  */
+#include <map>
 #include "ns3/test.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mgt-headers.h"
 #include "ns3/dot11s-mac-header.h"
 #include "ns3/hwmp-rtable.h"
+#include "ns3/hwmp-protocol.h"
+#include "ns3/dot11s-installer.h"
+#include "ns3/mac48-address-map.h"
+#include "ns3/nstime.h"
 #include "ns3/peer-link-frame.h"
 #include "ns3/ie-dot11s-peer-management.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/mesh-point-device.h"
+#include "ns3/mesh-wifi-interface-mac.h"
+#include "ns3/peer-management-protocol.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mobility-model.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
 
 using namespace ns3;
 using namespace dot11s;
@@ -202,6 +218,154 @@ HwmpRtableTest::DoRun ()
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+/// Unit test for Mac48AddressMap
+struct Mac48AddressMapTest : public TestCase
+{
+  Mac48AddressMapTest () :
+    TestCase ("MAC address hash table")
+  {
+  }
+  virtual void DoRun ();
+};
+
+void
+Mac48AddressMapTest::DoRun ()
+{
+  Mac48AddressMap<uint32_t> table;
+  std::map<Mac48Address, uint32_t> reference;
+  uint8_t buffer[6] = { 0x00, 0x11, 0x22, 0x00, 0x00, 0x00 };
+  // Addresses which share the vendor part and collide in the low bits
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      buffer[4] = (i * 7) >> 8;
+      buffer[5] = (i * 7) & 0xff;
+      Mac48Address address;
+      address.CopyFrom (buffer);
+      table[address] = i;
+      reference[address] = i;
+    }
+  // Erase every third address, the probe sequences of the others must stay intact
+  uint32_t n = 0;
+  for (std::map<Mac48Address, uint32_t>::iterator i = reference.begin (); i != reference.end (); n++)
+    {
+      if (n % 3 == 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (table.Erase (i->first), true, "Erase finds the address");
+          reference.erase (i++);
+        }
+      else
+        {
+          i++;
+        }
+    }
+  uint32_t size = table.GetSize ();
+  NS_TEST_EXPECT_MSG_EQ (size, reference.size (), "Size follows the insertions and erasures");
+  for (std::map<Mac48Address, uint32_t>::const_iterator i = reference.begin (); i != reference.end (); i++)
+    {
+      uint32_t *value = table.Find (i->first);
+      NS_TEST_ASSERT_MSG_EQ ((value != 0), true, "Lookup after erasure works");
+      NS_TEST_EXPECT_MSG_EQ (*value, i->second, "Lookup after erasure works");
+    }
+  uint32_t visited = 0;
+  for (uint32_t i = 0; i < table.GetCapacity (); i++)
+    {
+      if (table.IsUsed (i))
+        {
+          Mac48Address key = table.GetKey (i);
+          NS_TEST_EXPECT_MSG_EQ ((reference.find (key) != reference.end ()), true, "Iteration returns the keys");
+          visited++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (visited, reference.size (), "Iteration visits every entry");
+  NS_TEST_EXPECT_MSG_EQ (table.Erase (Mac48Address ("00:11:22:ff:ff:ff")), false, "Erase of a missing address");
+  NS_TEST_EXPECT_MSG_EQ ((table.Find (Mac48Address ("00:11:22:ff:ff:ff")) == 0), true, "Lookup of a missing address");
+}
+//-----------------------------------------------------------------------------
+/// Unit test for the bulk expiry of HwmpRtable
+class HwmpRtableExpiryTest : public TestCase
+{
+public:
+  HwmpRtableExpiryTest ();
+  virtual void DoRun ();
+
+private:
+  void AddPaths ();
+  /// Check the precursors once the first ones have expired
+  void CheckPrecursors ();
+  /// Check that the routes expired for longer than the retention are removed
+  void CheckRetention ();
+
+  Ptr<HwmpRtable> table;
+  std::vector<Mac48Address> precursors;
+};
+
+HwmpRtableExpiryTest::HwmpRtableExpiryTest () :
+  TestCase ("HWMP routing table bulk expiry")
+{
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      uint8_t buffer[6] = { 0x00, 0x10, 0x00, 0x00, 0x00, (uint8_t) i };
+      Mac48Address address;
+      address.CopyFrom (buffer);
+      precursors.push_back (address);
+    }
+}
+
+void
+HwmpRtableExpiryTest::AddPaths ()
+{
+  table->AddReactivePath (Mac48Address ("01:00:00:01:00:01"), Mac48Address ("01:00:00:01:00:03"),
+                          1, 10, Seconds (5), 1);
+  table->AddReactivePath (Mac48Address ("01:00:00:01:00:02"), Mac48Address ("01:00:00:01:00:03"),
+                          1, 10, Seconds (20), 1);
+  // More precursors than are stored inline, the odd ones expire first
+  for (uint32_t i = 0; i < precursors.size (); i++)
+    {
+      table->AddPrecursor (Mac48Address ("01:00:00:01:00:02"), i, precursors[i],
+                           Seconds (i % 2 ? 2 : 10));
+    }
+}
+
+void
+HwmpRtableExpiryTest::CheckPrecursors ()
+{
+  // Advances the timer wheel, which drops the expired precursors
+  table->AddReactivePath (Mac48Address ("01:00:00:01:00:09"), Mac48Address ("01:00:00:01:00:03"),
+                          1, 10, Seconds (20), 1);
+  HwmpRtable::PrecursorList precursorList = table->GetPrecursors (Mac48Address ("01:00:00:01:00:02"));
+  NS_TEST_ASSERT_MSG_EQ (precursorList.size (), precursors.size () / 2, "Expired precursors are removed");
+  for (uint32_t i = 0; i < precursorList.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (precursorList[i].second, precursors[2 * i], "Precursors keep their order");
+    }
+}
+
+void
+HwmpRtableExpiryTest::CheckRetention ()
+{
+  bool expired = table->LookupReactiveExpired (Mac48Address ("01:00:00:01:00:01")).IsValid ();
+  NS_TEST_EXPECT_MSG_EQ (expired, true, "Expired route is kept during the retention");
+  table->AddPrecursor (Mac48Address ("01:00:00:01:00:02"), 1, precursors[0], Seconds (10));
+  expired = table->LookupReactiveExpired (Mac48Address ("01:00:00:01:00:01")).IsValid ();
+  NS_TEST_EXPECT_MSG_EQ (expired, false, "Expired route is removed after the retention");
+  bool valid = table->LookupReactive (Mac48Address ("01:00:00:01:00:02")).IsValid ();
+  NS_TEST_EXPECT_MSG_EQ (valid, true, "Valid route is kept");
+}
+
+void
+HwmpRtableExpiryTest::DoRun ()
+{
+  table = CreateObject<HwmpRtable> ();
+  table->SetAttribute ("ExpiredRouteRetention", TimeValue (Seconds (3)));
+
+  Simulator::Schedule (Seconds (1), &HwmpRtableExpiryTest::AddPaths, this);
+  Simulator::Schedule (Seconds (4), &HwmpRtableExpiryTest::CheckPrecursors, this);
+  Simulator::Schedule (Seconds (9.5), &HwmpRtableExpiryTest::CheckRetention, this);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
 /// Built-in self test for PeerLinkFrameStart
 struct PeerLinkFrameStartTest : public TestCase
 {
@@ -252,6 +416,320 @@ PeerLinkFrameStartTest::DoRun ()
   }
 }
 //-----------------------------------------------------------------------------
+/// Adaptive beaconing: the interval grows while the peer link is up and
+/// goes back to the short one when the link is lost
+class AdaptiveBeaconTest : public TestCase
+{
+public:
+  AdaptiveBeaconTest ();
+  virtual void DoRun ();
+
+private:
+  /// Check the long interval once the link is stable, then move a node away
+  void CheckStable ();
+  /// LinkClose trace sink
+  void LinkClose (Mac48Address myIface, Mac48Address peerIface);
+  /// Check the short interval of an interface once its link is lost
+  void CheckReset (Mac48Address myIface);
+
+  NodeContainer m_nodes;
+  NetDeviceContainer m_devices;
+  std::vector<Ptr<MeshWifiInterfaceMac> > m_macs;
+  uint32_t m_linksClosed;
+};
+
+AdaptiveBeaconTest::AdaptiveBeaconTest () :
+  TestCase ("Adaptive beacon interval"),
+  m_linksClosed (0)
+{
+}
+
+void
+AdaptiveBeaconTest::CheckStable ()
+{
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<PeerManagementProtocol> pmp = m_devices.Get (i)->GetObject<PeerManagementProtocol> ();
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t) pmp->GetNumberOfLinks (), 1, "The peer link should stay up");
+      NS_TEST_EXPECT_MSG_EQ (m_macs[i]->GetBeaconInterval (), Seconds (4), "The longest interval expected");
+    }
+  m_nodes.Get (1)->GetObject<MobilityModel> ()->SetPosition (Vector (1000, 0, 0));
+}
+
+void
+AdaptiveBeaconTest::LinkClose (Mac48Address myIface, Mac48Address peerIface)
+{
+  m_linksClosed++;
+  Simulator::ScheduleNow (&AdaptiveBeaconTest::CheckReset, this, myIface);
+}
+
+void
+AdaptiveBeaconTest::CheckReset (Mac48Address myIface)
+{
+  for (uint32_t i = 0; i < m_macs.size (); i++)
+    {
+      if (m_macs[i]->GetAddress () == myIface)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_macs[i]->GetBeaconInterval (), Seconds (0.5), "The short interval expected");
+        }
+    }
+}
+
+void
+AdaptiveBeaconTest::DoRun ()
+{
+  m_nodes.Create (2);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (50),
+                                 "GridWidth", UintegerValue (2));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (m_nodes);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)),
+                   "AdaptiveBeaconing", BooleanValue (true),
+                   "MaxBeaconInterval", TimeValue (Seconds (4)),
+                   "StableBeacons", UintegerValue (20));
+  m_devices = mesh.Install (wifiPhy, m_nodes);
+  for (uint32_t i = 0; i < m_devices.GetN (); i++)
+    {
+      Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (m_devices.Get (i));
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (mp->GetInterfaces ()[0]);
+      m_macs.push_back (DynamicCast<MeshWifiInterfaceMac> (device->GetMac ()));
+      mp->GetObject<PeerManagementProtocol> ()->TraceConnectWithoutContext (
+        "LinkClose", MakeCallback (&AdaptiveBeaconTest::LinkClose, this));
+    }
+
+  // 20 beacons at 0.5 s, 1 s and 2 s: the interval is 4 s after about 70 s.
+  // Once the node has moved away, the link is lost at the latest after 20
+  // beacon intervals.
+  Simulator::Schedule (Seconds (100), &AdaptiveBeaconTest::CheckStable, this);
+  Simulator::Stop (Seconds (190));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_linksClosed, 2, "The link should be lost at both ends");
+  Simulator::Destroy ();
+  m_macs.clear ();
+}
+//-----------------------------------------------------------------------------
+/// Paths installed along a tree: the reactive routes of each mesh point,
+/// their lifetime, and the rejection of a tree with a cycle
+class HwmpTreePathsTest : public TestCase
+{
+public:
+  HwmpTreePathsTest ();
+  virtual void DoRun ();
+
+private:
+  /// Check the routes and precursors installed along the tree
+  void CheckPaths ();
+  /// Check that the routes have expired, and that a tree with a cycle installs nothing
+  void CheckExpiry ();
+  /// \return the routing table of a mesh point
+  Ptr<HwmpRtable> GetTable (uint32_t i);
+  /// \return the address of a mesh point
+  Mac48Address GetAddress (uint32_t i);
+
+  NodeContainer m_nodes;
+  NetDeviceContainer m_devices;
+};
+
+HwmpTreePathsTest::HwmpTreePathsTest () :
+  TestCase ("HWMP paths installed along a tree")
+{
+}
+
+Ptr<HwmpRtable>
+HwmpTreePathsTest::GetTable (uint32_t i)
+{
+  return m_devices.Get (i)->GetObject<HwmpProtocol> ()->GetRoutingTable ();
+}
+
+Mac48Address
+HwmpTreePathsTest::GetAddress (uint32_t i)
+{
+  return Mac48Address::ConvertFrom (m_devices.Get (i)->GetAddress ());
+}
+
+void
+HwmpTreePathsTest::CheckPaths ()
+{
+  uint32_t interface = DynamicCast<MeshPointDevice> (m_devices.Get (2))->GetInterfaces ()[0]->GetIfIndex ();
+  // Up the tree, from a leaf to the root through its parent
+  HwmpRtable::LookupResult result = GetTable (2)->LookupReactive (GetAddress (0));
+  NS_TEST_EXPECT_MSG_EQ (result.retransmitter, GetAddress (1), "The next hop to the root is the parent");
+  NS_TEST_EXPECT_MSG_EQ (result.ifIndex, interface, "The path uses the first interface");
+  NS_TEST_EXPECT_MSG_EQ (result.metric, 2, "The metric is the number of hops");
+  NS_TEST_EXPECT_MSG_EQ (result.lifetime, Seconds (9), "The lifetime is counted from the installation");
+  result = GetTable (1)->LookupReactive (GetAddress (0));
+  NS_TEST_EXPECT_MSG_EQ (result.retransmitter, GetAddress (0), "The parent reaches the root directly");
+  NS_TEST_EXPECT_MSG_EQ (result.metric, 1, "The metric is the number of hops");
+  // Down the tree, from the root to a leaf
+  result = GetTable (0)->LookupReactive (GetAddress (3));
+  NS_TEST_EXPECT_MSG_EQ (result.retransmitter, GetAddress (1), "The next hop to the leaf is its parent");
+  NS_TEST_EXPECT_MSG_EQ (result.metric, 2, "The metric is the number of hops");
+  // The leaves are not ancestors of each other
+  NS_TEST_EXPECT_MSG_EQ (GetTable (2)->LookupReactive (GetAddress (3)).IsValid (), false,
+                         "No path between the leaves");
+  // The intermediate mesh point sends a PERR to both leaves when the root is lost
+  HwmpRtable::PrecursorList precursors = GetTable (1)->GetPrecursors (GetAddress (0));
+  NS_TEST_ASSERT_MSG_EQ (precursors.size (), 2, "Both leaves are precursors of the path to the root");
+  NS_TEST_EXPECT_MSG_EQ (precursors[0].second, GetAddress (2), "The first leaf is a precursor");
+  NS_TEST_EXPECT_MSG_EQ (precursors[1].second, GetAddress (3), "The second leaf is a precursor");
+}
+
+void
+HwmpTreePathsTest::CheckExpiry ()
+{
+  NS_TEST_EXPECT_MSG_EQ (GetTable (2)->LookupReactive (GetAddress (0)).IsValid (), false,
+                         "The path expires after its lifetime");
+  std::map<uint32_t, uint32_t> parents;
+  parents[1] = 0;
+  parents[2] = 3;
+  parents[3] = 2;
+  bool installed = Dot11sStack::InstallTreePaths (m_devices, parents, Seconds (10));
+  NS_TEST_EXPECT_MSG_EQ (installed, false, "A tree with a cycle is rejected");
+  NS_TEST_EXPECT_MSG_EQ (GetTable (1)->LookupReactive (GetAddress (0)).IsValid (), false,
+                         "No path is installed from a tree with a cycle");
+}
+
+void
+HwmpTreePathsTest::DoRun ()
+{
+  m_nodes.Create (4);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (50),
+                                 "GridWidth", UintegerValue (4));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (m_nodes);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  m_devices = mesh.Install (wifiPhy, m_nodes);
+
+  // The root 0, its child 1, and the leaves 2 and 3 under 1
+  std::map<uint32_t, uint32_t> parents;
+  parents[1] = 0;
+  parents[2] = 1;
+  parents[3] = 1;
+  bool installed = Dot11sStack::InstallTreePaths (m_devices, parents, Seconds (10));
+  NS_TEST_ASSERT_MSG_EQ (installed, true, "A tree is installed");
+
+  Simulator::Schedule (Seconds (1), &HwmpTreePathsTest::CheckPaths, this);
+  Simulator::Schedule (Seconds (11), &HwmpTreePathsTest::CheckExpiry, this);
+  Simulator::Stop (Seconds (12));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
+/// Path discovery overhead counted in the buckets of time of the
+/// OverheadBucket attribute: the PREQ, PREP and PERR frames sent, and the
+/// path discoveries, in the bucket of the time they happen
+class HwmpOverheadTest : public TestCase
+{
+public:
+  HwmpOverheadTest ();
+  virtual void DoRun ();
+
+private:
+  /// Send a frame from the first mesh point of the chain to the last one
+  void SendFrame ();
+  /// Move the last mesh point of the chain out of range
+  void MoveAway ();
+  /// \return the overhead of a mesh point summed over the buckets [first, last)
+  HwmpProtocol::Overhead GetOverhead (uint32_t node, uint32_t first, uint32_t last);
+
+  NodeContainer m_nodes;
+  NetDeviceContainer m_devices;
+};
+
+HwmpOverheadTest::HwmpOverheadTest () :
+  TestCase ("HWMP path discovery overhead per bucket of time")
+{
+}
+
+void
+HwmpOverheadTest::SendFrame ()
+{
+  m_devices.Get (0)->Send (Create<Packet> (100), m_devices.Get (2)->GetAddress (), 0x0800);
+}
+
+void
+HwmpOverheadTest::MoveAway ()
+{
+  m_nodes.Get (2)->GetObject<MobilityModel> ()->SetPosition (Vector (1000, 0, 0));
+}
+
+HwmpProtocol::Overhead
+HwmpOverheadTest::GetOverhead (uint32_t node, uint32_t first, uint32_t last)
+{
+  const std::vector<HwmpProtocol::Overhead> &buckets = m_devices.Get (node)->GetObject<HwmpProtocol> ()->GetOverhead ();
+  HwmpProtocol::Overhead sum;
+  for (uint32_t b = first; b < last && b < buckets.size (); b++)
+    {
+      sum.txPreq += buckets[b].txPreq;
+      sum.txPrep += buckets[b].txPrep;
+      sum.txPerr += buckets[b].txPerr;
+      sum.discoveries += buckets[b].discoveries;
+      sum.discoveryTime += buckets[b].discoveryTime;
+    }
+  return sum;
+}
+
+void
+HwmpOverheadTest::DoRun ()
+{
+  // A chain of three mesh points, the ends are out of range of each other
+  m_nodes.Create (3);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (100),
+                                 "GridWidth", UintegerValue (3));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (m_nodes);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)));
+  Config::SetDefault ("ns3::dot11s::HwmpProtocol::OverheadBucket", TimeValue (Seconds (1)));
+  m_devices = mesh.Install (wifiPhy, m_nodes);
+  Config::SetDefault ("ns3::dot11s::HwmpProtocol::OverheadBucket", TimeValue (Seconds (0)));
+  mesh.AssignStreams (m_devices, 0);
+
+  // The path discovery of the first frame starts in the bucket 5, the
+  // broken link is found in the buckets from 10 on
+  Simulator::Schedule (Seconds (5.5), &HwmpOverheadTest::SendFrame, this);
+  Simulator::Schedule (Seconds (10), &HwmpOverheadTest::MoveAway, this);
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+
+  HwmpProtocol::Overhead before = GetOverhead (0, 0, 5);
+  NS_TEST_EXPECT_MSG_EQ (before.txPreq + before.discoveries, 0, "No path discovery before the first frame");
+  HwmpProtocol::Overhead source = GetOverhead (0, 5, 6);
+  NS_TEST_EXPECT_MSG_GT (source.txPreq, 0, "The source sends a PREQ in the bucket of the frame");
+  NS_TEST_EXPECT_MSG_EQ (source.discoveries, 1, "The discovery ends in the bucket of the frame");
+  NS_TEST_EXPECT_MSG_GT (source.discoveryTime, Seconds (0), "The discovery takes time");
+  HwmpProtocol::Overhead destination = GetOverhead (2, 5, 6);
+  NS_TEST_EXPECT_MSG_GT (destination.txPrep, 0, "The destination sends a PREP in the bucket of the frame");
+  HwmpProtocol::Overhead relay = GetOverhead (1, 0, 10);
+  NS_TEST_EXPECT_MSG_EQ (relay.txPerr, 0, "No PERR while the links are up");
+  relay = GetOverhead (1, 10, 20);
+  NS_TEST_EXPECT_MSG_GT (relay.txPerr, 0, "The relay sends a PERR to the source once the link is broken");
+
+  m_devices.Get (0)->GetObject<HwmpProtocol> ()->ResetStats ();
+  NS_TEST_EXPECT_MSG_EQ (m_devices.Get (0)->GetObject<HwmpProtocol> ()->GetOverhead ().size (), 0,
+                         "The buckets are cleared with the statistics");
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
 class Dot11sTestSuite : public TestSuite
 {
 public:
@@ -263,7 +741,12 @@ Dot11sTestSuite::Dot11sTestSuite ()
 {
   AddTestCase (new MeshHeaderTest, TestCase::QUICK);
   AddTestCase (new HwmpRtableTest, TestCase::QUICK);
+  AddTestCase (new Mac48AddressMapTest, TestCase::QUICK);
+  AddTestCase (new HwmpRtableExpiryTest, TestCase::QUICK);
   AddTestCase (new PeerLinkFrameStartTest, TestCase::QUICK);
+  AddTestCase (new AdaptiveBeaconTest, TestCase::QUICK);
+  AddTestCase (new HwmpTreePathsTest, TestCase::QUICK);
+  AddTestCase (new HwmpOverheadTest, TestCase::QUICK);
 }
 
 static Dot11sTestSuite g_dot11sTestSuite;
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/mesh-point-device.h"
+#include "ns3/mesh-link-model.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+
+namespace ns3 {
+
+/// Protocol number of the test frames
+static const uint16_t PROTOCOL = 0x88b5;
+
+/**
+ * \brief Check the frames recorded by MeshLinkModel from a mesh, and the
+ * frames delivered from recorded delays and losses in the Abstract mode
+ */
+class MeshLinkModelTestCase : public TestCase
+{
+public:
+  /**
+   * \param mode the mode of the model
+   */
+  MeshLinkModelTestCase (MeshLinkModel::Mode mode);
+private:
+  virtual void DoRun (void);
+  /// Three mesh points in a line, 100 m apart
+  void CreateMesh (bool beacons);
+  void Send (uint32_t from, Mac48Address to, uint32_t seq);
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+
+  MeshLinkModel::Mode m_mode;
+  NodeContainer m_nodes;
+  NetDeviceContainer m_devices;
+  std::vector<Time> m_sendTimes;
+  std::vector<uint32_t> m_received; //!< frames received, by mesh point
+  uint32_t m_lastSeq;               //!< last frame received by the last mesh point
+  bool m_inOrder;
+  bool m_delaysRecorded;            //!< the delays are among the recorded ones
+};
+
+MeshLinkModelTestCase::MeshLinkModelTestCase (MeshLinkModel::Mode mode)
+  : TestCase (mode == MeshLinkModel::CALIBRATE ? "Check the frames recorded by the link model"
+              : "Check the frames delivered by the abstract link model"),
+    m_mode (mode),
+    m_received (3, 0),
+    m_lastSeq (0),
+    m_inOrder (true),
+    m_delaysRecorded (true)
+{
+}
+
+void
+MeshLinkModelTestCase::CreateMesh (bool beacons)
+{
+  m_nodes.Create (3);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (100),
+                                 "GridWidth", UintegerValue (3));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (m_nodes);
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)),
+                   "BeaconGeneration", BooleanValue (beacons));
+  m_devices = mesh.Install (wifiPhy, m_nodes);
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      m_nodes.Get (i)->RegisterProtocolHandler (MakeCallback (&MeshLinkModelTestCase::Receive, this),
+                                                PROTOCOL, m_devices.Get (i));
+    }
+}
+
+void
+MeshLinkModelTestCase::Send (uint32_t from, Mac48Address to, uint32_t seq)
+{
+  m_sendTimes.push_back (Simulator::Now ());
+  m_devices.Get (from)->Send (Create<Packet> ((uint8_t *) &seq, sizeof (seq)), to, PROTOCOL);
+}
+
+void
+MeshLinkModelTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
+                                const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  for (uint32_t i = 0; i < m_devices.GetN (); i++)
+    {
+      if (m_devices.Get (i) == device)
+        {
+          m_received[i]++;
+        }
+    }
+  if (device != m_devices.Get (2) || packetType != NetDevice::PACKET_HOST)
+    {
+      return;
+    }
+  uint32_t seq;
+  p->CopyData ((uint8_t *) &seq, sizeof (seq));
+  m_inOrder = m_inOrder && (seq >= m_lastSeq);
+  m_lastSeq = seq;
+  Time delay = Simulator::Now () - m_sendTimes[seq];
+  m_delaysRecorded = m_delaysRecorded && (delay == MilliSeconds (1) || delay == MilliSeconds (2)
+                                          || delay == MilliSeconds (3));
+}
+
+void
+MeshLinkModelTestCase::DoRun (void)
+{
+  Ptr<MeshLinkModel> model = CreateObject<MeshLinkModel> ();
+  model->SetAttribute ("Mode", EnumValue (m_mode));
+  model->AssignStreams (1);
+  CreateMesh (m_mode == MeshLinkModel::CALIBRATE);
+  Mac48Address dst = Mac48Address::ConvertFrom (m_devices.Get (2)->GetAddress ());
+  Mac48Address src = Mac48Address::ConvertFrom (m_devices.Get (0)->GetAddress ());
+
+  if (m_mode == MeshLinkModel::CALIBRATE)
+    {
+      // Two hops through the mesh, once the peer links are up
+      model->Install (m_devices);
+      for (uint32_t i = 0; i < 20; i++)
+        {
+          Simulator::Schedule (Seconds (2 + 0.1 * i), &MeshLinkModelTestCase::Send, this, 0, dst, i);
+        }
+      Simulator::Stop (Seconds (10));
+      Simulator::Run ();
+      NS_TEST_ASSERT_MSG_GT (m_received[2], 0, "Frames should be delivered through the mesh");
+      NS_TEST_EXPECT_MSG_EQ (model->GetNLinks (), 1, "One pair of mesh points expected");
+      NS_TEST_EXPECT_MSG_EQ_TOL (model->GetDeliveryRatio (src, dst), m_received[2] / 20.0, 1e-9,
+                                 "Wrong delivery ratio");
+      std::ostringstream saved;
+      model->Save (saved);
+      std::ostringstream expected;
+      expected << "0 2 20 " << m_received[2] << " " << m_received[2] << " ";
+      NS_TEST_EXPECT_MSG_EQ (saved.str ().substr (0, expected.str ().size ()), expected.str (),
+                             "Wrong saved pair");
+
+      // The saved pair is loaded as it was recorded
+      Ptr<MeshLinkModel> loaded = CreateObject<MeshLinkModel> ();
+      std::istringstream is (saved.str ());
+      loaded->Load (is);
+      loaded->Install (m_devices);
+      std::ostringstream resaved;
+      loaded->Save (resaved);
+      NS_TEST_EXPECT_MSG_EQ (resaved.str (), saved.str (), "Save and Load should round trip");
+
+      // The frames never received are forgotten after InFlightTimeout
+      model->SetAttribute ("InFlightTimeout", TimeValue (Seconds (1)));
+      Simulator::Schedule (Seconds (1), &MeshLinkModel::NotifySent, model, src, dst, Create<Packet> (10));
+      Simulator::Schedule (Seconds (3), &MeshLinkModel::NotifySent, model, src, dst, Create<Packet> (10));
+      Simulator::Stop (Seconds (3));
+      Simulator::Run ();
+      NS_TEST_EXPECT_MSG_EQ (model->GetNInFlight (), 1, "Only the last frame should be in flight");
+    }
+  else
+    {
+      // 75% of the frames delivered from 0 to 2, 25% from 1 to 0, after 1, 2 or 3 ms
+      std::istringstream is ("0 2 100 75 3 1000000 2000000 3000000\n"
+                             "1 0 100 25 3 1000000 2000000 3000000\n");
+      model->Load (is);
+      model->Install (m_devices);
+      for (uint32_t i = 0; i < 1000; i++)
+        {
+          Simulator::Schedule (MilliSeconds (10 * i), &MeshLinkModelTestCase::Send, this, 0, dst, i);
+        }
+      Simulator::Run ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_received[2] / 1000.0, 0.75, 0.05, "Wrong loss rate");
+      NS_TEST_EXPECT_MSG_EQ (m_received[1], 0, "Unicast frames only go to their destination");
+      NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "The frames should be delivered in order");
+      NS_TEST_EXPECT_MSG_EQ (m_delaysRecorded, true, "The delays should be the recorded ones");
+
+      // The broadcasts go to all the other mesh points, with the samples of all
+      // the pairs (50% delivered), even to a pair with its own samples
+      for (uint32_t i = 0; i < 200; i++)
+        {
+          Simulator::Schedule (MilliSeconds (10 * i), &MeshLinkModelTestCase::Send, this, 1,
+                               Mac48Address::GetBroadcast (), 1000 + i);
+        }
+      uint32_t received = m_received[2];
+      Simulator::Run ();
+      NS_TEST_EXPECT_MSG_EQ (m_received[1], 0, "The sender should not receive its broadcasts");
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_received[0] / 200.0, 0.5, 0.1, "Wrong loss rate of the broadcasts");
+      NS_TEST_EXPECT_MSG_EQ_TOL ((m_received[2] - received) / 200.0, 0.5, 0.1, "Wrong loss rate of the broadcasts");
+    }
+  Simulator::Destroy ();
+}
+
+static class MeshLinkModelTestSuite : public TestSuite
+{
+public:
+  MeshLinkModelTestSuite ()
+    : TestSuite ("devices-mesh-link-model", UNIT)
+  {
+    AddTestCase (new MeshLinkModelTestCase (MeshLinkModel::CALIBRATE), TestCase::QUICK);
+    AddTestCase (new MeshLinkModelTestCase (MeshLinkModel::ABSTRACT), TestCase::QUICK);
+  }
+
+} g_meshLinkModelTestSuite;
+
+} // namespace ns3
@@ -25,8 +25,6 @@
 #include <ostream>
 #include "ns3/assert.h"
 
-#define BUFFER_FREE_LIST 1
-
 namespace ns3 {
 
 /**
@@ -65,10 +63,12 @@ namespace ns3 {
  * contains real data bytes in its BufferData instance but it also
  * contains "virtual zero data" which typically is used to represent
  * application-level payload. No memory is allocated to store the
- * zero bytes of application-level payload unless the user fragments
- * a Buffer: this application-level payload is kept track of with
- * a pair of integers which describe where in the buffer content
- * the "virtual zero area" starts and ends.
+ * zero bytes of application-level payload unless the user reads
+ * them through PeekData or CreateFullCopy: this application-level
+ * payload is kept track of with a pair of integers which describe
+ * where in the buffer content the "virtual zero area" starts and ends.
+ * Fragments keep the part of the zero area they cover, and the
+ * concatenation of two buffers keeps the larger of their zero areas.
  *
  * \verbatim
  * ***: unused bytes
@@ -518,7 +518,9 @@ private:
   /**
    * \param o the buffer to append to the end of this buffer.
    *
-   * Add bytes at the end of the Buffer.
+   * Add bytes at the end of the Buffer. The larger of the two
+   * "virtual zero areas" stays virtual: only the bytes around it
+   * are copied.
    * Any call to this method invalidates any Iterator
    * pointing to this Buffer.
    */
@@ -721,27 +723,16 @@ private:
   uint32_t GetInternalEnd (void) const;
 
   /**
-   * \brief Recycle the buffer memory
-   * \param data the buffer data storage
-   */
-  static void Recycle (struct Buffer::Data *data);
-  /**
-   * \brief Create a buffer data storage
+   * \brief Create a buffer data storage, from the PacketArena
    * \param size the storage size to create
-   * \returns a pointer to the created buffer storage
+   * \returns a pointer to the created buffer storage, of at least size bytes
    */
   static struct Buffer::Data *Create (uint32_t size);
   /**
-   * \brief Allocate a buffer data storage
-   * \param reqSize the storage size to create
-   * \returns a pointer to the allocated buffer storage
-   */
-  static struct Buffer::Data *Allocate (uint32_t reqSize);
-  /**
-   * \brief Deallocate the buffer memory
+   * \brief Return the buffer memory to the PacketArena
    * \param data the buffer data storage
    */
-  static void Deallocate (struct Buffer::Data *data);
+  static void Recycle (struct Buffer::Data *data);
 
   struct Data *m_data; //!< the buffer data storage
 
@@ -784,18 +775,6 @@ private:
    */
   uint32_t m_end;
 
-#ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
 };
 
 } // namespace ns3
@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-arena.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <new>
+
+namespace {
+
+/// Smallest size class, as a power of two
+const uint32_t MIN_SHIFT = 5;
+/// Number of cached size classes, up to 64 KiB
+const uint32_t N_CACHED_CLASSES = 12;
+
+/// A cached block, linked through its first bytes
+struct FreeBlock
+{
+  FreeBlock *next;
+};
+
+/**
+ * A size class. The arena is made of plain data, initialized before any
+ * constructor runs, so that packets can be created and destroyed by the
+ * constructors and destructors of other static objects.
+ */
+struct SizeClass
+{
+  FreeBlock *cached;
+  uint64_t allocations;
+  uint64_t reuses;
+  uint64_t blocksInUse;
+  uint64_t bytesInUse;
+  uint64_t peakBytesInUse;
+  uint64_t blocksCached;
+};
+
+SizeClass g_classes[N_CACHED_CLASSES + 1];
+uint64_t g_bytesInUse;
+uint64_t g_peakBytesInUse;
+uint32_t g_maxCachedBlocks = 1000;
+/// The static destructor below has run: nothing is cached any more
+bool g_destroyed;
+
+uint32_t
+GetSizeClass (uint32_t size)
+{
+  uint32_t c = 0;
+  while (c < N_CACHED_CLASSES && (1U << (c + MIN_SHIFT)) < size)
+    {
+      c++;
+    }
+  return c;
+}
+
+} // anonymous namespace
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketArena");
+
+/// Free the cached blocks at the end of the process
+static struct PacketArenaDestructor
+{
+  ~PacketArenaDestructor ()
+  {
+    PacketArena::Reset ();
+    g_destroyed = true;
+  }
+} g_packetArenaDestructor;
+
+PacketArena::Stats::Stats ()
+  : allocations (0),
+    reuses (0),
+    blocksInUse (0),
+    bytesInUse (0),
+    peakBytesInUse (0),
+    blocksCached (0),
+    bytesCached (0)
+{
+}
+
+uint32_t
+PacketArena::GetBlockSize (uint32_t size)
+{
+  uint32_t c = GetSizeClass (size);
+  return c < N_CACHED_CLASSES ? 1U << (c + MIN_SHIFT) : size;
+}
+
+void *
+PacketArena::Allocate (uint32_t size)
+{
+  uint32_t blockSize = GetBlockSize (size);
+  SizeClass &sc = g_classes[GetSizeClass (size)];
+  sc.allocations++;
+  sc.blocksInUse++;
+  sc.bytesInUse += blockSize;
+  sc.peakBytesInUse = std::max (sc.peakBytesInUse, sc.bytesInUse);
+  g_bytesInUse += blockSize;
+  g_peakBytesInUse = std::max (g_peakBytesInUse, g_bytesInUse);
+  if (sc.cached != 0)
+    {
+      FreeBlock *block = sc.cached;
+      sc.cached = block->next;
+      sc.blocksCached--;
+      sc.reuses++;
+      return block;
+    }
+  return ::operator new (blockSize);
+}
+
+void
+PacketArena::Deallocate (void *block, uint32_t size)
+{
+  uint32_t blockSize = GetBlockSize (size);
+  uint32_t c = GetSizeClass (size);
+  SizeClass &sc = g_classes[c];
+  NS_ASSERT (sc.blocksInUse > 0);
+  sc.blocksInUse--;
+  sc.bytesInUse -= blockSize;
+  g_bytesInUse -= blockSize;
+  if (c == N_CACHED_CLASSES || sc.blocksCached >= g_maxCachedBlocks || g_destroyed)
+    {
+      ::operator delete (block);
+      return;
+    }
+  FreeBlock *cached = static_cast<FreeBlock *> (block);
+  cached->next = sc.cached;
+  sc.cached = cached;
+  sc.blocksCached++;
+}
+
+PacketArena::Stats
+PacketArena::GetStats (void)
+{
+  Stats stats;
+  for (uint32_t c = 0; c < GetNSizeClasses (); c++)
+    {
+      Stats sc = GetStats (c);
+      stats.allocations += sc.allocations;
+      stats.reuses += sc.reuses;
+      stats.blocksInUse += sc.blocksInUse;
+      stats.blocksCached += sc.blocksCached;
+      stats.bytesCached += sc.bytesCached;
+    }
+  stats.bytesInUse = g_bytesInUse;
+  stats.peakBytesInUse = g_peakBytesInUse;
+  return stats;
+}
+
+uint32_t
+PacketArena::GetNSizeClasses (void)
+{
+  return N_CACHED_CLASSES + 1;
+}
+
+PacketArena::Stats
+PacketArena::GetStats (uint32_t sizeClass)
+{
+  NS_ASSERT (sizeClass < GetNSizeClasses ());
+  const SizeClass &sc = g_classes[sizeClass];
+  Stats stats;
+  stats.allocations = sc.allocations;
+  stats.reuses = sc.reuses;
+  stats.blocksInUse = sc.blocksInUse;
+  stats.bytesInUse = sc.bytesInUse;
+  stats.peakBytesInUse = sc.peakBytesInUse;
+  stats.blocksCached = sc.blocksCached;
+  stats.bytesCached = sizeClass < N_CACHED_CLASSES ? sc.blocksCached << (sizeClass + MIN_SHIFT) : 0;
+  return stats;
+}
+
+void
+PacketArena::Print (std::ostream &os)
+{
+  for (uint32_t c = 0; c < GetNSizeClasses (); c++)
+    {
+      Stats stats = GetStats (c);
+      if (stats.allocations == 0 && stats.blocksInUse == 0 && stats.blocksCached == 0)
+        {
+          continue;
+        }
+      if (c < N_CACHED_CLASSES)
+        {
+          os << "class=" << (1U << (c + MIN_SHIFT));
+        }
+      else
+        {
+          os << "class=large";
+        }
+      os << " allocations=" << stats.allocations << " reuses=" << stats.reuses
+         << " in-use=" << stats.blocksInUse << " peak-bytes=" << stats.peakBytesInUse
+         << " cached=" << stats.blocksCached << std::endl;
+    }
+  Stats stats = GetStats ();
+  os << "total allocations=" << stats.allocations << " reuses=" << stats.reuses
+     << " bytes-in-use=" << stats.bytesInUse << " peak-bytes=" << stats.peakBytesInUse
+     << " bytes-cached=" << stats.bytesCached << std::endl;
+}
+
+void
+PacketArena::SetMaxCachedBlocks (uint32_t blocks)
+{
+  NS_LOG_FUNCTION (blocks);
+  g_maxCachedBlocks = blocks;
+}
+
+void
+PacketArena::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  for (uint32_t c = 0; c < GetNSizeClasses (); c++)
+    {
+      SizeClass &sc = g_classes[c];
+      while (sc.cached != 0)
+        {
+          FreeBlock *block = sc.cached;
+          sc.cached = block->next;
+          ::operator delete (block);
+        }
+      sc.blocksCached = 0;
+      sc.allocations = 0;
+      sc.reuses = 0;
+      sc.peakBytesInUse = sc.bytesInUse;
+    }
+  g_peakBytesInUse = g_bytesInUse;
+}
+
+} // namespace ns3
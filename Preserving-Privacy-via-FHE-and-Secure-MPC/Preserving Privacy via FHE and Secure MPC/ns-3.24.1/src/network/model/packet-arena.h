@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_ARENA_H
+#define PACKET_ARENA_H
+
+#include <stdint.h>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Allocator of the storage of the packets: the bytes of Buffer, the
+ * PacketMetadata and the tags of ByteTagList and PacketTagList.
+ *
+ * The blocks are rounded up to a power of two size class, from 32 bytes to
+ * 64 KiB, and the deallocated blocks of each class are kept for reuse, up
+ * to SetMaxCachedBlocks per class. Larger blocks are not cached. Since the
+ * storage of a packet always comes back to the class it was taken from,
+ * the cached memory does not fragment over long series of simulations.
+ *
+ * Reset returns the cached blocks to the system and restarts the counters
+ * of the statistics. It is called when the node list is deleted by
+ * Simulator::Destroy, so that each simulation of a process starts from an
+ * empty arena; the blocks of the packets still alive are not affected.
+ *
+ * The arena is not thread safe, as the packets are not.
+ */
+class PacketArena
+{
+public:
+  /// Statistics of the arena, or of one of its size classes
+  struct Stats
+  {
+    Stats ();
+    uint64_t allocations;    //!< Blocks allocated since the last Reset
+    uint64_t reuses;         //!< Of which taken from the cached blocks
+    uint64_t blocksInUse;    //!< Blocks allocated and not deallocated yet
+    uint64_t bytesInUse;     //!< Bytes of these blocks
+    uint64_t peakBytesInUse; //!< Largest bytesInUse since the last Reset
+    uint64_t blocksCached;   //!< Deallocated blocks kept for reuse
+    uint64_t bytesCached;    //!< Bytes of these blocks
+  };
+
+  /**
+   * \param size a number of bytes
+   * \return the size of the block allocated for them
+   */
+  static uint32_t GetBlockSize (uint32_t size);
+  /**
+   * \param size the number of bytes needed
+   * \return a block of GetBlockSize (size) bytes
+   */
+  static void *Allocate (uint32_t size);
+  /**
+   * \param block a block returned by Allocate
+   * \param size the size given to Allocate, or the size of the block
+   */
+  static void Deallocate (void *block, uint32_t size);
+
+  /// \return the statistics of all the size classes
+  static Stats GetStats (void);
+  /// \return the number of size classes, the last one being the uncached large blocks
+  static uint32_t GetNSizeClasses (void);
+  /**
+   * \param sizeClass a size class, less than GetNSizeClasses
+   * \return the statistics of the class
+   */
+  static Stats GetStats (uint32_t sizeClass);
+  /// Print the statistics of the size classes in use
+  static void Print (std::ostream &os);
+
+  /// \param blocks the number of deallocated blocks kept for reuse per size class
+  static void SetMaxCachedBlocks (uint32_t blocks);
+  /// Free the cached blocks and restart the counters of the statistics
+  static void Reset (void);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_ARENA_H */
@@ -491,16 +491,6 @@ private:
     uint64_t packetUid;
   };
 
-  /**
-   * \brief Class to hold all the metadata
-   */
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   friend class ItemIterator;
 
   PacketMetadata ();
@@ -634,29 +624,17 @@ public:
   bool IsSharedPointerOk (uint16_t pointer) const;
 
   /**
-   * \brief Recycle the buffer memory
+   * \brief Return the buffer memory to the PacketArena
    * \param data the buffer data storage
    */
   static void Recycle (struct PacketMetadata::Data *data);
   /**
-   * \brief Create a buffer data storage
+   * \brief Create a buffer data storage, from the PacketArena
    * \param size the storage size to create
-   * \returns a pointer to the created buffer storage
+   * \returns a pointer to the created buffer storage, of at least size bytes
    */
   static struct PacketMetadata::Data *Create (uint32_t size);
-  /**
-   * \brief Allocate a buffer data storage
-   * \param n the storage size to create
-   * \returns a pointer to the allocated buffer storage
-   */
-  static struct PacketMetadata::Data *Allocate (uint32_t n);
-  /**
-   * \brief Deallocate the buffer memory
-   * \param data the buffer data storage
-   */
-  static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -667,7 +645,6 @@ public:
    */
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
   static uint16_t m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
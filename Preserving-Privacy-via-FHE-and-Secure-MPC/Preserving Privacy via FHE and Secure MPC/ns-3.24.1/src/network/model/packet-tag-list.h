@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "packet-arena.h"
 
 namespace ns3 {
 
@@ -165,6 +166,17 @@ public:
     struct TagData * next;   /**< Pointer to next in list */
     TypeId tid;               /**< Type of the tag serialized into #data */
     uint32_t count;           /**< Number of incoming links */
+
+    /// Allocate from the PacketArena
+    static void * operator new (size_t size)
+    {
+      return PacketArena::Allocate (size);
+    }
+    /// Return to the PacketArena
+    static void operator delete (void * p, size_t size)
+    {
+      PacketArena::Deallocate (p, size);
+    }
   };  /* struct TagData */
 
   /**
@@ -247,10 +247,11 @@ public:
   /**
    * \brief Create a packet with a zero-filled payload.
    *
-   * The memory necessary for the payload is not allocated:
-   * it will be allocated at any later point if you attempt
-   * to fragment this packet or to access the zero-filled
-   * bytes. The packet is allocated with a new uid (as 
+   * The memory necessary for the payload is not allocated,
+   * and neither the fragments of the packet nor its
+   * concatenation with other packets allocate it: CopyData
+   * writes the zero-filled bytes into the memory of the caller.
+   * The packet is allocated with a new uid (as 
    * returned by getUid).
    * 
    * \param size the size of the zero-filled payload
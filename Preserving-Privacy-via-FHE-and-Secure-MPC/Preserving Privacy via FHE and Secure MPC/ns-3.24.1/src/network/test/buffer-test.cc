@@ -22,6 +22,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
+#include <algorithm>
+#include <vector>
 
 using namespace ns3;
 
@@ -359,6 +361,32 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // The larger zero area stays virtual through fragments and concatenation
+  buffer = Buffer (6000);
+  buffer.AddAtStart (2);
+  i = buffer.Begin ();
+  i.WriteU8 (0x1);
+  i.WriteU8 (0x2);
+  frag0 = buffer.CreateFragment (0, 1000);
+  frag1 = buffer.CreateFragment (1000, 5002);
+  frag1.AddAtStart (1);
+  frag1.Begin ().WriteU8 (0x3);
+  frag0.AddAtEnd (frag1);
+  NS_TEST_ASSERT_MSG_EQ (frag0.GetSize (), 6003, "Bad size of the concatenation");
+  NS_TEST_EXPECT_MSG_LT (frag0.GetSerializedSize (), 1100, "The larger zero area should stay virtual");
+  other = Buffer ();
+  other.AddAtStart (1);
+  other.Begin ().WriteU8 (0x4);
+  frag0.AddAtEnd (other);
+  NS_TEST_EXPECT_MSG_LT (frag0.GetSerializedSize (), 1100, "The larger zero area should stay virtual");
+  std::vector<uint8_t> content (frag0.GetSize ());
+  frag0.CopyData (&content[0], content.size ());
+  NS_TEST_EXPECT_MSG_EQ (content[0], 0x1, "Bad content of the concatenation");
+  NS_TEST_EXPECT_MSG_EQ (content[1], 0x2, "Bad content of the concatenation");
+  NS_TEST_EXPECT_MSG_EQ (content[1000], 0x3, "Bad content of the concatenation");
+  NS_TEST_EXPECT_MSG_EQ (content[6003], 0x4, "Bad content of the concatenation");
+  NS_TEST_EXPECT_MSG_EQ (std::count (content.begin (), content.end (), 0), 6000, "Bad content of the concatenation");
 }
 //-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/packet-arena.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+namespace {
+
+/// A packet tag, stored in the TagData of PacketTagList
+class ArenaTestTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::ArenaTestTag")
+      .SetParent<Tag> ()
+      .AddConstructor<ArenaTestTag> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const
+  {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const
+  {
+    return 1;
+  }
+  virtual void Serialize (TagBuffer i) const
+  {
+    i.WriteU8 (1);
+  }
+  virtual void Deserialize (TagBuffer i)
+  {
+    i.ReadU8 ();
+  }
+  virtual void Print (std::ostream &os) const
+  {
+  }
+};
+
+} // anonymous namespace
+
+/**
+ * \brief Check the size classes, the reuse and the cache limit of the blocks
+ */
+class PacketArenaBlocksTestCase : public TestCase
+{
+public:
+  PacketArenaBlocksTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+PacketArenaBlocksTestCase::PacketArenaBlocksTestCase ()
+  : TestCase ("Check the blocks of the packet arena")
+{
+}
+
+void
+PacketArenaBlocksTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (1), 32, "Wrong smallest class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (33), 64, "Wrong class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (1500), 2048, "Wrong class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (65536), 65536, "Wrong largest class");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetBlockSize (65537), 65537, "Large blocks are not rounded");
+
+  PacketArena::Reset ();
+  PacketArena::Stats before = PacketArena::GetStats ();
+  void *block = PacketArena::Allocate (1000);
+  PacketArena::Stats stats = PacketArena::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.blocksInUse, before.blocksInUse + 1, "One more block in use");
+  NS_TEST_EXPECT_MSG_EQ (stats.bytesInUse, before.bytesInUse + 1024, "The whole block is in use");
+  PacketArena::Deallocate (block, 1000);
+  // The block of the same class is reused
+  void *reused = PacketArena::Allocate (600);
+  NS_TEST_EXPECT_MSG_EQ (reused, block, "The cached block should be reused");
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetStats ().reuses, before.reuses + 1, "One reuse expected");
+  PacketArena::Deallocate (reused, 1024);
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetStats ().blocksCached, before.blocksCached + 1, "The block should be cached");
+
+  // Large blocks are not cached
+  block = PacketArena::Allocate (100000);
+  PacketArena::Deallocate (block, 100000);
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetStats (PacketArena::GetNSizeClasses () - 1).blocksCached, 0,
+                         "Large blocks should not be cached");
+
+  // At most MaxCachedBlocks per class
+  PacketArena::SetMaxCachedBlocks (2);
+  void *blocks[3];
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      blocks[i] = PacketArena::Allocate (4000);
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      PacketArena::Deallocate (blocks[i], 4000);
+    }
+  PacketArena::SetMaxCachedBlocks (1000);
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetStats (7).blocksCached, 2, "Two blocks of 4096 bytes should be cached");
+
+  PacketArena::Reset ();
+  stats = PacketArena::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.blocksCached, 0, "Reset should free the cached blocks");
+  NS_TEST_EXPECT_MSG_EQ (stats.allocations, 0, "Reset should restart the counters");
+  NS_TEST_EXPECT_MSG_EQ (stats.blocksInUse, before.blocksInUse, "Reset should not change the blocks in use");
+}
+
+/**
+ * \brief Check that the bytes, metadata and tags of the packets come from the
+ * arena, and that Simulator::Destroy resets it
+ */
+class PacketArenaPacketsTestCase : public TestCase
+{
+public:
+  PacketArenaPacketsTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+PacketArenaPacketsTestCase::PacketArenaPacketsTestCase ()
+  : TestCase ("Check the storage of the packets in the packet arena")
+{
+}
+
+void
+PacketArenaPacketsTestCase::DoRun (void)
+{
+  CreateObject<Node> ();
+  PacketArena::Reset ();
+  PacketArena::Stats before = PacketArena::GetStats ();
+  uint8_t bytes[1000] = { 0 };
+  {
+    Ptr<Packet> p = Create<Packet> (bytes, sizeof (bytes));
+    ArenaTestTag tag;
+    p->AddByteTag (tag);
+    p->AddPacketTag (tag);
+    Ptr<Packet> fragment = p->CreateFragment (0, 500);
+    PacketArena::Stats stats = PacketArena::GetStats ();
+    // At least the buffer, metadata and byte tags of the packet, and the packet tag
+    NS_TEST_EXPECT_MSG_GT (stats.blocksInUse, before.blocksInUse + 3, "The packets should use the arena");
+  }
+  PacketArena::Stats after = PacketArena::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (after.blocksInUse, before.blocksInUse, "The blocks of the packets should be returned");
+  NS_TEST_EXPECT_MSG_GT (after.blocksCached, 0, "The blocks of the packets should be cached");
+
+  // The same packets again come from the cache
+  {
+    Ptr<Packet> p = Create<Packet> (bytes, sizeof (bytes));
+    ArenaTestTag tag;
+    p->AddByteTag (tag);
+    p->AddPacketTag (tag);
+  }
+  NS_TEST_EXPECT_MSG_GT (PacketArena::GetStats ().reuses, after.reuses, "The cached blocks should be reused");
+
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetStats ().blocksCached, 0, "Simulator::Destroy should reset the arena");
+}
+
+static class PacketArenaTestSuite : public TestSuite
+{
+public:
+  PacketArenaTestSuite ()
+    : TestSuite ("packet-arena", UNIT)
+  {
+    AddTestCase (new PacketArenaBlocksTestCase (), TestCase::QUICK);
+    AddTestCase (new PacketArenaPacketsTestCase (), TestCase::QUICK);
+  }
+} g_packetArenaTestSuite;
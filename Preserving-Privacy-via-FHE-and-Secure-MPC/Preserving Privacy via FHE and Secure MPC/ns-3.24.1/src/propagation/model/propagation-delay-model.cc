@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include <cmath>
 
 namespace ns3 {
 
@@ -41,6 +42,17 @@ PropagationDelayModel::~PropagationDelayModel ()
 {
 }
 
+void
+PropagationDelayModel::GetDelays (Ptr<MobilityModel> a, const std::vector<Ptr<MobilityModel> > &b,
+                                  std::vector<Time> &delays) const
+{
+  delays.resize (b.size ());
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      delays[i] = GetDelay (a, b[i]);
+    }
+}
+
 int64_t
 PropagationDelayModel::AssignStreams (int64_t stream)
 {
@@ -113,6 +125,39 @@ ConstantSpeedPropagationDelayModel::GetDelay (Ptr<MobilityModel> a, Ptr<Mobility
   double seconds = distance / m_speed;
   return Seconds (seconds);
 }
+
+void
+ConstantSpeedPropagationDelayModel::GetDelays (Ptr<MobilityModel> a, const std::vector<Ptr<MobilityModel> > &b,
+                                               std::vector<Time> &delays) const
+{
+  uint32_t n = b.size ();
+  // copy the positions in a structure of arrays, then compute the delays
+  // in one scalar loop
+  std::vector<double> seconds (3 * n);
+  double *dx = n ? &seconds[0] : 0;
+  double *dy = dx + n;
+  double *dz = dy + n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Vector position = b[i]->GetPosition ();
+      dx[i] = position.x;
+      dy[i] = position.y;
+      dz[i] = position.z;
+    }
+  Vector origin = a->GetPosition ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double x = dx[i] - origin.x;
+      double y = dy[i] - origin.y;
+      double z = dz[i] - origin.z;
+      dx[i] = std::sqrt (x * x + y * y + z * z) / m_speed;
+    }
+  delays.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      delays[i] = Seconds (dx[i]);
+    }
+}
 void
 ConstantSpeedPropagationDelayModel::SetSpeed (double speed)
 {
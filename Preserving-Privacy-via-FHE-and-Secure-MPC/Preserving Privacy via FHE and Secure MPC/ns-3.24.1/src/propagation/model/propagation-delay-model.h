@@ -24,6 +24,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -52,6 +53,18 @@ public:
    * source and destination.
    */
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const = 0;
+  /**
+   * \param a the source
+   * \param b the destinations
+   * \param delays the calculated propagation delays, resized to the
+   *        number of destinations
+   *
+   * Calculate the propagation delays between the specified source and a
+   * set of destinations. The default implementation calls GetDelay for
+   * each destination.
+   */
+  virtual void GetDelays (Ptr<MobilityModel> a, const std::vector<Ptr<MobilityModel> > &b,
+                          std::vector<Time> &delays) const;
   /**
    * If this delay model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -114,6 +127,8 @@ public:
    */
   ConstantSpeedPropagationDelayModel ();
   virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  virtual void GetDelays (Ptr<MobilityModel> a, const std::vector<Ptr<MobilityModel> > &b,
+                          std::vector<Time> &delays) const;
   /**
    * \param speed the new speed (m/s)
    */
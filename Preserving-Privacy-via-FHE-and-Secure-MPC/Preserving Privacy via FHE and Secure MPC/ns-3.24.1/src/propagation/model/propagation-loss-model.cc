@@ -34,6 +34,44 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PropagationLossModel");
 
+/**
+ * \ingroup propagation
+ *
+ * Compute the distances from a source to a set of destinations. The
+ * positions are first copied in a structure of arrays, then the distances
+ * are computed in one scalar loop, without a virtual call per destination.
+ *
+ * \param a the mobility model of the source
+ * \param b the mobility models of the destinations
+ * \param distances the distances (m), resized to the number of destinations
+ */
+static void
+CalcDistances (Ptr<MobilityModel> a, const std::vector<Ptr<MobilityModel> > &b,
+               std::vector<double> &distances)
+{
+  uint32_t n = b.size ();
+  std::vector<double> delta (3 * n);
+  double *dx = n ? &delta[0] : 0;
+  double *dy = dx + n;
+  double *dz = dy + n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Vector position = b[i]->GetPosition ();
+      dx[i] = position.x;
+      dy[i] = position.y;
+      dz[i] = position.z;
+    }
+  Vector origin = a->GetPosition ();
+  distances.resize (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double x = dx[i] - origin.x;
+      double y = dy[i] - origin.y;
+      double z = dz[i] - origin.z;
+      distances[i] = std::sqrt (x * x + y * y + z * z);
+    }
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (PropagationLossModel);
@@ -68,6 +106,17 @@ PropagationLossModel::GetNext ()
   return m_next;
 }
 
+void
+PropagationLossModel::DoDispose (void)
+{
+  if (m_next != 0)
+    {
+      m_next->Dispose ();
+      m_next = 0;
+    }
+  Object::DoDispose ();
+}
+
 double
 PropagationLossModel::CalcRxPower (double txPowerDbm,
                                    Ptr<MobilityModel> a,
@@ -81,6 +130,30 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+void
+PropagationLossModel::CalcRxPowers (double txPowerDbm,
+                                    Ptr<MobilityModel> a,
+                                    const std::vector<Ptr<MobilityModel> > &b,
+                                    std::vector<double> &rxPowerDbm) const
+{
+  rxPowerDbm.assign (b.size (), txPowerDbm);
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      model->DoCalcRxPowers (a, b, rxPowerDbm);
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                      const std::vector<Ptr<MobilityModel> > &b,
+                                      std::vector<double> &rxPowerDbm) const
+{
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      rxPowerDbm[i] = DoCalcRxPower (rxPowerDbm[i], a, b[i]);
+    }
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -269,6 +342,23 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
+void
+FriisPropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                           const std::vector<Ptr<MobilityModel> > &b,
+                                           std::vector<double> &rxPowerDbm) const
+{
+  std::vector<double> distances;
+  CalcDistances (a, b, distances);
+  // same as DoCalcRxPower: the loss is m_minLoss at distance 0
+  double factor = 16 * M_PI * M_PI * m_systemLoss / (m_lambda * m_lambda);
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = distances[i];
+      double lossDb = (distance <= 0) ? m_minLoss : 10 * std::log10 (factor * distance * distance);
+      rxPowerDbm[i] -= std::max (lossDb, m_minLoss);
+    }
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -531,6 +621,22 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+void
+LogDistancePropagationLossModel::DoCalcRxPowers (Ptr<MobilityModel> a,
+                                                 const std::vector<Ptr<MobilityModel> > &b,
+                                                 std::vector<double> &rxPowerDbm) const
+{
+  std::vector<double> distances;
+  CalcDistances (a, b, distances);
+  // same as DoCalcRxPower: no loss within the reference distance
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = std::max (distances[i], m_referenceDistance);
+      double lossDb = m_referenceLoss + 10 * m_exponent * std::log10 (distance / m_referenceDistance);
+      rxPowerDbm[i] -= (distances[i] <= m_referenceDistance) ? 0.0 : lossDb;
+    }
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -927,4 +1033,165 @@ RangePropagationLossModel::DoAssignStreams (int64_t stream)
 
 // ------------------------------------------------------------------------- //
 
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model", "The deterministic propagation loss model to cache.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : PropagationLossModel (),
+    m_size (0),
+    m_capacity (0),
+    m_nHits (0),
+    m_nMisses (0)
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  for (IndexMap::const_iterator i = m_index.begin (); i != m_index.end (); i++)
+    {
+      ConstCast<MobilityModel> (i->first)->TraceDisconnectWithoutContext ("CourseChange",
+                                                                          MakeCallback (&CachedPropagationLossModel::CourseChanged, this));
+    }
+  m_model = 0;
+  m_index.clear ();
+  m_loss.clear ();
+  m_valid.clear ();
+  m_size = 0;
+  m_capacity = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  m_model = model;
+  Flush ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::Flush (void)
+{
+  m_valid.assign (m_valid.size (), false);
+}
+
+uint64_t
+CachedPropagationLossModel::GetNHits (void) const
+{
+  return m_nHits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetNMisses (void) const
+{
+  return m_nMisses;
+}
+
+uint32_t
+CachedPropagationLossModel::GetIndex (Ptr<MobilityModel> mobility) const
+{
+  IndexMap::const_iterator i = m_index.find (mobility);
+  if (i != m_index.end ())
+    {
+      return i->second;
+    }
+  if (m_size == m_capacity)
+    {
+      // grow the matrix geometrically, keeping the cached losses
+      uint32_t capacity = (m_capacity == 0) ? 16 : 2 * m_capacity;
+      std::vector<double> loss (capacity * capacity, 0.0);
+      std::vector<bool> valid (capacity * capacity, false);
+      for (uint32_t a = 0; a < m_size; a++)
+        {
+          for (uint32_t b = 0; b < m_size; b++)
+            {
+              loss[a * capacity + b] = m_loss[a * m_capacity + b];
+              valid[a * capacity + b] = m_valid[a * m_capacity + b];
+            }
+        }
+      m_loss.swap (loss);
+      m_valid.swap (valid);
+      m_capacity = capacity;
+    }
+  uint32_t index = m_size++;
+  m_index[mobility] = index;
+  mobility->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&CachedPropagationLossModel::CourseChanged, this));
+  return index;
+}
+
+void
+CachedPropagationLossModel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  IndexMap::const_iterator i = m_index.find (mobility);
+  if (i == m_index.end ())
+    {
+      return;
+    }
+  uint32_t index = i->second;
+  for (uint32_t j = 0; j < m_size; j++)
+    {
+      m_valid[index * m_capacity + j] = false;
+      m_valid[j * m_capacity + index] = false;
+    }
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT (m_model != 0);
+  uint32_t ia = GetIndex (a);
+  uint32_t ib = GetIndex (b);
+  uint32_t cell = ia * m_capacity + ib;
+  if (m_valid[cell])
+    {
+      m_nHits++;
+      return txPowerDbm - m_loss[cell];
+    }
+  m_nMisses++;
+  double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  m_loss[cell] = txPowerDbm - rxPowerDbm;
+  m_valid[cell] = true;
+  return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model != 0)
+    {
+      return m_model->AssignStreams (stream);
+    }
+  return 0;
+}
+
+// ------------------------------------------------------------------------- //
+
 } // namespace ns3
@@ -28,6 +28,7 @@
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -93,6 +94,23 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * Returns the Rx Power of a set of destinations taking into account all
+   * the PropagationLossModel(s) chained to the current one. This is
+   * equivalent to calling CalcRxPower for each destination, but the models
+   * can share the work between the destinations.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm the reception powers of the destinations (in dBm),
+   *        resized to the number of destinations
+   */
+  void CalcRxPowers (double txPowerDbm,
+                     Ptr<MobilityModel> a,
+                     const std::vector<Ptr<MobilityModel> > &b,
+                     std::vector<double> &rxPowerDbm) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -106,6 +124,12 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+protected:
+  /**
+   * Dispose the models chained to this one.
+   */
+  virtual void DoDispose (void);
+
 private:
   /**
    * \brief Copy constructor
@@ -134,6 +158,20 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
 
+  /**
+   * Applies the loss of only the particular PropagationLossModel to a set
+   * of destinations. The default implementation calls DoCalcRxPower for
+   * each destination.
+   *
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm on input, the powers received from the previous
+   *        models of the chain; on output, the reception powers (in dBm)
+   */
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
+
   /**
    * Subclasses must implement this; those not using random variables
    * can return zero
@@ -321,6 +359,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -529,6 +570,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowers (Ptr<MobilityModel> a,
+                               const std::vector<Ptr<MobilityModel> > &b,
+                               std::vector<double> &rxPowerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -849,6 +893,115 @@ private:
   double m_range; //!< Maximum Transmission Range (meters)
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief Caches the loss computed by a deterministic propagation loss model
+ * for every pair of mobility models.
+ *
+ * The loss of the model configured with the Model attribute (which may
+ * itself be a chain of models) is computed once per (source, destination)
+ * pair of mobility models and stored in a dense matrix, indexed by the
+ * order in which the mobility models are first seen. The row and the column
+ * of a mobility model are invalidated when it reports a course change, so
+ * the cache is mostly useful for static topologies.
+ *
+ * The cached model must be deterministic and its loss must not depend on
+ * the transmit power. Stochastic models, e.g. NakagamiPropagationLossModel,
+ * should be chained after this model with SetNext () rather than cached:
+ * they are then evaluated for each call, on top of the cached loss.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the deterministic propagation loss model to cache
+   *
+   * The cache is flushed.
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the cached propagation loss model
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * Forget all the cached losses, e.g. after changing the attributes of the
+   * cached model.
+   */
+  void Flush (void);
+
+  /**
+   * \return the number of calls served from the cache
+   */
+  uint64_t GetNHits (void) const;
+  /**
+   * \return the number of calls for which the cached model was evaluated
+   */
+  uint64_t GetNMisses (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel &operator = (const CachedPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * Get the index of a mobility model in the matrix, adding it (and
+   * connecting to its course change trace) the first time it is seen.
+   *
+   * \param mobility the mobility model
+   * \return the index of the mobility model
+   */
+  uint32_t GetIndex (Ptr<MobilityModel> mobility) const;
+  /**
+   * Invalidate the row and the column of a mobility model which moved.
+   *
+   * \param mobility the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+
+  Ptr<PropagationLossModel> m_model; //!< cached propagation loss model
+
+  /// Typedef: index of the mobility models in the matrix
+  typedef std::map<Ptr<const MobilityModel>, uint32_t> IndexMap;
+
+  mutable IndexMap m_index;             //!< index of the mobility models
+  mutable uint32_t m_size;              //!< number of rows (and columns) in use
+  mutable uint32_t m_capacity;          //!< number of rows (and columns) allocated
+  mutable std::vector<double> m_loss;   //!< a -> b loss (dB) at a * m_capacity + b
+  mutable std::vector<bool> m_valid;    //!< whether the a -> b loss is cached
+  mutable uint64_t m_nHits;             //!< number of cache hits
+  mutable uint64_t m_nMisses;           //!< number of cache misses
+};
+
 } // namespace ns3
 
 #endif /* PROPAGATION_LOSS_MODEL_H */
@@ -21,7 +21,9 @@
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/pointer.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +438,147 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (50,0,0));
+
+  Ptr<LogDistancePropagationLossModel> reference = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> lossModel = CreateObject<CachedPropagationLossModel> ();
+  lossModel->SetModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  double tolerance = 1e-9;
+  double expected = reference->CalcRxPower (16.0206, a, b);
+  // the test macros evaluate their arguments more than once
+  double rxPower = lossModel->CalcRxPower (16.0206, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected, tolerance, "Got unexpected rcv power");
+  rxPower = lossModel->CalcRxPower (16.0206, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected, tolerance, "Got unexpected cached rcv power");
+  // the loss does not depend on the transmit power
+  rxPower = lossModel->CalcRxPower (6.0206, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected - 10, tolerance, "Got unexpected cached rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetNMisses (), 1, "The loss should have been computed once");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetNHits (), 2, "The loss should have been cached");
+
+  // the reverse direction is a different entry
+  rxPower = lossModel->CalcRxPower (16.0206, b, a);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetNMisses (), 2, "The reverse loss should have been computed");
+
+  // moving b invalidates both directions
+  b->SetPosition (Vector (100,0,0));
+  expected = reference->CalcRxPower (16.0206, a, b);
+  rxPower = lossModel->CalcRxPower (16.0206, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected, tolerance, "Got stale rcv power");
+  rxPower = lossModel->CalcRxPower (16.0206, b, a);
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPower, expected, tolerance, "Got stale rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetNMisses (), 4, "The losses should have been recomputed");
+
+  // the models chained after the cache are evaluated for each call
+  Ptr<RandomPropagationLossModel> fading = CreateObject<RandomPropagationLossModel> ();
+  Ptr<UniformRandomVariable> variable = CreateObject<UniformRandomVariable> ();
+  variable->SetAttribute ("Min", DoubleValue (0.0));
+  variable->SetAttribute ("Max", DoubleValue (20.0));
+  fading->SetAttribute ("Variable", PointerValue (variable));
+  lossModel->SetNext (fading);
+  lossModel->AssignStreams (1);
+  double first = lossModel->CalcRxPower (16.0206, a, b);
+  double second = lossModel->CalcRxPower (16.0206, a, b);
+  NS_TEST_EXPECT_MSG_NE (first, second, "The fading should not be cached");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (first, expected, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetNMisses (), 4, "The cached loss should have been reused");
+
+  Simulator::Destroy ();
+}
+
+class BatchPropagationModelsTestCase : public TestCase
+{
+public:
+  BatchPropagationModelsTestCase ();
+  virtual ~BatchPropagationModelsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BatchPropagationModelsTestCase::BatchPropagationModelsTestCase ()
+  : TestCase ("Test the batch evaluation of the propagation models")
+{
+}
+
+BatchPropagationModelsTestCase::~BatchPropagationModelsTestCase ()
+{
+}
+
+void
+BatchPropagationModelsTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (10,20,1));
+  std::vector<Ptr<MobilityModel> > b;
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      // includes a receiver at the position of the source and receivers
+      // within the reference distance of the log distance model
+      Ptr<MobilityModel> m = CreateObject<ConstantPositionMobilityModel> ();
+      m->SetPosition (Vector (10 + 0.1 * i * i * i, 20 - 0.5 * i, 1 + (i % 3)));
+      b.push_back (m);
+    }
+  Ptr<MatrixPropagationLossModel> matrix = CreateObject<MatrixPropagationLossModel> ();
+  matrix->SetDefaultLoss (3);
+  matrix->SetLoss (a, b[5], 30, /*symmetric = */ false);
+
+  // one model of each kind: overridden batch evaluation, and default one
+  Ptr<LogDistancePropagationLossModel> lossModel = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  friis->SetMinLoss (5);
+  lossModel->SetNext (friis);
+  friis->SetNext (matrix);
+
+  double tolerance = 1e-9;
+  std::vector<double> rxPowerDbm;
+  lossModel->CalcRxPowers (16.0206, a, b, rxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), b.size (), "Got unexpected number of rcv powers");
+  for (uint32_t i = 0; i < b.size (); ++i)
+    {
+      double expected = lossModel->CalcRxPower (16.0206, a, b[i]);
+      NS_TEST_EXPECT_MSG_EQ_TOL (rxPowerDbm[i], expected, tolerance, "Got unexpected rcv power for " << i);
+    }
+
+  Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  std::vector<Time> delays;
+  delayModel->GetDelays (a, b, delays);
+  NS_TEST_ASSERT_MSG_EQ (delays.size (), b.size (), "Got unexpected number of delays");
+  for (uint32_t i = 0; i < b.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (delays[i], delayModel->GetDelay (a, b[i]), "Got unexpected delay for " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +593,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new BatchPropagationModelsTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Micro-benchmark of the PHY reception path (YansWifiChannel,
+// YansWifiPhy and InterferenceHelper) under a beacon storm: a grid of
+// PHYs which are all in range of each other send a beacon-sized frame
+// at almost the same time, every beacon interval, so that every
+// reception overlaps with tens of other frames.
+//
+// ./waf --run "wifi-beacon-storm --Nodes=100 --Intervals=100"
+
+#include <iostream>
+#include <cmath>
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/wifi-tx-vector.h"
+
+using namespace ns3;
+
+class BeaconStorm
+{
+public:
+  BeaconStorm ();
+  /**
+   * \param nNodes number of PHYs, placed on a square grid
+   * \param spacing distance between the PHYs of the grid (m)
+   * \param nIntervals number of beacon intervals to simulate
+   * \param jitter maximum random delay of the beacons in an interval
+   */
+  void Run (uint32_t nNodes, double spacing, uint32_t nIntervals, Time jitter);
+
+private:
+  void SendBeacon (Ptr<YansWifiPhy> phy);
+  void ScheduleBeacons (Time jitter);
+  void ReceiveOk (Ptr<Packet> p, double snr, WifiTxVector txVector, enum WifiPreamble preamble);
+  void ReceiveError (Ptr<const Packet> p, double snr);
+
+  std::vector<Ptr<YansWifiPhy> > m_phys;
+  Ptr<UniformRandomVariable> m_jitter;
+  uint32_t m_intervalsLeft;
+  uint64_t m_sent;
+  uint64_t m_received;
+  uint64_t m_errors;
+};
+
+BeaconStorm::BeaconStorm ()
+  : m_intervalsLeft (0),
+    m_sent (0),
+    m_received (0),
+    m_errors (0)
+{
+}
+
+void
+BeaconStorm::SendBeacon (Ptr<YansWifiPhy> phy)
+{
+  if (phy->IsStateTx ())
+    {
+      return;
+    }
+  WifiTxVector txVector;
+  txVector.SetMode (WifiMode ("OfdmRate6Mbps"));
+  txVector.SetTxPowerLevel (0);
+  // size of a mesh beacon with a few information elements
+  phy->SendPacket (Create<Packet> (120), txVector, WIFI_PREAMBLE_LONG, 0, 0);
+  m_sent++;
+}
+
+void
+BeaconStorm::ScheduleBeacons (Time jitter)
+{
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      Simulator::Schedule (NanoSeconds (m_jitter->GetInteger (0, jitter.GetNanoSeconds ())),
+                           &BeaconStorm::SendBeacon, this, m_phys[i]);
+    }
+  if (--m_intervalsLeft > 0)
+    {
+      Simulator::Schedule (MicroSeconds (102400), &BeaconStorm::ScheduleBeacons, this, jitter);
+    }
+}
+
+void
+BeaconStorm::ReceiveOk (Ptr<Packet> p, double snr, WifiTxVector txVector, enum WifiPreamble preamble)
+{
+  m_received++;
+}
+
+void
+BeaconStorm::ReceiveError (Ptr<const Packet> p, double snr)
+{
+  m_errors++;
+}
+
+void
+BeaconStorm::Run (uint32_t nNodes, double spacing, uint32_t nIntervals, Time jitter)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  uint32_t side = (uint32_t)std::ceil (std::sqrt ((double)nNodes));
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<MobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+      position->SetPosition (Vector ((i % side) * spacing, (i / side) * spacing, 0.0));
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (position);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->SetReceiveOkCallback (MakeCallback (&BeaconStorm::ReceiveOk, this));
+      phy->SetReceiveErrorCallback (MakeCallback (&BeaconStorm::ReceiveError, this));
+      m_phys.push_back (phy);
+    }
+  m_jitter = CreateObject<UniformRandomVariable> ();
+  m_jitter->SetStream (1);
+  m_intervalsLeft = nIntervals;
+  if (nIntervals == 0)
+    {
+      return;
+    }
+  Simulator::Schedule (Seconds (0.0), &BeaconStorm::ScheduleBeacons, this, jitter);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  uint64_t rxFrames = channel->GetNRxFrames ();
+  Simulator::Destroy ();
+
+  std::cout << "nodes=" << nNodes << " intervals=" << nIntervals
+            << " beacons=" << m_sent << " rx-ok=" << m_received << " rx-error=" << m_errors
+            << " rx-frames=" << rxFrames
+            << " wall-clock(ms)=" << elapsed << std::endl;
+  if (elapsed > 0)
+    {
+      std::cout << "rx-frames/s=" << rxFrames * 1000 / elapsed << std::endl;
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 100;
+  double spacing = 5.0;
+  uint32_t nIntervals = 100;
+  uint32_t jitterUs = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue ("Nodes", "The number of PHYs", nNodes);
+  cmd.AddValue ("Spacing", "The distance between the PHYs of the grid (m)", spacing);
+  cmd.AddValue ("Intervals", "The number of beacon intervals", nIntervals);
+  cmd.AddValue ("Jitter", "The maximum random delay of the beacons in an interval (us)", jitterUs);
+  cmd.Parse (argc, argv);
+
+  BeaconStorm storm;
+  storm.Run (nNodes, spacing, nIntervals, MicroSeconds (jitterUs));
+  return 0;
+}
@@ -92,6 +92,7 @@ AsciiPhyReceiveSinkWithoutContext (
 
 YansWifiChannelHelper::YansWifiChannelHelper ()
 {
+  m_channel.SetTypeId ("ns3::YansWifiChannel");
 }
 
 YansWifiChannelHelper
@@ -151,10 +152,33 @@ YansWifiChannelHelper::SetPropagationDelay (std::string type,
   m_propagationDelay = factory;
 }
 
+void
+YansWifiChannelHelper::SetChannelType (std::string type,
+                                       std::string n0, const AttributeValue &v0,
+                                       std::string n1, const AttributeValue &v1,
+                                       std::string n2, const AttributeValue &v2,
+                                       std::string n3, const AttributeValue &v3,
+                                       std::string n4, const AttributeValue &v4,
+                                       std::string n5, const AttributeValue &v5,
+                                       std::string n6, const AttributeValue &v6,
+                                       std::string n7, const AttributeValue &v7)
+{
+  m_channel = ObjectFactory ();
+  m_channel.SetTypeId (type);
+  m_channel.Set (n0, v0);
+  m_channel.Set (n1, v1);
+  m_channel.Set (n2, v2);
+  m_channel.Set (n3, v3);
+  m_channel.Set (n4, v4);
+  m_channel.Set (n5, v5);
+  m_channel.Set (n6, v6);
+  m_channel.Set (n7, v7);
+}
+
 Ptr<YansWifiChannel>
 YansWifiChannelHelper::Create (void) const
 {
-  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<YansWifiChannel> channel = m_channel.Create<YansWifiChannel> ();
   Ptr<PropagationLossModel> prev = 0;
   for (std::vector<ObjectFactory>::const_iterator i = m_propagationLoss.begin (); i != m_propagationLoss.end (); ++i)
     {
@@ -119,6 +119,38 @@ public:
                             std::string n6 = "", const AttributeValue &v6 = EmptyAttributeValue (),
                             std::string n7 = "", const AttributeValue &v7 = EmptyAttributeValue ());
 
+  /**
+   * \param type the type of the channel to create
+   * \param n0 the name of the attribute to set
+   * \param v0 the value of the attribute to set
+   * \param n1 the name of the attribute to set
+   * \param v1 the value of the attribute to set
+   * \param n2 the name of the attribute to set
+   * \param v2 the value of the attribute to set
+   * \param n3 the name of the attribute to set
+   * \param v3 the value of the attribute to set
+   * \param n4 the name of the attribute to set
+   * \param v4 the value of the attribute to set
+   * \param n5 the name of the attribute to set
+   * \param v5 the value of the attribute to set
+   * \param n6 the name of the attribute to set
+   * \param v6 the value of the attribute to set
+   * \param n7 the name of the attribute to set
+   * \param v7 the value of the attribute to set
+   *
+   * Configure the type of channel to create, e.g. ns3::GridYansWifiChannel.
+   * By default, a ns3::YansWifiChannel is created.
+   */
+  void SetChannelType (std::string type,
+                       std::string n0 = "", const AttributeValue &v0 = EmptyAttributeValue (),
+                       std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (),
+                       std::string n2 = "", const AttributeValue &v2 = EmptyAttributeValue (),
+                       std::string n3 = "", const AttributeValue &v3 = EmptyAttributeValue (),
+                       std::string n4 = "", const AttributeValue &v4 = EmptyAttributeValue (),
+                       std::string n5 = "", const AttributeValue &v5 = EmptyAttributeValue (),
+                       std::string n6 = "", const AttributeValue &v6 = EmptyAttributeValue (),
+                       std::string n7 = "", const AttributeValue &v7 = EmptyAttributeValue ());
+
   /**
    * \returns a new channel
    *
@@ -142,6 +174,7 @@ public:
 
 
 private:
+  ObjectFactory m_channel;
   std::vector<ObjectFactory> m_propagationLoss;
   ObjectFactory m_propagationDelay;
 };
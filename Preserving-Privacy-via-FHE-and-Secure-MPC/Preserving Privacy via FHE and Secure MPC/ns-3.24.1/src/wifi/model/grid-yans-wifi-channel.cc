@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "grid-yans-wifi-channel.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GridYansWifiChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (GridYansWifiChannel);
+
+TypeId
+GridYansWifiChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GridYansWifiChannel")
+    .SetParent<YansWifiChannel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<GridYansWifiChannel> ()
+    .AddAttribute ("RxPowerFloor",
+                   "Frames are not delivered to the PHYs where the receive power would be below this floor (dBm). "
+                   "It should be a few dB below the EnergyDetectionThreshold and CcaMode1Threshold of the PHYs.",
+                   DoubleValue (-110.0),
+                   MakeDoubleAccessor (&GridYansWifiChannel::m_rxPowerFloorDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "Frames are not delivered to the PHYs further than this distance (m). "
+                   "It is also the size of the grid cells used to index the PHYs. 0 means no limit.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&GridYansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+GridYansWifiChannel::GridYansWifiChannel ()
+  : m_gridBuilt (false),
+    m_nSkipped (0)
+{
+}
+
+GridYansWifiChannel::~GridYansWifiChannel ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+void
+GridYansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_mobility.size (); i++)
+    {
+      if (m_mobility[i] != 0)
+        {
+          m_mobility[i]->TraceDisconnectWithoutContext ("CourseChange",
+                                                        MakeCallback (&GridYansWifiChannel::CourseChanged, this));
+        }
+    }
+  m_index.clear ();
+  m_mobility.clear ();
+  m_neighbors.clear ();
+  m_cached.clear ();
+  m_grid.clear ();
+  m_gridBuilt = false;
+  YansWifiChannel::DoDispose ();
+}
+
+void
+GridYansWifiChannel::Add (Ptr<YansWifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  m_index[phy] = m_phyList.size ();
+  YansWifiChannel::Add (phy);
+  m_mobility.push_back (0);
+  Flush ();
+}
+
+void
+GridYansWifiChannel::Flush (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_neighbors.assign (m_phyList.size (), NeighborList ());
+  m_cached.assign (m_phyList.size (), false);
+  m_grid.clear ();
+  m_gridBuilt = false;
+}
+
+void
+GridYansWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  if (m_gridBuilt)
+    {
+      Flush ();
+    }
+}
+
+bool
+GridYansWifiChannel::CompareGain (const Neighbor &a, const Neighbor &b)
+{
+  return a.gainDb > b.gainDb;
+}
+
+GridYansWifiChannel::Cell
+GridYansWifiChannel::GetCell (const Vector &position) const
+{
+  if (m_maxRange == 0)
+    {
+      return Cell (0, 0);
+    }
+  return Cell ((int64_t)std::floor (position.x / m_maxRange),
+               (int64_t)std::floor (position.y / m_maxRange));
+}
+
+void
+GridYansWifiChannel::BuildGrid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      if (m_mobility[i] == 0)
+        {
+          m_mobility[i] = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+          NS_ASSERT (m_mobility[i] != 0);
+          m_mobility[i]->TraceConnectWithoutContext ("CourseChange",
+                                                     MakeCallback (&GridYansWifiChannel::CourseChanged, this));
+        }
+      m_grid[GetCell (m_mobility[i]->GetPosition ())].push_back (i);
+    }
+  m_gridBuilt = true;
+}
+
+void
+GridYansWifiChannel::BuildNeighbors (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  Ptr<MobilityModel> senderMobility = m_mobility[i];
+  Vector position = senderMobility->GetPosition ();
+  Cell cell = GetCell (position);
+  NeighborList &neighbors = m_neighbors[i];
+  int64_t span = (m_maxRange == 0) ? 0 : 1;
+  for (int64_t x = cell.first - span; x <= cell.first + span; x++)
+    {
+      for (int64_t y = cell.second - span; y <= cell.second + span; y++)
+        {
+          Grid::const_iterator c = m_grid.find (Cell (x, y));
+          if (c == m_grid.end ())
+            {
+              continue;
+            }
+          for (std::vector<uint32_t>::const_iterator j = c->second.begin (); j != c->second.end (); j++)
+            {
+              if (*j == i)
+                {
+                  continue;
+                }
+              Ptr<MobilityModel> receiverMobility = m_mobility[*j];
+              if (m_maxRange != 0 && senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+                {
+                  continue;
+                }
+              Neighbor neighbor;
+              neighbor.index = *j;
+              neighbor.gainDb = m_loss->CalcRxPower (0.0, senderMobility, receiverMobility);
+              neighbor.delay = m_delay->GetDelay (senderMobility, receiverMobility);
+              neighbors.push_back (neighbor);
+            }
+        }
+    }
+  std::stable_sort (neighbors.begin (), neighbors.end (), &GridYansWifiChannel::CompareGain);
+  m_cached[i] = true;
+  NS_LOG_DEBUG ("PHY " << i << " has " << neighbors.size () << " receivers in range");
+}
+
+void
+GridYansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+                           WifiTxVector txVector, WifiPreamble preamble, struct mpduInfo aMpdu, Time duration) const
+{
+  std::map<Ptr<YansWifiPhy>, uint32_t>::const_iterator it = m_index.find (sender);
+  NS_ASSERT (it != m_index.end ());
+  uint32_t i = it->second;
+  if (!m_gridBuilt)
+    {
+      BuildGrid ();
+    }
+  if (!m_cached[i])
+    {
+      BuildNeighbors (i);
+    }
+
+  // the receivers share one copy of the frame, detached from the sender's packet
+  Ptr<const Packet> shared = packet->Copy ();
+  uint32_t scheduled = 0;
+  const NeighborList &neighbors = m_neighbors[i];
+  for (NeighborList::const_iterator j = neighbors.begin (); j != neighbors.end (); j++)
+    {
+      double rxPowerDbm = txPowerDbm + j->gainDb;
+      if (rxPowerDbm < m_rxPowerFloorDbm)
+        {
+          //the other receivers are even weaker
+          break;
+        }
+      //For now don't account for inter channel interference
+      if (m_phyList[j->index]->GetChannelNumber () != sender->GetChannelNumber ())
+        {
+          continue;
+        }
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "receiver=" << j->index << ", delay=" << j->delay);
+      ScheduleReceive (j->index, shared, rxPowerDbm, j->delay, txVector, preamble, aMpdu, duration);
+      scheduled++;
+    }
+  m_nSkipped += m_phyList.size () - 1 - scheduled;
+}
+
+uint64_t
+GridYansWifiChannel::GetNSkippedReceptions (void) const
+{
+  return m_nSkipped;
+}
+
+} //namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GRID_YANS_WIFI_CHANNEL_H
+#define GRID_YANS_WIFI_CHANNEL_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "yans-wifi-channel.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \brief A Yans wifi channel which only delivers frames to the PHYs in range
+ * \ingroup wifi
+ *
+ * YansWifiChannel computes the propagation loss and delay and schedules a
+ * reception event for every PHY of the channel, for every frame. This
+ * channel is meant for topologies in which the PHYs do not move, e.g. grids
+ * of nodes with a ConstantPositionMobilityModel.
+ *
+ * The first time a PHY transmits, the channel computes the loss and the
+ * delay towards the other PHYs once and caches them, sorted by decreasing
+ * receive power. When MaxRange is set, the PHYs are indexed in a uniform
+ * grid of MaxRange-sized cells and only the PHYs of the neighbouring cells
+ * are considered. A frame is then only scheduled at the receivers whose
+ * receive power is above RxPowerFloor. The floor should be set a few dB
+ * below the EnergyDetectionThreshold and CcaMode1Threshold of the PHYs, so
+ * that the skipped signals are also negligible as interference.
+ *
+ * The cache is flushed when a PHY is added to the channel or when one of
+ * the mobility models reports a course change. Because the loss and the
+ * delay are only computed once per pair of PHYs, the propagation loss and
+ * delay models must be deterministic, and the loss must not depend on the
+ * transmission power.
+ */
+class GridYansWifiChannel : public YansWifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  GridYansWifiChannel ();
+  virtual ~GridYansWifiChannel ();
+
+  // inherited from YansWifiChannel
+  virtual void Add (Ptr<YansWifiPhy> phy);
+  virtual void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+                     WifiTxVector txVector, WifiPreamble preamble, struct mpduInfo aMpdu, Time duration) const;
+
+  /**
+   * \return the number of receptions which were not scheduled because the
+   *         receive power was below the floor or the receiver out of range
+   */
+  uint64_t GetNSkippedReceptions (void) const;
+
+  /**
+   * Flush the cached losses and delays, e.g. after changing the propagation
+   * models of the channel.
+   */
+  void Flush (void) const;
+
+
+protected:
+  /**
+   * Disconnect from the course change traces of the PHYs and release them.
+   */
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * A receiver of the transmissions of a PHY
+   */
+  struct Neighbor
+  {
+    uint32_t index; //!< index of the receiver in the PHY list
+    double gainDb;  //!< receive power minus transmission power (dB)
+    Time delay;     //!< propagation delay
+  };
+  /// receivers of a PHY, sorted by decreasing gain
+  typedef std::vector<Neighbor> NeighborList;
+  /// uniform grid cell coordinates
+  typedef std::pair<int64_t, int64_t> Cell;
+  /// PHY indices of the grid cells
+  typedef std::map<Cell, std::vector<uint32_t> > Grid;
+
+  /**
+   * Compare two neighbors by decreasing gain.
+   *
+   * \param a the first neighbor
+   * \param b the second neighbor
+   * \return true if a has a higher gain than b
+   */
+  static bool CompareGain (const Neighbor &a, const Neighbor &b);
+  /**
+   * \param position a position
+   * \return the grid cell of the position
+   */
+  Cell GetCell (const Vector &position) const;
+  /**
+   * Index the PHYs in the grid and connect to their course change traces.
+   */
+  void BuildGrid (void) const;
+  /**
+   * Compute the receivers of the given PHY.
+   *
+   * \param i index of the transmitting PHY in the PHY list
+   */
+  void BuildNeighbors (uint32_t i) const;
+  /**
+   * Invoked when one of the PHYs moves.
+   *
+   * \param mobility the mobility model of the PHY
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+
+  double m_rxPowerFloorDbm;                       //!< Receive power below which frames are not delivered
+  double m_maxRange;                              //!< Grid cell size and maximum range (0 to disable)
+  std::map<Ptr<YansWifiPhy>, uint32_t> m_index;   //!< Index of the PHYs in the PHY list
+  mutable std::vector<Ptr<MobilityModel> > m_mobility; //!< Mobility models of the PHYs
+  mutable std::vector<NeighborList> m_neighbors;  //!< Cached receivers of the PHYs
+  mutable std::vector<bool> m_cached;             //!< Whether the receivers of a PHY are cached
+  mutable Grid m_grid;                            //!< PHYs indexed by grid cell
+  mutable bool m_gridBuilt;                       //!< Whether m_grid is up to date
+  mutable uint64_t m_nSkipped;                    //!< Number of receptions not scheduled
+};
+
+} //namespace ns3
+
+#endif /* GRID_YANS_WIFI_CHANNEL_H */
@@ -65,6 +65,21 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_phyList.clear ();
+  if (m_loss != 0)
+    {
+      m_loss->Dispose ();
+      m_loss = 0;
+    }
+  m_delay = 0;
+  m_rxMobility.clear ();
+  WifiChannel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
@@ -83,6 +98,8 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
+  m_rxIndex.clear ();
+  m_rxMobility.clear ();
   uint32_t j = 0;
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
     {
@@ -93,40 +110,54 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
             {
               continue;
             }
+          m_rxIndex.push_back (j);
+          m_rxMobility.push_back ((*i)->GetMobility ()->GetObject<MobilityModel> ());
+        }
+    }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
-            {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-            }
-
-          struct Parameters parameters;
-          parameters.rxPowerDbm = rxPowerDbm;
-          parameters.aMpdu = aMpdu;
-          parameters.duration = duration;
-          parameters.txVector = txVector;
-          parameters.preamble = preamble;
+  // the receivers share one copy of the frame, detached from the sender's
+  // packet which its MAC may still tag for a retransmission
+  Ptr<const Packet> shared = packet->Copy ();
+  // evaluate the propagation models once for all the receivers
+  m_delay->GetDelays (senderMobility, m_rxMobility, m_rxDelay);
+  m_loss->CalcRxPowers (txPowerDbm, senderMobility, m_rxMobility, m_rxPowerDbm);
+  for (uint32_t k = 0; k < m_rxIndex.size (); k++)
+    {
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << m_rxPowerDbm[k] << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (m_rxMobility[k]) << "m, delay=" << m_rxDelay[k]);
+      ScheduleReceive (m_rxIndex[k], shared, m_rxPowerDbm[k], m_rxDelay[k], txVector, preamble, aMpdu, duration);
+    }
+}
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, parameters);
-        }
+void
+YansWifiChannel::ScheduleReceive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm, Time delay,
+                                  WifiTxVector txVector, WifiPreamble preamble, struct mpduInfo aMpdu, Time duration) const
+{
+  Ptr<Object> dstNetDevice = m_phyList[i]->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
     }
+
+  struct Parameters parameters;
+  parameters.rxPowerDbm = rxPowerDbm;
+  parameters.aMpdu = aMpdu;
+  parameters.duration = duration;
+  parameters.txVector = txVector;
+  parameters.preamble = preamble;
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive, this,
+                                  i, packet, parameters);
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, struct Parameters parameters) const
 {
   m_phyList[i]->StartReceivePreambleAndHeader (packet, parameters.rxPowerDbm, parameters.txVector, parameters.preamble, parameters.aMpdu, parameters.duration);
 }
@@ -149,6 +180,28 @@ YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
   m_phyList.push_back (phy);
 }
 
+uint64_t
+YansWifiChannel::GetNRxFrames (void) const
+{
+  uint64_t frames = 0;
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+    {
+      frames += (*i)->GetNRxFrames ();
+    }
+  return frames;
+}
+
+uint64_t
+YansWifiChannel::GetNRxCopies (void) const
+{
+  uint64_t copies = 0;
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+    {
+      copies += (*i)->GetNRxCopies ();
+    }
+  return copies;
+}
+
 int64_t
 YansWifiChannel::AssignStreams (int64_t stream)
 {
@@ -36,6 +36,7 @@ namespace ns3 {
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class MobilityModel;
 
 struct Parameters
 {
@@ -75,10 +76,11 @@ public:
    *
    * \param phy the YansWifiPhy to be added to the PHY list
    */
-  void Add (Ptr<YansWifiPhy> phy);
+  virtual void Add (Ptr<YansWifiPhy> phy);
 
   /**
-   * \param loss the new propagation loss model.
+   * \param loss the new propagation loss model, disposed with the channel:
+   *        it should not be shared with another channel.
    */
   void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
   /**
@@ -101,8 +103,8 @@ public:
    * delivers packets only between PHYs with the same m_channelNumber,
    * e.g. PHYs that are operating on the same channel.
    */
-  void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
-             WifiTxVector txVector, WifiPreamble preamble, struct mpduInfo aMpdu, Time duration) const;
+  virtual void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+                     WifiTxVector txVector, WifiPreamble preamble, struct mpduInfo aMpdu, Time duration) const;
 
   /**
    * Assign a fixed random variable stream number to the random variables
@@ -115,29 +117,69 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \return the total number of frames delivered to the PHYs of this channel
+   */
+  uint64_t GetNRxFrames (void) const;
+  /**
+   * Frames are delivered by reference: all the receivers of a transmission
+   * share one read-only copy of the sender's packet, and a PHY only copies
+   * it again when it decodes the frame. The PhyRxBegin and PhyRxDrop trace
+   * sinks see the shared frame and must not add tags to it.
+   *
+   * \return the total number of packet copies made by the PHYs of this channel
+   */
+  uint64_t GetNRxCopies (void) const;
+
+
+protected:
+  /**
+   * Release the PHYs and dispose the propagation loss model, which may
+   * hold the mobility models of the PHYs and be connected to their traces.
+   */
+  virtual void DoDispose (void);
 
-private:
   /**
    * A vector of pointers to YansWifiPhy.
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
 
+  /**
+   * Schedule the arrival of the first bit of a packet at a YansWifiPhy.
+   *
+   * \param i index of the receiving YansWifiPhy in the PHY list
+   * \param packet the packet being sent, shared by all the receivers
+   * \param rxPowerDbm the receive power in dBm
+   * \param delay the propagation delay
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the type of preamble being used to send the packet
+   * \param aMpdu the type of the packet and the A-MPDU reference number
+   * \param duration the transmission duration associated to the packet
+   */
+  void ScheduleReceive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm, Time delay,
+                        WifiTxVector txVector, WifiPreamble preamble, struct mpduInfo aMpdu, Time duration) const;
+
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
+   * \param packet the packet being sent, shared by all the receivers
    * \param atts a vector containing the received power in dBm and the packet type
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
+  void Receive (uint32_t i, Ptr<const Packet> packet, struct Parameters parameters) const;
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+
+  mutable std::vector<uint32_t> m_rxIndex;                //!< Send scratch: PHY list index of the receivers
+  mutable std::vector<Ptr<MobilityModel> > m_rxMobility;  //!< Send scratch: mobility models of the receivers
+  mutable std::vector<double> m_rxPowerDbm;               //!< Send scratch: receive powers
+  mutable std::vector<Time> m_rxDelay;                    //!< Send scratch: propagation delays
 };
 
 } //namespace ns3
@@ -184,7 +184,9 @@ YansWifiPhy::YansWifiPhy ()
     m_endPlcpRxEvent (),
     m_channelStartingFrequency (0),
     m_mpdusNum (0),
-    m_plcpSuccess (false)
+    m_plcpSuccess (false),
+    m_nRxFrames (0),
+    m_nRxCopies (0)
 {
   NS_LOG_FUNCTION (this);
   m_random = CreateObject<UniformRandomVariable> ();
@@ -562,7 +564,7 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
 }
 
 void
-YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                             double rxPowerDbm,
                                             WifiTxVector txVector,
                                             enum WifiPreamble preamble,
@@ -576,6 +578,7 @@ YansWifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet,
   double rxPowerW = DbmToW (rxPowerDbm);
   Time endRx = Simulator::Now () + rxDuration;
   Time preambleAndHeaderDuration = CalculatePlcpPreambleAndHeaderDuration (txVector, preamble);
+  m_nRxFrames++;
 
   Ptr<InterferenceHelper::Event> event;
   event = m_interference.Add (packet->GetSize (),
@@ -717,7 +720,7 @@ maybeCcaBusy:
 }
 
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble,
                                  struct mpduInfo aMpdu,
@@ -1135,7 +1138,7 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, struct mpduInfo aMpdu, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, struct mpduInfo aMpdu, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -1152,7 +1155,12 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, struct
 
       if (m_random->GetValue () > snrPer.per)
         {
-          NotifyRxEnd (packet);
+          //the packet is shared with the other receivers of this
+          //transmission: this receiver gets its own copy before the traces
+          //and the MAC can add their tags or strip headers
+          Ptr<Packet> copy = packet->Copy ();
+          m_nRxCopies++;
+          NotifyRxEnd (copy);
           uint32_t dataRate500KbpsUnits;
           if ((event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_HT) || (event->GetPayloadMode ().GetModulationClass () == WIFI_MOD_CLASS_VHT))
             {
@@ -1165,8 +1173,8 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, struct
           struct signalNoiseDbm signalNoise;
           signalNoise.signal = RatioToDb (event->GetRxPowerW ()) + 30;
           signalNoise.noise = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
-          NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, event->GetPreambleType (), event->GetTxVector (), aMpdu, signalNoise);
-          m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
+          NotifyMonitorSniffRx (copy, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, event->GetPreambleType (), event->GetTxVector (), aMpdu, signalNoise);
+          m_state->SwitchFromRxEndOk (copy, snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
         }
       else
         {
@@ -1194,6 +1202,18 @@ YansWifiPhy::AssignStreams (int64_t stream)
   return 1;
 }
 
+uint64_t
+YansWifiPhy::GetNRxFrames (void) const
+{
+  return m_nRxFrames;
+}
+
+uint64_t
+YansWifiPhy::GetNRxCopies (void) const
+{
+  return m_nRxCopies;
+}
+
 void
 YansWifiPhy::SetFrequency (uint32_t freq)
 {
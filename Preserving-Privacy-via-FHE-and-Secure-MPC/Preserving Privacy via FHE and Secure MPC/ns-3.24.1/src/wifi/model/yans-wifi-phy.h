@@ -103,7 +103,7 @@ public:
   /**
    * Starting receiving the plcp of a packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param packet the arriving packet, shared with all the other receivers of the transmission
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
@@ -111,7 +111,7 @@ public:
    *        and the A-MPDU reference number (must be a different value for each A-MPDU but the same for each subframe within one A-MPDU)
    * \param rxDuration the duration needed for the reception of the packet
    */
-  void StartReceivePreambleAndHeader (Ptr<Packet> packet,
+  void StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                       double rxPowerDbm,
                                       WifiTxVector txVector,
                                       WifiPreamble preamble,
@@ -127,7 +127,7 @@ public:
    *        and the A-MPDU reference number (must be a different value for each A-MPDU but the same for each subframe within one A-MPDU)
    * \param event the corresponding event of the first time the packet arrives
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            WifiTxVector txVector,
                            WifiPreamble preamble,
                            struct mpduInfo aMpdu,
@@ -315,6 +315,20 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \return the number of frames delivered to this PHY by the channel
+   */
+  uint64_t GetNRxFrames (void) const;
+  /**
+   * The channel delivers a single read-only packet to all the receivers of
+   * a transmission. A private copy is only made when a frame is decoded:
+   * the PhyRxEnd and MonitorSnifferRx trace sinks and the MAC get this copy
+   * and are allowed to tag or modify it.
+   *
+   * \return the number of packet copies made by this PHY on reception
+   */
+  uint64_t GetNRxCopies (void) const;
+
   /**
    * \param freq the operating frequency on this node (2.4 GHz or 5GHz).
    */
@@ -505,7 +519,7 @@ private:
    *        and the A-MPDU reference number (must be a different value for each A-MPDU but the same for each subframe within one A-MPDU)
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, struct mpduInfo aMpdu, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, struct mpduInfo aMpdu, Ptr<InterferenceHelper::Event> event);
 
   bool     m_initialized;         //!< Flag for runtime initialization
   double   m_edThresholdW;        //!< Energy detection threshold in watts
@@ -580,6 +594,8 @@ private:
   Time m_channelSwitchDelay;            //!< Time required to switch between channel
   uint16_t m_mpdusNum;                  //!< carries the number of expected mpdus that are part of an A-MPDU
   bool m_plcpSuccess;                   //!< Flag if the PLCP of the packet or the first MPDU in an A-MPDU has been received
+  uint64_t m_nRxFrames;                 //!< Number of frames delivered by the channel
+  uint64_t m_nRxCopies;                 //!< Number of packet copies made on reception
 };
 
 } //namespace ns3
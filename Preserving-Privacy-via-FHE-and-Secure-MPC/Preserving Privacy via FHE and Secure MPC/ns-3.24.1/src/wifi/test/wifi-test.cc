@@ -23,6 +23,7 @@
 
 #include "ns3/nqos-wifi-mac-helper.h"
 #include "ns3/yans-wifi-helper.h"
+#include "ns3/grid-yans-wifi-channel.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/packet-sink-helper.h"
@@ -39,7 +40,9 @@
 #include "ns3/rng-seed-manager.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/string.h"
+#include "ns3/flow-id-tag.h"
 
 using namespace ns3;
 
@@ -76,6 +79,39 @@ AssignWifiRandomStreams (Ptr<WifiMac> mac, int64_t stream)
 }
 
 
+//Helper function to create an 802.11a adhoc device at the given position
+static Ptr<WifiNetDevice>
+CreateAdhocDevice (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  ObjectFactory mac;
+  mac.SetTypeId ("ns3::AdhocWifiMac");
+  ObjectFactory manager;
+  manager.SetTypeId ("ns3::ConstantRateWifiManager");
+
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+  Ptr<WifiMac> wifiMac = mac.Create<WifiMac> ();
+  wifiMac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  wifiMac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (wifiMac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager.Create<WifiRemoteStationManager> ());
+  node->AddDevice (dev);
+  return dev;
+}
+
+
 class WifiTest : public TestCase
 {
 public:
@@ -622,6 +658,272 @@ Bug730TestCase::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the channel delivers a transmission by reference to all
+ * the receivers, and that a packet copy is only made by the PHYs which
+ * actually hand the frame up to their MAC.
+ *
+ * One node broadcasts a single frame: a node nearby decodes it, a node far
+ * away gets it below the energy detection threshold and drops it.
+ */
+
+class SharedRxFrameTestCase : public TestCase
+{
+public:
+  SharedRxFrameTestCase ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+};
+
+SharedRxFrameTestCase::SharedRxFrameTestCase ()
+  : TestCase ("Test case for frame delivery by reference")
+{
+}
+
+void
+SharedRxFrameTestCase::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+SharedRxFrameTestCase::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  Ptr<WifiNetDevice> txDev = CreateAdhocDevice (Vector (0.0, 0.0, 0.0), channel);
+  CreateAdhocDevice (Vector (5.0, 0.0, 0.0), channel);
+  CreateAdhocDevice (Vector (100000.0, 0.0, 0.0), channel);
+
+  Simulator::Schedule (Seconds (1.0), &SharedRxFrameTestCase::SendOnePacket, this, txDev);
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNRxFrames (), 2, "the frame should have been delivered to both receivers");
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNRxCopies (), 1, "only the receiver which decoded the frame should copy it");
+
+  Simulator::Destroy ();
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the tags added by a receiver on the frame it decoded, or
+ * by the sender on the packet it sent, are not seen by the other receivers
+ * of the shared frame.
+ */
+
+class SharedRxFrameTagTestCase : public TestCase
+{
+public:
+  SharedRxFrameTagTestCase ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  void TagSent (Ptr<const Packet> p);
+  void TagReceived (Ptr<const Packet> p);
+
+  uint32_t m_received; //!< number of frames decoded
+  uint32_t m_leaks;    //!< number of frames decoded with a tag on them
+};
+
+SharedRxFrameTagTestCase::SharedRxFrameTagTestCase ()
+  : TestCase ("Test case for the tags on frames delivered by reference"),
+    m_received (0),
+    m_leaks (0)
+{
+}
+
+void
+SharedRxFrameTagTestCase::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+SharedRxFrameTagTestCase::TagSent (Ptr<const Packet> p)
+{
+  p->AddPacketTag (FlowIdTag (1));
+}
+
+void
+SharedRxFrameTagTestCase::TagReceived (Ptr<const Packet> p)
+{
+  FlowIdTag tag;
+  m_received++;
+  if (p->PeekPacketTag (tag))
+    {
+      m_leaks++;
+    }
+  p->AddPacketTag (FlowIdTag (2));
+}
+
+void
+SharedRxFrameTagTestCase::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  Ptr<WifiNetDevice> txDev = CreateAdhocDevice (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<WifiNetDevice> rxDev1 = CreateAdhocDevice (Vector (5.0, 0.0, 0.0), channel);
+  Ptr<WifiNetDevice> rxDev2 = CreateAdhocDevice (Vector (0.0, 10.0, 0.0), channel);
+
+  //the sender tags its packet once the channel has it, each receiver the
+  //frame it decoded
+  txDev->GetPhy ()->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&SharedRxFrameTagTestCase::TagSent, this));
+  rxDev1->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&SharedRxFrameTagTestCase::TagReceived, this));
+  rxDev2->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&SharedRxFrameTagTestCase::TagReceived, this));
+
+  Simulator::Schedule (Seconds (1.0), &SharedRxFrameTagTestCase::SendOnePacket, this, txDev);
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 2, "the frame should have been decoded by both receivers");
+  NS_TEST_ASSERT_MSG_EQ (m_leaks, 0, "a receiver should not see the tags of the sender or of the other receiver");
+
+  Simulator::Destroy ();
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that GridYansWifiChannel delivers frames to the receivers in
+ * range, and does not schedule the receptions below its power floor or
+ * beyond its maximum range.
+ */
+
+class GridYansWifiChannelTestCase : public TestCase
+{
+public:
+  GridYansWifiChannelTestCase ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+};
+
+GridYansWifiChannelTestCase::GridYansWifiChannelTestCase ()
+  : TestCase ("Test case for GridYansWifiChannel")
+{
+}
+
+void
+GridYansWifiChannelTestCase::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+GridYansWifiChannelTestCase::DoRun (void)
+{
+  Ptr<GridYansWifiChannel> channel = CreateObject<GridYansWifiChannel> ();
+  channel->SetAttribute ("RxPowerFloor", DoubleValue (-110.0));
+  channel->SetAttribute ("MaxRange", DoubleValue (1000.0));
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  //in range, below the floor (-130 dBm) and beyond the maximum range
+  Ptr<WifiNetDevice> txDev = CreateAdhocDevice (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<WifiNetDevice> nearDev = CreateAdhocDevice (Vector (5.0, 0.0, 0.0), channel);
+  Ptr<WifiNetDevice> weakDev = CreateAdhocDevice (Vector (0.0, 900.0, 0.0), channel);
+  Ptr<WifiNetDevice> farDev = CreateAdhocDevice (Vector (2000.0, 0.0, 0.0), channel);
+
+  Simulator::Schedule (Seconds (1.0), &GridYansWifiChannelTestCase::SendOnePacket, this, txDev);
+  Simulator::Schedule (Seconds (1.5), &GridYansWifiChannelTestCase::SendOnePacket, this, txDev);
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<YansWifiPhy> (nearDev->GetPhy ())->GetNRxFrames (), 2, "the receiver in range should get both frames");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<YansWifiPhy> (weakDev->GetPhy ())->GetNRxFrames (), 0, "the receiver below the floor should get no frame");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<YansWifiPhy> (farDev->GetPhy ())->GetNRxFrames (), 0, "the receiver out of range should get no frame");
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNSkippedReceptions (), 4, "two receptions should have been skipped per frame");
+
+  Simulator::Destroy ();
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a CachedPropagationLossModel is released from the mobility
+ * models of the nodes when its channel is disposed, so that a node moving
+ * after the channel is gone does not call into the freed model.
+ */
+
+class CachedLossChannelDisposeTestCase : public TestCase
+{
+public:
+  CachedLossChannelDisposeTestCase ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+};
+
+CachedLossChannelDisposeTestCase::CachedLossChannelDisposeTestCase ()
+  : TestCase ("Test case for the dispose of a cached loss model with its channel")
+{
+}
+
+void
+CachedLossChannelDisposeTestCase::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+CachedLossChannelDisposeTestCase::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<CachedPropagationLossModel> loss = CreateObject<CachedPropagationLossModel> ();
+  loss->SetModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (loss);
+
+  Ptr<WifiNetDevice> txDev = CreateAdhocDevice (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<WifiNetDevice> rxDev = CreateAdhocDevice (Vector (5.0, 0.0, 0.0), channel);
+  Ptr<MobilityModel> rxMobility = rxDev->GetNode ()->GetObject<MobilityModel> ();
+  uint32_t references = rxMobility->GetReferenceCount ();
+
+  Simulator::Schedule (Seconds (1.0), &CachedLossChannelDisposeTestCase::SendOnePacket, this, txDev);
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (loss->GetNMisses (), 1, "the loss to the receiver should have been cached");
+  NS_TEST_ASSERT_MSG_GT (rxMobility->GetReferenceCount (), references, "the cache should hold the mobility model");
+
+  //the channel is destroyed first, then the receiver moves
+  channel->Dispose ();
+  channel = 0;
+  NS_TEST_ASSERT_MSG_EQ (loss->GetModel (), 0, "the loss model should be disposed with its channel");
+  NS_TEST_ASSERT_MSG_EQ (rxMobility->GetReferenceCount (), references, "the cache should release the mobility model");
+  loss = 0;
+  rxMobility->SetPosition (Vector (10.0, 0.0, 0.0));
+
+  Simulator::Destroy ();
+}
+
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -637,6 +939,10 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
+  AddTestCase (new SharedRxFrameTestCase, TestCase::QUICK);
+  AddTestCase (new SharedRxFrameTagTestCase, TestCase::QUICK);
+  AddTestCase (new GridYansWifiChannelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedLossChannelDisposeTestCase, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;